@@ -72,6 +72,22 @@ typedef struct lwgsm_netconn {
 #endif
 } lwgsm_netconn_t;
 
+#if LWGSM_CFG_STATIC_ALLOC
+LWGSM_MEM_POOL_DEFINE(lwgsmi_netconn_pool, LWGSM_MEM_POOL_NETCONN, sizeof(lwgsm_netconn_t),
+                      LWGSM_CFG_STATIC_NETCONN_NUM);
+LWGSM_MEM_POOL_DEFINE(lwgsmi_netconn_buff_pool, LWGSM_MEM_POOL_NETCONN_BUFF, LWGSM_CFG_CONN_MAX_DATA_LEN,
+                      LWGSM_CFG_STATIC_NETCONN_NUM);
+#define NETCONN_ALLOC()        lwgsmi_mem_pool_alloc(&lwgsmi_netconn_pool)
+#define NETCONN_FREE_S(nc)     lwgsmi_mem_pool_free_s(&lwgsmi_netconn_pool, (void**)&(nc))
+#define NETCONN_BUFF_ALLOC()   lwgsmi_mem_pool_alloc(&lwgsmi_netconn_buff_pool)
+#define NETCONN_BUFF_FREE_S(b) lwgsmi_mem_pool_free_s(&lwgsmi_netconn_buff_pool, (void**)&(b))
+#else /* LWGSM_CFG_STATIC_ALLOC */
+#define NETCONN_ALLOC()        lwgsm_mem_calloc_tag(LWGSM_MEM_TAG_NETCONN, 1, sizeof(lwgsm_netconn_t))
+#define NETCONN_FREE_S(nc)     lwgsm_mem_free_tag_s((void**)&(nc))
+#define NETCONN_BUFF_ALLOC()   lwgsm_mem_malloc_tag(LWGSM_MEM_TAG_NETCONN, sizeof(uint8_t) * LWGSM_CFG_CONN_MAX_DATA_LEN)
+#define NETCONN_BUFF_FREE_S(b) lwgsm_mem_free_tag_s((void**)&(b))
+#endif /* !LWGSM_CFG_STATIC_ALLOC */
+
 static uint8_t recv_closed = 0xFF;
 static lwgsm_netconn_t* netconn_list; /*!< Linked list of netconn entries */
 
@@ -220,7 +236,7 @@ lwgsm_netconn_new(lwgsm_netconn_type_t type) {
         lwgsm_evt_register(lwgsm_evt); /* Register global event function */
     }
     lwgsm_core_unlock();
-    a = lwgsm_mem_calloc(1, sizeof(*a)); /* Allocate memory for core object */
+    a = NETCONN_ALLOC(); /* Allocate memory for core object */
     if (a != NULL) {
         a->type = type;      /* Save netconn type */
         a->conn_timeout = 0; /* Default connection timeout */
@@ -247,7 +263,7 @@ free_ret:
         lwgsm_sys_mbox_invalid(&a->mbox_receive);
     }
     if (a != NULL) {
-        lwgsm_mem_free_s((void**)&a);
+        NETCONN_FREE_S(a);
     }
     return NULL;
 }
@@ -279,7 +295,7 @@ lwgsm_netconn_delete(lwgsm_netconn_p nc) {
     }
     lwgsm_core_unlock();
 
-    lwgsm_mem_free_s((void**)&nc);
+    NETCONN_FREE_S(nc);
     return lwgsmOK;
 }
 
@@ -351,7 +367,7 @@ lwgsm_netconn_write(lwgsm_netconn_p nc, const void* data, size_t btw) {
         if (nc->buff.ptr == nc->buff.len) {
             res = lwgsm_conn_send(nc->conn, nc->buff.buff, nc->buff.len, &sent, 1);
 
-            lwgsm_mem_free_s((void**)&nc->buff.buff);
+            NETCONN_BUFF_FREE_S(nc->buff.buff);
             if (res != lwgsmOK) {
                 return res;
             }
@@ -378,7 +394,7 @@ lwgsm_netconn_write(lwgsm_netconn_p nc, const void* data, size_t btw) {
 
     /* Step 3 */
     if (nc->buff.buff == NULL) { /* Check if we should allocate a new buffer */
-        nc->buff.buff = lwgsm_mem_malloc(sizeof(*nc->buff.buff) * LWGSM_CFG_CONN_MAX_DATA_LEN);
+        nc->buff.buff = NETCONN_BUFF_ALLOC();
         nc->buff.len = LWGSM_CFG_CONN_MAX_DATA_LEN; /* Save buffer length */
         nc->buff.ptr = 0;                           /* Save buffer pointer */
     }
@@ -413,7 +429,7 @@ lwgsm_netconn_flush(lwgsm_netconn_p nc) {
         if (nc->buff.ptr > 0) {                                              /* Do we have data in current buffer? */
             lwgsm_conn_send(nc->conn, nc->buff.buff, nc->buff.ptr, NULL, 1); /* Send data */
         }
-        lwgsm_mem_free_s((void**)&nc->buff.buff);
+        NETCONN_BUFF_FREE_S(nc->buff.buff);
     }
     return lwgsmOK;
 }
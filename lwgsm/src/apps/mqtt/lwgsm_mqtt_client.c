@@ -32,7 +32,32 @@
  * Version:         v0.1.1
  */
 #include "lwgsm/apps/lwgsm_mqtt_client.h"
+#include "lwgsm/apps/lwgsm_mqtt_client_queue.h"
+#include "lwgsm/apps/lwgsm_mqtt_client_router.h"
 #include "lwgsm/lwgsm.h"
+#include "lwgsm/lwgsm_private.h"
+
+#if LWGSM_CFG_MQTT_V5 || __DOXYGEN__
+
+/**
+ * \brief           Topic alias entry
+ */
+typedef struct {
+    uint8_t topic_len;                             /*!< Length of topic, `0` when alias is not used */
+    uint8_t hits;                                  /*!< Usage score, decreased when other topics miss alias */
+    char topic[LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_LEN]; /*!< Topic bound to alias on server */
+} mqtt_topic_alias_t;
+
+#endif /* LWGSM_CFG_MQTT_V5 || __DOXYGEN__ */
+
+/**
+ * \brief           Response packet waiting for space in TX buffer
+ */
+typedef struct {
+    uint8_t msg_type; /*!< Response message type */
+    uint8_t qos;      /*!< Quality of service written to fixed header */
+    uint16_t pkt_id;  /*!< Packet ID of response */
+} mqtt_resp_t;
 
 /**
  * \brief           MQTT client connection
@@ -49,16 +74,40 @@ typedef struct lwgsm_mqtt_client {
 
     lwgsm_buff_t tx_buff; /*!< Buffer for raw output data to transmit */
 
-    uint8_t is_sending;     /*!< Flag if we are sending data currently */
-    uint32_t sent_total;    /*!< Total number of bytes sent so far on connection */
-    uint32_t written_total; /*!< Total number of bytes written into send buffer and queued for send */
+    uint8_t sends_in_flight; /*!< Number of TX buffer segments submitted to connection and not yet confirmed */
+    uint32_t sent_total;     /*!< Total number of bytes sent so far on connection */
+    uint32_t written_total;  /*!< Total number of bytes written into send buffer and queued for send */
 
     uint16_t last_packet_id; /*!< Packet ID used on last packet */
 
-    lwgsm_mqtt_request_t requests[LWGSM_CFG_MQTT_MAX_REQUESTS]; /*!< List of requests */
-
-    uint8_t* rx_buff;   /*!< Raw RX buffer */
-    size_t rx_buff_len; /*!< Length of raw RX buffer */
+    lwgsm_mqtt_request_t* requests; /*!< Request objects */
+    uint16_t* requests_free;        /*!< Stack of free request object indexes */
+    uint16_t* requests_fifo;        /*!< Ring of requests without packet ID, in order of sending */
+    uint16_t* requests_idx;         /*!< Open addressing index of requests with packet ID, keyed by packet ID.
+                                         Entry is request object index plus `1`, `0` marks empty slot */
+    uint16_t requests_size;         /*!< Number of request objects */
+    uint16_t requests_idx_mask;     /*!< Index table size minus `1`, size is power of `2` */
+    uint16_t requests_free_cnt;     /*!< Number of entries in free stack */
+    uint16_t requests_fifo_r;       /*!< Read position in requests ring */
+    uint16_t requests_fifo_cnt;     /*!< Number of entries in requests ring */
+    uint16_t requests_max_used;     /*!< Maximal number of requests in use at the same time */
+    uint32_t requests_failed;       /*!< Number of requests refused due to full table */
+#if LWGSM_CFG_MQTT_RETRANSMIT
+    uint32_t requests_send_seq;     /*!< Sequence number for next request sent to server */
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT */
+
+    uint8_t* rx_buff;     /*!< Raw RX buffer */
+    size_t rx_buff_len;   /*!< Length of raw RX buffer */
+    lwgsm_pbuf_p rx_pbuf; /*!< Received packet buffer of message processed in place, `NULL` otherwise */
+
+    lwgsm_mqtt_client_payload_fn stream_fn; /*!< Payload callback of active streaming publish, `NULL` when idle */
+    void* stream_arg;                       /*!< User argument for payload callback */
+    uint32_t stream_len;                    /*!< Payload length of streaming publish */
+    uint32_t stream_offset;                 /*!< Number of payload bytes already written to TX buffer */
+
+    mqtt_resp_t resp_pending[LWGSM_CFG_MQTT_PENDING_RESP_NUM]; /*!< Ring of responses not yet written to TX buffer */
+    uint8_t resp_pending_r;                                    /*!< Read position in pending responses ring */
+    uint8_t resp_pending_cnt;                                  /*!< Number of pending responses */
 
     uint8_t parser_state;     /*!< Incoming data parser state */
     uint8_t msg_hdr_byte;     /*!< Incoming message header byte */
@@ -66,9 +115,58 @@ typedef struct lwgsm_mqtt_client {
     uint8_t msg_rem_len_mult; /*!< Multiplier for remaining length */
     uint32_t msg_curr_pos;    /*!< Current buffer write pointer */
 
+#if LWGSM_CFG_MQTT_QUEUE || __DOXYGEN__
+    lwgsm_mqtt_queue_t* queue; /*!< Store-and-forward queue for published messages */
+#endif /* LWGSM_CFG_MQTT_QUEUE || __DOXYGEN__ */
+#if LWGSM_CFG_MQTT_ROUTER || __DOXYGEN__
+    lwgsmi_mqtt_router_t router; /*!< Topic filter router for received messages */
+#endif /* LWGSM_CFG_MQTT_ROUTER || __DOXYGEN__ */
+
+    uint16_t keep_alive; /*!< Keep-alive interval of current connection in units of seconds */
+#if LWGSM_CFG_MQTT_V5 || __DOXYGEN__
+    uint8_t version;          /*!< Protocol version of current connection */
+    uint8_t max_qos;          /*!< Maximal quality of service accepted by server */
+    uint8_t retain_available; /*!< Set to `1` when server accepts retained messages */
+    uint16_t recv_max;        /*!< Receive maximum of server, limit of publish packets waiting for acknowledge */
+    uint16_t pub_in_flight;   /*!< Number of publish packets with QoS > 0 waiting for acknowledge */
+    uint32_t max_packet_size; /*!< Maximal packet size accepted by server, `0` when not limited */
+    uint16_t topic_alias_max; /*!< Number of topic aliases usable on current connection */
+    mqtt_topic_alias_t topic_aliases[LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_NUM]; /*!< Topic aliases, index plus `1` is alias */
+#endif /* LWGSM_CFG_MQTT_V5 || __DOXYGEN__ */
+
     void* arg; /*!< User argument */
 } lwgsm_mqtt_client_t;
 
+/* Memory for requests: objects, free stack and ring of `n` entries each, followed by index table of `h` entries */
+#define MQTT_REQUESTS_MEM_SIZE(n, h)                                                                                   \
+    (LWGSM_MEM_ALIGN((size_t)(n) * sizeof(lwgsm_mqtt_request_t)) + ((size_t)2 * (n) + (h)) * sizeof(uint16_t))
+
+#if LWGSM_CFG_STATIC_ALLOC
+/* Client structure, followed by requests and TX and RX buffer of maximal length */
+#define MQTT_CLIENT_REQUESTS_OFFSET LWGSM_MEM_ALIGN(sizeof(lwgsm_mqtt_client_t))
+#define MQTT_CLIENT_TX_BUFF_OFFSET                                                                                     \
+    (MQTT_CLIENT_REQUESTS_OFFSET                                                                                       \
+     + LWGSM_MEM_ALIGN(MQTT_REQUESTS_MEM_SIZE(LWGSM_CFG_MQTT_MAX_REQUESTS, 4 * LWGSM_CFG_MQTT_MAX_REQUESTS)))
+#define MQTT_CLIENT_RX_BUFF_OFFSET (MQTT_CLIENT_TX_BUFF_OFFSET + LWGSM_MEM_ALIGN(LWGSM_CFG_STATIC_MQTT_TX_BUFF_LEN))
+LWGSM_MEM_POOL_DEFINE(lwgsmi_mqtt_client_pool, LWGSM_MEM_POOL_MQTT_CLIENT,
+                      MQTT_CLIENT_RX_BUFF_OFFSET + LWGSM_CFG_STATIC_MQTT_RX_BUFF_LEN,
+                      LWGSM_CFG_STATIC_MQTT_CLIENT_NUM);
+#endif /* LWGSM_CFG_STATIC_ALLOC */
+
+#if LWGSM_CFG_MQTT_RETRANSMIT
+#if LWGSM_CFG_STATIC_ALLOC
+/* Packet cannot be longer than TX buffer */
+LWGSM_MEM_POOL_DEFINE(lwgsmi_mqtt_retx_pool, LWGSM_MEM_POOL_MQTT_RETX, LWGSM_CFG_STATIC_MQTT_TX_BUFF_LEN,
+                      LWGSM_CFG_STATIC_MQTT_RETX_NUM);
+#define MQTT_RETX_ALLOC(len)                                                                                           \
+    ((len) <= LWGSM_CFG_STATIC_MQTT_TX_BUFF_LEN ? lwgsmi_mem_pool_alloc(&lwgsmi_mqtt_retx_pool) : NULL)
+#define MQTT_RETX_FREE_S(p) lwgsmi_mem_pool_free_s(&lwgsmi_mqtt_retx_pool, (void**)&(p))
+#else /* LWGSM_CFG_STATIC_ALLOC */
+#define MQTT_RETX_ALLOC(len) lwgsm_mem_malloc_tag(LWGSM_MEM_TAG_MQTT, (len))
+#define MQTT_RETX_FREE_S(p)  lwgsm_mem_free_tag_s((void**)&(p))
+#endif /* !LWGSM_CFG_STATIC_ALLOC */
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT */
+
 /* Tracing debug message */
 #define LWGSM_CFG_DBG_MQTT_TRACE         (LWGSM_CFG_DBG_MQTT | LWGSM_DBG_TYPE_TRACE)
 #define LWGSM_CFG_DBG_MQTT_STATE         (LWGSM_CFG_DBG_MQTT | LWGSM_DBG_TYPE_STATE)
@@ -120,6 +218,43 @@ typedef enum {
 #define MQTT_REQUEST_FLAG_SUBSCRIBE     0x04 /*!< Request object has subscribe type */
 #define MQTT_REQUEST_FLAG_UNSUBSCRIBE   0x08 /*!< Request object has unsubscribe type */
 
+#define MQTT_REQUEST_FLAG_PUBREL        0x10 /*!< Publish with QoS 2 received by server, waiting for PUBCOMP */
+#define MQTT_REQUEST_FLAG_RESEND        0x20 /*!< Request must be sent again after reconnection */
+#define MQTT_REQUEST_FLAG_QUEUE         0x40 /*!< Publish of message from store-and-forward queue */
+#define MQTT_REQUEST_FLAG_PUBLISH_QOS   0x80 /*!< Publish with QoS > 0, counted against receive maximum */
+
+/* Duplicate flag in first byte of publish packet */
+#define MQTT_PUBLISH_FLAG_DUP           0x08
+
+/* Maximal remaining length, encoded with 4 bytes */
+#define MQTT_MAX_REM_LEN                0x0FFFFFFFUL
+
+/* Protocol level in CONNECT packet */
+#define MQTT_PROTOCOL_V311              0x04
+#define MQTT_PROTOCOL_V5                0x05
+
+#if LWGSM_CFG_MQTT_V5
+/* MQTT 5.0 property identifiers used by client */
+#define MQTT_PROP_SESSION_EXPIRY        0x11
+#define MQTT_PROP_SERVER_KEEP_ALIVE     0x13
+#define MQTT_PROP_RECEIVE_MAX           0x21
+#define MQTT_PROP_TOPIC_ALIAS_MAX       0x22
+#define MQTT_PROP_TOPIC_ALIAS           0x23
+#define MQTT_PROP_MAX_QOS               0x24
+#define MQTT_PROP_RETAIN_AVAILABLE      0x25
+#define MQTT_PROP_MAX_PACKET_SIZE       0x27
+
+/* Reason codes from 0x80 indicate failure */
+#define MQTT_REASON_IS_ERROR(r)         ((r) >= 0x80)
+
+#define MQTT_IS_V5(c)                   ((c)->version == MQTT_PROTOCOL_V5)
+#else /* LWGSM_CFG_MQTT_V5 */
+#define MQTT_IS_V5(c) 0
+#endif /* !LWGSM_CFG_MQTT_V5 */
+
+/* Home position of packet ID in requests index table */
+#define MQTT_REQUEST_IDX_HOME(c, pkt_id) ((size_t)(pkt_id) & (c)->requests_idx_mask)
+
 #if LWGSM_CFG_DBG
 
 /**
@@ -148,27 +283,75 @@ prv_mqtt_evt_fn_default(lwgsm_mqtt_client_p client, lwgsm_mqtt_evt_t* evt) {
     LWGSM_UNUSED(evt);
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/* MQTT requests helper function                                                                      */
+/******************************************************************************************************/
+/******************************************************************************************************/
+
+/**
+ * \brief           Initialize request objects and tables to empty state
+ * \param[in]       client: MQTT client
+ */
+static void
+prv_requests_reset(lwgsm_mqtt_client_p client) {
+    LWGSM_MEMSET(client->requests, 0x00, sizeof(*client->requests) * client->requests_size);
+    LWGSM_MEMSET(client->requests_idx, 0x00, sizeof(*client->requests_idx) * (client->requests_idx_mask + 1));
+
+    /* Put all objects to free stack, lowest index on top */
+    for (size_t i = 0; i < client->requests_size; ++i) {
+        client->requests_free[i] = LWGSM_U16(client->requests_size - 1 - i);
+    }
+    client->requests_free_cnt = client->requests_size;
+    client->requests_fifo_r = 0;
+    client->requests_fifo_cnt = 0;
+#if LWGSM_CFG_MQTT_V5
+    client->pub_in_flight = 0;
+#endif /* LWGSM_CFG_MQTT_V5 */
+}
+
+/**
+ * \brief           Find request with packet ID
+ * \param[in]       client: MQTT client
+ * \param[in]       pkt_id: Packet ID, must not be `0`
+ * \return          Request on success, `NULL` otherwise
+ */
+static lwgsm_mqtt_request_t*
+prv_request_find(lwgsm_mqtt_client_p client, uint16_t pkt_id) {
+    for (size_t pos = MQTT_REQUEST_IDX_HOME(client, pkt_id); client->requests_idx[pos] != 0;
+         pos = (pos + 1) & client->requests_idx_mask) {
+        lwgsm_mqtt_request_t* request = &client->requests[client->requests_idx[pos] - 1];
+        if (request->packet_id == pkt_id) {
+            return request;
+        }
+    }
+    return NULL;
+}
+
 /**
  * \brief           Create new message ID
+ *
+ * Packet IDs still used by requests in flight are skipped
+ *
  * \param[in]       client: MQTT client
  * \return          New packet ID
  */
 static uint16_t
 prv_create_packet_id(lwgsm_mqtt_client_p client) {
-    if (++client->last_packet_id == 0) {
-        client->last_packet_id = 1;
-    }
+    do {
+        if (++client->last_packet_id == 0) {
+            client->last_packet_id = 1;
+        }
+    } while (prv_request_find(client, client->last_packet_id) != NULL);
     return client->last_packet_id;
 }
 
-/******************************************************************************************************/
-/******************************************************************************************************/
-/* MQTT requests helper function                                                                      */
-/******************************************************************************************************/
-/******************************************************************************************************/
-
 /**
  * \brief           Create and return new request object
+ *
+ * Requests with packet ID are indexed in open addressing table for constant time lookup,
+ * requests without packet ID (QoS `0` publish) are kept in order of sending
+ *
  * \param[in]       client: MQTT client
  * \param[in]       packet_id: Packet ID for QoS `1` or `2`
  * \param[in]       arg: User optional argument for identifying packets
@@ -177,20 +360,41 @@ prv_create_packet_id(lwgsm_mqtt_client_p client) {
 static lwgsm_mqtt_request_t*
 prv_request_create(lwgsm_mqtt_client_p client, uint16_t packet_id, void* arg) {
     lwgsm_mqtt_request_t* request;
-    uint16_t i;
+    uint16_t idx, used;
 
-    /* Try to find a new request which does not have IN_USE flag set */
-    for (request = NULL, i = 0; i < LWGSM_CFG_MQTT_MAX_REQUESTS; ++i) {
-        if (!(client->requests[i].status & MQTT_REQUEST_FLAG_IN_USE)) {
-            request = &client->requests[i]; /* We have empty request */
-            break;
+    if (client->requests_free_cnt == 0) {
+        ++client->requests_failed;
+        return NULL;
+    }
+    idx = client->requests_free[--client->requests_free_cnt]; /* Take free object from stack */
+    request = &client->requests[idx];
+
+    if (packet_id != 0) {
+        size_t pos = MQTT_REQUEST_IDX_HOME(client, packet_id);
+        while (client->requests_idx[pos] != 0) { /* Index is never full, at least half is empty */
+            pos = (pos + 1) & client->requests_idx_mask;
         }
+        client->requests_idx[pos] = LWGSM_U16(idx + 1);
+    } else {
+        client->requests_fifo[(client->requests_fifo_r + client->requests_fifo_cnt) % client->requests_size] = idx;
+        ++client->requests_fifo_cnt;
     }
-    if (request != NULL) {
-        request->packet_id = packet_id;             /* Set request packet ID */
-        request->arg = arg;                         /* Set user argument */
-        request->status = MQTT_REQUEST_FLAG_IN_USE; /* Reset everything at this point */
+
+    used = client->requests_size - client->requests_free_cnt;
+    if (used > client->requests_max_used) {
+        client->requests_max_used = used;
     }
+
+    request->packet_id = packet_id;             /* Set request packet ID */
+    request->arg = arg;                         /* Set user argument */
+    request->status = MQTT_REQUEST_FLAG_IN_USE; /* Reset everything at this point */
+#if LWGSM_CFG_MQTT_RETRANSMIT
+    request->packet = NULL;
+    request->packet_len = 0;
+    request->retries = 0;
+    request->timeout = LWGSM_CFG_MQTT_RETRANSMIT_TIMEOUT;
+    request->send_seq = client->requests_send_seq++;
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT */
     return request;
 }
 
@@ -201,8 +405,56 @@ prv_request_create(lwgsm_mqtt_client_p client, uint16_t packet_id, void* arg) {
  */
 static void
 prv_request_delete(lwgsm_mqtt_client_p client, lwgsm_mqtt_request_t* request) {
-    request->status = 0; /* Reset status to make request unused */
-    LWGSM_UNUSED(client);
+    uint16_t idx = LWGSM_U16(request - client->requests);
+
+    if (request->packet_id != 0) {
+        size_t pos, next, home;
+
+        /* Find entry in index table */
+        for (pos = MQTT_REQUEST_IDX_HOME(client, request->packet_id); client->requests_idx[pos] != (idx + 1);
+             pos = (pos + 1) & client->requests_idx_mask) {}
+
+        /* Shift following entries of the same cluster back, to keep lookup chains unbroken */
+        for (next = (pos + 1) & client->requests_idx_mask; client->requests_idx[next] != 0;
+             next = (next + 1) & client->requests_idx_mask) {
+            home = MQTT_REQUEST_IDX_HOME(client, client->requests[client->requests_idx[next] - 1].packet_id);
+            if (((next - home) & client->requests_idx_mask) >= ((next - pos) & client->requests_idx_mask)) {
+                client->requests_idx[pos] = client->requests_idx[next];
+                pos = next;
+            }
+        }
+        client->requests_idx[pos] = 0;
+    } else if (client->requests_fifo_cnt > 0) {
+        size_t i = 0;
+
+        /* Normally first entry is deleted, search is needed only when connection is closed */
+        while (i < client->requests_fifo_cnt
+               && client->requests_fifo[(client->requests_fifo_r + i) % client->requests_size] != idx) {
+            ++i;
+        }
+        if (i == 0) {
+            client->requests_fifo_r = LWGSM_U16((client->requests_fifo_r + 1) % client->requests_size);
+            --client->requests_fifo_cnt;
+        } else if (i < client->requests_fifo_cnt) {
+            for (; i + 1 < client->requests_fifo_cnt; ++i) {
+                client->requests_fifo[(client->requests_fifo_r + i) % client->requests_size] =
+                    client->requests_fifo[(client->requests_fifo_r + i + 1) % client->requests_size];
+            }
+            --client->requests_fifo_cnt;
+        }
+    }
+
+#if LWGSM_CFG_MQTT_RETRANSMIT
+    /* Packet copy is not needed anymore */
+    MQTT_RETX_FREE_S(request->packet);
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT */
+#if LWGSM_CFG_MQTT_V5
+    if (request->status & MQTT_REQUEST_FLAG_PUBLISH_QOS) {
+        --client->pub_in_flight; /* Publish does not count to receive maximum anymore */
+    }
+#endif /* LWGSM_CFG_MQTT_V5 */
+    request->status = 0;                                      /* Reset status to make request unused */
+    client->requests_free[client->requests_free_cnt++] = idx; /* Return object to free stack */
 }
 
 /**
@@ -225,24 +477,85 @@ prv_request_set_pending(lwgsm_mqtt_client_p client, lwgsm_mqtt_request_t* reques
  */
 static lwgsm_mqtt_request_t*
 prv_request_get_pending(lwgsm_mqtt_client_p client, int32_t pkt_id) {
-    /* Try to find a new request which does not have IN_USE flag set */
-    for (size_t i = 0; i < LWGSM_CFG_MQTT_MAX_REQUESTS; ++i) {
-        if ((client->requests[i].status & MQTT_REQUEST_FLAG_PENDING)
-            && (pkt_id == -1 || client->requests[i].packet_id == (uint16_t)pkt_id)) {
-            return &client->requests[i];
+    lwgsm_mqtt_request_t* request = NULL;
+
+    if (pkt_id == -1) {
+        for (size_t i = 0; i < client->requests_size; ++i) {
+            if (client->requests[i].status & MQTT_REQUEST_FLAG_PENDING) {
+                return &client->requests[i];
+            }
+        }
+    } else if (pkt_id == 0) {
+        if (client->requests_fifo_cnt > 0) {
+            request = &client->requests[client->requests_fifo[client->requests_fifo_r]];
         }
+    } else {
+        request = prv_request_find(client, (uint16_t)pkt_id);
+    }
+    return request != NULL && (request->status & MQTT_REQUEST_FLAG_PENDING) ? request : NULL;
+}
+
+/**
+ * \brief           Get pending request without packet ID, fully sent on connection
+ *
+ * Requests without packet ID are sent in order of creation,
+ * hence only the oldest one has to be checked
+ *
+ * \param[in]       client: MQTT client
+ * \return          Request on success, `NULL` otherwise
+ */
+static lwgsm_mqtt_request_t*
+prv_request_get_sent(lwgsm_mqtt_client_p client) {
+    lwgsm_mqtt_request_t* request;
+
+    if ((request = prv_request_get_pending(client, 0)) != NULL
+        && (int32_t)(client->sent_total - request->expected_sent_len) >= 0) {
+        return request;
     }
     return NULL;
 }
 
+#if LWGSM_CFG_MQTT_RETRANSMIT || __DOXYGEN__
+
+/**
+ * \brief           Allocate memory for copy of packet, used for retransmission
+ * \param[in]       request: Request to allocate packet copy for
+ * \param[in]       raw_len: Length of raw packet in units of bytes
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+prv_request_packet_alloc(lwgsm_mqtt_request_t* request, uint32_t raw_len) {
+    if (raw_len > 0xFFFF) { /* Copy length is limited to 16-bit */
+        return 0;
+    }
+    request->packet = MQTT_RETX_ALLOC(raw_len);
+    request->packet_len = LWGSM_U16(raw_len);
+    return request->packet != NULL;
+}
+
+/**
+ * \brief           Copy packet of request, which has just been written to TX buffer
+ * \note            Packet must be the last one in the buffer
+ * \param[in]       client: MQTT client
+ * \param[in]       request: Request with allocated packet copy
+ */
+static void
+prv_request_packet_store(lwgsm_mqtt_client_p client, lwgsm_mqtt_request_t* request) {
+    lwgsm_buff_peek(&client->tx_buff, lwgsm_buff_get_full(&client->tx_buff) - request->packet_len, request->packet,
+                    request->packet_len);
+}
+
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT || __DOXYGEN__ */
+
 /**
  * \brief           Send error callback to user
  * \param[in]       client: MQTT client
  * \param[in]       status: Request status
  * \param[in]       arg: User argument
+ * \param[in]       res: Error result to report
  */
 static void
-prv_request_send_err_callback(lwgsm_mqtt_client_p client, uint8_t status, void* arg) {
+prv_request_send_err_callback(lwgsm_mqtt_client_p client, uint8_t status, void* arg, lwgsmr_t res) {
     if (status & MQTT_REQUEST_FLAG_SUBSCRIBE) {
         client->evt.type = LWGSM_MQTT_EVT_SUBSCRIBE;
     } else if (status & MQTT_REQUEST_FLAG_UNSUBSCRIBE) {
@@ -253,14 +566,39 @@ prv_request_send_err_callback(lwgsm_mqtt_client_p client, uint8_t status, void*
 
     if (client->evt.type == LWGSM_MQTT_EVT_PUBLISH) {
         client->evt.evt.publish.arg = arg;
-        client->evt.evt.publish.res = lwgsmERR;
+        client->evt.evt.publish.res = res;
     } else {
         client->evt.evt.sub_unsub_scribed.arg = arg;
-        client->evt.evt.sub_unsub_scribed.res = lwgsmERR;
+        client->evt.evt.sub_unsub_scribed.res = res;
     }
     client->evt_fn(client, &client->evt);
 }
 
+/**
+ * \brief           Report result of request to store-and-forward queue, when message was sent from queue
+ * \note            Must be called before request is deleted
+ * \param[in]       client: MQTT client
+ * \param[in]       request: Finished request
+ * \param[in]       res: Request result
+ * \return          `1` if result was reported to queue and user callback must not be called, `0` otherwise
+ */
+static uint8_t
+prv_request_queue_ack(lwgsm_mqtt_client_p client, lwgsm_mqtt_request_t* request, lwgsmr_t res) {
+#if LWGSM_CFG_MQTT_QUEUE
+    if (request->status & MQTT_REQUEST_FLAG_QUEUE) {
+        if (client->queue != NULL) {
+            lwgsmi_mqtt_queue_ack(client->queue, request->queue_seq, res);
+        }
+        return 1;
+    }
+#else  /* LWGSM_CFG_MQTT_QUEUE */
+    LWGSM_UNUSED(client);
+    LWGSM_UNUSED(request);
+    LWGSM_UNUSED(res);
+#endif /* !LWGSM_CFG_MQTT_QUEUE */
+    return 0;
+}
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /* MQTT buffer helper functions                                                                       */
@@ -278,7 +616,7 @@ prv_request_send_err_callback(lwgsm_mqtt_client_p client, uint8_t status, void*
  */
 static void
 prv_write_fixed_header(lwgsm_mqtt_client_p client, mqtt_msg_type_t type, uint8_t dup, lwgsm_mqtt_qos_t qos,
-                       uint8_t retain, uint16_t rem_len) {
+                       uint8_t retain, uint32_t rem_len) {
     uint8_t b;
 
     /*
@@ -347,49 +685,181 @@ prv_write_data(lwgsm_mqtt_client_p client, const void* data, size_t len) {
 }
 
 /**
- * \brief           Check if output buffer has enough memory to handle
- *                  all bytes required to encode packet to RAW format
+ * \brief           Get number of bytes of packet in RAW format
  *
  *                  It calculates additional bytes required to encode
  *                  remaining length itself + 1 byte for packet header
- * \param[in]       client: MQTT client
  * \param[in]       rem_len: Remaining length of packet
- * \return          Number of required RAW bytes or `0` if no memory available
+ * \return          Number of RAW bytes of packet
  */
-static uint16_t
-prv_output_check_enough_memory(lwgsm_mqtt_client_p client, uint16_t rem_len) {
-    uint16_t total_len = rem_len + 1; /* Remaining length + first (packet start) byte */
+static uint32_t
+prv_packet_raw_len(uint32_t rem_len) {
+    uint32_t total_len = rem_len + 1; /* Remaining length + first (packet start) byte */
 
     do { /* Calculate bytes for encoding remaining length itself */
         ++total_len;
         rem_len >>= 7; /* Encoded with 7 bits per byte */
     } while (rem_len > 0);
+    return total_len;
+}
 
-    return LWGSM_U16(lwgsm_buff_get_free(&client->tx_buff)) >= total_len ? total_len : 0;
+/**
+ * \brief           Check if output buffer has enough memory to handle
+ *                  all bytes required to encode packet to RAW format
+ * \note            No memory is available until active streaming publish is completely written
+ * \param[in]       client: MQTT client
+ * \param[in]       rem_len: Remaining length of packet
+ * \return          Number of required RAW bytes or `0` if no memory available
+ */
+static uint32_t
+prv_output_check_enough_memory(lwgsm_mqtt_client_p client, uint32_t rem_len) {
+    uint32_t total_len;
+
+    if (client->stream_fn != NULL) { /* Packets cannot be written in the middle of streamed payload */
+        return 0;
+    }
+    total_len = prv_packet_raw_len(rem_len);
+    return lwgsm_buff_get_free(&client->tx_buff) >= total_len ? total_len : 0;
+}
+
+/**
+ * \brief           Check if keep-alive time elapsed and `PINGREQ` has to be sent
+ * \param[in]       client: MQTT client
+ * \return          `1` if `PINGREQ` is due, `0` otherwise
+ */
+static uint8_t
+prv_keep_alive_due(lwgsm_mqtt_client_p client) {
+    return client->keep_alive /* Keep alive must be enabled */
+           /* Poll time is in units of LWGSM_CFG_CONN_POLL_INTERVAL milliseconds,
+              while keep_alive is in units of seconds */
+           && (client->poll_time * LWGSM_CFG_CONN_POLL_INTERVAL) >= (uint32_t)(client->keep_alive * 1000);
+}
+
+/**
+ * \brief           Write `PINGREQ` packet to TX buffer
+ * \param[in]       client: MQTT client
+ * \return          `1` on success, `0` if packet cannot be written now
+ */
+static uint8_t
+prv_write_pingreq(lwgsm_mqtt_client_p client) {
+    if (!prv_output_check_enough_memory(client, 0)) { /* Check if memory available in output buffer */
+        return 0;
+    }
+    prv_write_fixed_header(client, MQTT_MSG_TYPE_PINGREQ, 0, (lwgsm_mqtt_qos_t)0, 0,
+                           0); /* Write PINGREQ command to output buffer */
+    client->poll_time = 0;     /* Reset polling time */
+    LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] Sending PINGREQ packet\r\n");
+    return 1;
+}
+
+/**
+ * \brief           Write pending responses and due `PINGREQ` to TX buffer
+ *
+ * Packets are pending while streaming publish payload is written or TX buffer is full,
+ * they are written in order of creation at next packet boundary
+ *
+ * \param[in]       client: MQTT client
+ */
+static void
+prv_write_pending(lwgsm_mqtt_client_p client) {
+    while (client->resp_pending_cnt > 0) {
+        const mqtt_resp_t* resp = &client->resp_pending[client->resp_pending_r];
+
+        if (!prv_output_check_enough_memory(client, 2)) {
+            return;
+        }
+        prv_write_fixed_header(client, (mqtt_msg_type_t)resp->msg_type, 0, (lwgsm_mqtt_qos_t)resp->qos, 0, 2);
+        prv_write_u16(client, resp->pkt_id);
+        LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] Pending response %s written to output memory\r\n",
+                     prv_mqtt_msg_type_to_str((mqtt_msg_type_t)resp->msg_type));
+        client->resp_pending_r = LWGSM_U8((client->resp_pending_r + 1) % LWGSM_CFG_MQTT_PENDING_RESP_NUM);
+        --client->resp_pending_cnt;
+    }
+    if (prv_keep_alive_due(client)) {
+        prv_write_pingreq(client);
+    }
+}
+
+/**
+ * \brief           Write next payload data of active streaming publish to TX buffer
+ *
+ * Payload callback is called until TX buffer is full or it has no data available.
+ * Stream is completed when all payload bytes are written,
+ * packets pending during the stream are written after it
+ *
+ * \param[in]       client: MQTT client
+ */
+static void
+prv_stream_write(lwgsm_mqtt_client_p client) {
+    while (client->stream_fn != NULL) {
+        size_t len, written;
+        void* ptr;
+
+        if ((ptr = lwgsm_buff_write_reserve(&client->tx_buff, &len)) == NULL) {
+            break; /* Continue when sent data make space in TX buffer */
+        }
+        len = LWGSM_MIN(len, (size_t)(client->stream_len - client->stream_offset));
+        if ((written = client->stream_fn(client, ptr, client->stream_offset, len, client->stream_arg)) == 0) {
+            break; /* Try again on next poll */
+        }
+        written = lwgsm_buff_write_commit(&client->tx_buff, LWGSM_MIN(written, len));
+        client->stream_offset += LWGSM_U32(written);
+        if (client->stream_offset == client->stream_len) {
+            client->stream_fn = NULL; /* Payload complete, other packets may be written again */
+            LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] Streaming publish payload written\r\n");
+        }
+    }
+    prv_write_pending(client);
 }
 
 /**
  * \brief           Write and send acknowledge/record
+ *
+ * Response is kept pending when streaming publish payload is being written or TX buffer is full,
+ * and is written by \ref prv_write_pending at next packet boundary
+ *
  * \param[in]       client: MQTT client
  * \param[in]       msg_type: Message type to respond
  * \param[in]       pkt_id: Packet ID to send response for
  * \param[in]       qos: Quality of service for packet
- * \return          `1` on success, `0` otherwise
+ * \return          `1` on success or when response is pending, `0` otherwise
  */
 static uint8_t
 prv_write_ack_rec_rel_resp(lwgsm_mqtt_client_p client, mqtt_msg_type_t msg_type, uint16_t pkt_id,
                            lwgsm_mqtt_qos_t qos) {
-    if (prv_output_check_enough_memory(client, 2)) {            /* Check memory for response packet */
+    mqtt_resp_t* resp;
+    uint8_t idx;
+
+    prv_write_pending(client); /* Responses are written in order */
+    if (client->resp_pending_cnt == 0 && prv_output_check_enough_memory(client, 2)) {
         prv_write_fixed_header(client, msg_type, 0, qos, 0, 2); /* Write fixed header with 2 more bytes for packet id */
         prv_write_u16(client, pkt_id);                          /* Write packet ID */
         prv_send_data(client);                                  /* Flush data to output */
         LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] Response %s written to output memory\r\n",
                      prv_mqtt_msg_type_to_str(msg_type));
         return 1;
-    } else {
-        LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] No memory to write %s packet\r\n",
+    }
+
+    /* Same response may be requested again by retransmission while it is still pending */
+    for (uint8_t i = 0; i < client->resp_pending_cnt; ++i) {
+        resp = &client->resp_pending[(client->resp_pending_r + i) % LWGSM_CFG_MQTT_PENDING_RESP_NUM];
+        if (resp->msg_type == (uint8_t)msg_type && resp->pkt_id == pkt_id) {
+            return 1;
+        }
+    }
+    if (client->resp_pending_cnt < LWGSM_CFG_MQTT_PENDING_RESP_NUM) {
+        idx = LWGSM_U8((client->resp_pending_r + client->resp_pending_cnt) % LWGSM_CFG_MQTT_PENDING_RESP_NUM);
+        resp = &client->resp_pending[idx];
+        resp->msg_type = (uint8_t)msg_type;
+        resp->qos = (uint8_t)qos;
+        resp->pkt_id = pkt_id;
+        ++client->resp_pending_cnt;
+        LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] Response %s pending until TX buffer is available\r\n",
                      prv_mqtt_msg_type_to_str(msg_type));
+        return 1;
     }
+    LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE_WARNING, "[LWGSM MQTT] No memory to write %s packet\r\n",
+                 prv_mqtt_msg_type_to_str(msg_type));
     return 0;
 }
 
@@ -405,6 +875,296 @@ prv_write_string(lwgsm_mqtt_client_p client, const char* str, uint16_t len) {
     lwgsm_buff_write(&client->tx_buff, str, len); /* Write string to buffer */
 }
 
+#if LWGSM_CFG_MQTT_V5 || __DOXYGEN__
+
+/**
+ * \brief           Write 32-bit value in MSB first format to output buffer
+ * \param[in]       client: MQTT client
+ * \param[in]       num: Number to write
+ */
+static void
+prv_write_u32(lwgsm_mqtt_client_p client, uint32_t num) {
+    prv_write_u16(client, LWGSM_U16(num >> 16));
+    prv_write_u16(client, LWGSM_U16(num & 0xFFFF));
+}
+
+/**
+ * \brief           Write variable byte integer to output buffer
+ * \param[in]       client: MQTT client
+ * \param[in]       num: Number to write
+ */
+static void
+prv_write_varint(lwgsm_mqtt_client_p client, uint32_t num) {
+    do {
+        prv_write_u8(client, LWGSM_U8((num & 0x7F) | (num > 0x7F ? 0x80 : 0)));
+        num >>= 7;
+    } while (num > 0);
+}
+
+/**
+ * \brief           Get number of bytes to encode value as variable byte integer
+ * \param[in]       num: Value to encode
+ * \return          Number of bytes
+ */
+static uint8_t
+prv_varint_len(uint32_t num) {
+    uint8_t len = 0;
+
+    do {
+        ++len;
+        num >>= 7;
+    } while (num > 0);
+    return len;
+}
+
+/**
+ * \brief           Read variable byte integer from received packet
+ * \param[in]       client: MQTT client
+ * \param[in,out]   pos: Read position in RX buffer, set to first byte after integer
+ * \param[out]      num: Decoded value
+ * \return          `1` on success, `0` if data are malformed
+ */
+static uint8_t
+prv_read_varint(lwgsm_mqtt_client_p client, size_t* pos, uint32_t* num) {
+    *num = 0;
+    for (uint8_t i = 0; i < 4 && *pos < client->msg_rem_len; ++i) {
+        uint8_t b = client->rx_buff[(*pos)++];
+
+        *num |= LWGSM_U32(b & 0x7F) << (7 * i);
+        if (!(b & 0x80)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Get position after properties block of received packet
+ * \param[in]       client: MQTT client
+ * \param[in]       pos: Position of properties length in RX buffer
+ * \param[out]      props: Position of first property. Can be set to `NULL`
+ * \return          Position of first byte after properties, `0` if properties are malformed
+ */
+static size_t
+prv_props_end(lwgsm_mqtt_client_p client, size_t pos, size_t* props) {
+    uint32_t len;
+
+    if (!prv_read_varint(client, &pos, &len) || len > client->msg_rem_len - pos) {
+        return 0;
+    }
+    if (props != NULL) {
+        *props = pos;
+    }
+    return pos + len;
+}
+
+/**
+ * \brief           Read next property from properties block of received packet
+ * \param[in]       client: MQTT client
+ * \param[in,out]   pos: Read position in RX buffer, set to next property
+ * \param[in]       end: Position of first byte after properties block
+ * \param[out]      id: Property identifier
+ * \param[out]      num: Value of integer property, `0` for string and binary properties
+ * \return          `1` if property was read, `0` at the end of block or if data are malformed
+ */
+static uint8_t
+prv_prop_read(lwgsm_mqtt_client_p client, size_t* pos, size_t end, uint8_t* id, uint32_t* num) {
+    const uint8_t* d = client->rx_buff;
+    size_t len = 0;
+    uint8_t strings = 0;
+
+    if (*pos >= end) {
+        return 0;
+    }
+    *id = d[(*pos)++];
+    *num = 0;
+    switch (*id) {
+        case 0x01: /* Payload format indicator */
+        case 0x17: /* Request problem information */
+        case 0x19: /* Request response information */
+        case 0x24: /* Maximum QoS */
+        case 0x25: /* Retain available */
+        case 0x28: /* Wildcard subscription available */
+        case 0x29: /* Subscription identifiers available */
+        case 0x2A: /* Shared subscription available */
+            len = 1;
+            break;
+        case 0x13: /* Server keep alive */
+        case 0x21: /* Receive maximum */
+        case 0x22: /* Topic alias maximum */
+        case 0x23: /* Topic alias */
+            len = 2;
+            break;
+        case 0x02: /* Message expiry interval */
+        case 0x11: /* Session expiry interval */
+        case 0x18: /* Will delay interval */
+        case 0x27: /* Maximum packet size */
+            len = 4;
+            break;
+        case 0x0B: { /* Subscription identifier */
+            uint8_t res = prv_read_varint(client, pos, num);
+            return res && *pos <= end;
+        }
+        case 0x03: /* Content type */
+        case 0x08: /* Response topic */
+        case 0x09: /* Correlation data */
+        case 0x12: /* Assigned client identifier */
+        case 0x15: /* Authentication method */
+        case 0x16: /* Authentication data */
+        case 0x1A: /* Response information */
+        case 0x1C: /* Server reference */
+        case 0x1F: /* Reason string */
+            strings = 1;
+            break;
+        case 0x26: /* User property, name and value */
+            strings = 2;
+            break;
+        default:
+            return 0;
+    }
+    if (strings > 0) {
+        /* Strings and binary data are prefixed with 16-bit length */
+        for (; strings > 0; --strings) {
+            if (end - *pos < 2) {
+                return 0;
+            }
+            len = 2 + (size_t)((d[*pos] << 8) | d[*pos + 1]);
+            if (len > end - *pos) {
+                return 0;
+            }
+            *pos += len;
+        }
+        return 1;
+    }
+    if (len > end - *pos) {
+        return 0;
+    }
+    for (; len > 0; --len) {
+        *num = (*num << 8) | d[(*pos)++];
+    }
+    return 1;
+}
+
+/**
+ * \brief           Select topic alias for publish packet, without modifying alias table
+ *
+ * Topic uses its alias when already known to server, or takes free alias.
+ * When all aliases are used, alias with the lowest usage score is taken over once its score drops to `0`,
+ * so that frequently used topics keep their aliases.
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic name
+ * \param[in]       topic_len: Length of topic name
+ * \param[out]      known: Set to `1` when alias is already bound to topic and topic may be omitted
+ * \return          Alias to use, `0` to send packet without alias
+ */
+static uint16_t
+prv_topic_alias_select(lwgsm_mqtt_client_p client, const char* topic, uint16_t topic_len, uint8_t* known) {
+    const mqtt_topic_alias_t* a;
+    uint16_t free_alias = 0, min_alias = 0;
+
+    *known = 0;
+    if (topic_len > LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_LEN) {
+        return 0;
+    }
+    for (uint16_t i = 0; i < client->topic_alias_max; ++i) {
+        a = &client->topic_aliases[i];
+        if (a->topic_len == 0) {
+            if (free_alias == 0) {
+                free_alias = i + 1;
+            }
+        } else if (a->topic_len == topic_len && !memcmp(a->topic, topic, topic_len)) {
+            *known = 1;
+            return i + 1;
+        } else if (min_alias == 0 || a->hits < client->topic_aliases[min_alias - 1].hits) {
+            min_alias = i + 1;
+        }
+    }
+    if (free_alias != 0) {
+        return free_alias;
+    }
+    return min_alias != 0 && client->topic_aliases[min_alias - 1].hits == 0 ? min_alias : 0;
+}
+
+/**
+ * \brief           Update alias table after publish packet was written to output buffer
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic name
+ * \param[in]       topic_len: Length of topic name
+ * \param[in]       alias: Alias selected with \ref prv_topic_alias_select
+ * \param[in]       known: Alias was already bound to topic
+ */
+static void
+prv_topic_alias_update(lwgsm_mqtt_client_p client, const char* topic, uint16_t topic_len, uint16_t alias,
+                       uint8_t known) {
+    mqtt_topic_alias_t* a;
+
+    if (alias != 0) {
+        a = &client->topic_aliases[alias - 1];
+        if (known) {
+            a->hits = LWGSM_U8(LWGSM_MIN(a->hits + 1, 0xFF));
+        } else { /* Packet carries topic and alias, server binds them together */
+            LWGSM_MEMCPY(a->topic, topic, topic_len);
+            a->topic_len = LWGSM_U8(topic_len);
+            a->hits = 1;
+        }
+    } else if (client->topic_alias_max > 0 && topic_len <= LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_LEN) {
+        /* Topic missed alias, age the least used alias to make it available over time */
+        a = &client->topic_aliases[0];
+        for (uint16_t i = 1; i < client->topic_alias_max; ++i) {
+            if (client->topic_aliases[i].hits < a->hits) {
+                a = &client->topic_aliases[i];
+            }
+        }
+        if (a->hits > 0) {
+            --a->hits;
+        }
+    }
+}
+
+/**
+ * \brief           Apply server limits from CONNACK properties
+ * \param[in]       client: MQTT client
+ * \return          `1` on success, `0` if properties are malformed
+ */
+static uint8_t
+prv_connack_props_parse(lwgsm_mqtt_client_p client) {
+    size_t pos, end;
+    uint32_t num;
+    uint8_t id;
+
+    if ((end = prv_props_end(client, 2, &pos)) == 0) {
+        return 0;
+    }
+    while (prv_prop_read(client, &pos, end, &id, &num)) {
+        switch (id) {
+            case MQTT_PROP_RECEIVE_MAX:
+                client->recv_max = num > 0 ? LWGSM_U16(num) : 0xFFFF;
+                break;
+            case MQTT_PROP_TOPIC_ALIAS_MAX:
+                client->topic_alias_max = LWGSM_U16(LWGSM_MIN(num, LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_NUM));
+                break;
+            case MQTT_PROP_MAX_QOS:
+                client->max_qos = LWGSM_U8(num);
+                break;
+            case MQTT_PROP_RETAIN_AVAILABLE:
+                client->retain_available = LWGSM_U8(num);
+                break;
+            case MQTT_PROP_MAX_PACKET_SIZE:
+                client->max_packet_size = num;
+                break;
+            case MQTT_PROP_SERVER_KEEP_ALIVE:
+                client->keep_alive = LWGSM_U16(num);
+                break;
+            default:
+                break;
+        }
+    }
+    return pos == end;
+}
+
+#endif /* LWGSM_CFG_MQTT_V5 || __DOXYGEN__ */
+
 /**
  * \brief           Send the actual data to the remote
  * \param[in]       client: MQTT client
@@ -414,22 +1174,25 @@ prv_send_data(lwgsm_mqtt_client_p client) {
     size_t len;
     const void* addr;
 
-    if (client->is_sending) { /* We are currently sending data */
-        return;
-    }
-
-    len = lwgsm_buff_get_linear_block_read_length(&client->tx_buff); /* Get length of linear memory */
-    if (len > 0) {                                                   /* Anything to send? */
+    /*
+     * Data between read pointer and written_total are already in flight
+     * and stay in the buffer until confirmed in sent callback.
+     * Submit next linear blocks after them, until in-flight limit is reached
+     */
+    while (client->sends_in_flight < LWGSM_CFG_MQTT_MAX_SENDS_IN_FLIGHT
+           && (addr = lwgsm_buff_read_peek(&client->tx_buff, client->written_total - client->sent_total, &len))
+                  != NULL) {
         lwgsmr_t res;
-        addr = lwgsm_buff_get_linear_block_read_address(&client->tx_buff); /* Get address of linear memory */
         if ((res = lwgsm_conn_send(client->conn, addr, len, NULL, 0)) == lwgsmOK) {
             client->written_total += len; /* Increase number of bytes written to queue */
-            client->is_sending = 1;       /* Remember active sending flag */
+            ++client->sends_in_flight;    /* One more segment in flight */
         } else {
             LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE_WARNING, "[LWGSM MQTT] Cannot send data with error: %d\r\n",
                          (int)res);
+            break;
         }
-    } else {
+    }
+    if (lwgsm_buff_get_full(&client->tx_buff) == 0) {
         /*
          * If buffer is empty, reset it to default state (read & write pointers)
          * This is to make sure everytime function needs to send data,
@@ -470,7 +1233,7 @@ prv_mqtt_close(lwgsm_mqtt_client_p client) {
 static uint8_t
 prv_sub_unsub(lwgsm_mqtt_client_p client, const char* topic, lwgsm_mqtt_qos_t qos, void* arg, uint8_t sub) {
     lwgsm_mqtt_request_t* request;
-    uint32_t rem_len;
+    uint32_t rem_len, raw_len;
     uint16_t len_topic, pkt_id;
     uint8_t ret = 0;
 
@@ -478,41 +1241,294 @@ prv_sub_unsub(lwgsm_mqtt_client_p client, const char* topic, lwgsm_mqtt_qos_t qo
         return 0;
     }
 
-    /*
-     * Calculate remaining length of packet
-     *
-     * rem_len = 2 (topic_len) + topic_len + 2 (pkt_id) + qos (if sub)
-     */
-    rem_len = 2 + len_topic + 2;
-    if (sub) {
-        ++rem_len;
+    /*
+     * Calculate remaining length of packet
+     *
+     * rem_len = 2 (topic_len) + topic_len + 2 (pkt_id) + qos (if sub)
+     */
+    rem_len = 2 + len_topic + 2;
+    if (sub) {
+        ++rem_len;
+    }
+    if (MQTT_IS_V5(client)) {
+        ++rem_len; /* Empty properties */
+    }
+
+    lwgsm_core_lock();
+    if (client->conn_state == LWGSM_MQTT_CONNECTED
+        && (raw_len = prv_output_check_enough_memory(client, rem_len)) != 0) { /* Check if enough memory */
+        pkt_id = prv_create_packet_id(client);                                 /* Create new packet ID */
+        /* Create request for packet */
+        request = prv_request_create(client, pkt_id, arg);
+#if LWGSM_CFG_MQTT_RETRANSMIT
+        if (request != NULL && !prv_request_packet_alloc(request, raw_len)) {
+            prv_request_delete(client, request);
+            request = NULL;
+        }
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT */
+        if (request != NULL) { /* Do we have a request */
+            prv_write_fixed_header(client, sub ? MQTT_MSG_TYPE_SUBSCRIBE : MQTT_MSG_TYPE_UNSUBSCRIBE, 0,
+                                   (lwgsm_mqtt_qos_t)1, 0, rem_len);
+            prv_write_u16(client, pkt_id); /* Write packet ID */
+            if (MQTT_IS_V5(client)) {
+                prv_write_u8(client, 0); /* Empty properties */
+            }
+            prv_write_string(client, topic, len_topic); /* Write topic string to packet */
+            if (sub) {                                  /* Send quality of service only on subscribe */
+                prv_write_u8(client, LWGSM_MIN(LWGSM_U8(qos),
+                                               LWGSM_U8(LWGSM_MQTT_QOS_EXACTLY_ONCE))); /* Write quality of service */
+            }
+
+            request->status |= sub ? MQTT_REQUEST_FLAG_SUBSCRIBE : MQTT_REQUEST_FLAG_UNSUBSCRIBE;
+#if LWGSM_CFG_MQTT_RETRANSMIT
+            prv_request_packet_store(client, request);
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT */
+            prv_request_set_pending(client, request); /* Set request as pending waiting for server reply */
+            prv_send_data(client);                    /* Try to send data */
+            ret = 1;
+        }
+    }
+    lwgsm_core_unlock();
+    return ret;
+}
+
+#if LWGSM_CFG_MQTT_QUEUE || __DOXYGEN__
+
+/**
+ * \brief           Copy message data from queue storage directly to TX buffer
+ * \param[in]       client: MQTT client
+ * \param[in]       addr: Storage address of data
+ * \param[in]       len: Number of bytes to copy
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+prv_queue_copy(lwgsm_mqtt_client_p client, uint32_t addr, size_t len) {
+    while (len > 0) {
+        size_t chunk;
+        void* ptr;
+
+        if ((ptr = lwgsm_buff_write_reserve(&client->tx_buff, &chunk)) == NULL) {
+            return 0;
+        }
+        chunk = LWGSM_MIN(chunk, len);
+        if (lwgsmi_mqtt_queue_read(client->queue, addr, ptr, chunk) != lwgsmOK) {
+            return 0;
+        }
+        lwgsm_buff_write_commit(&client->tx_buff, chunk);
+        addr += LWGSM_U32(chunk);
+        len -= chunk;
+    }
+    return 1;
+}
+
+/**
+ * \brief           Send next messages from store-and-forward queue
+ *
+ * Messages are sent in order, limited by queue window and drain rate.
+ * Packet ID is assigned on every send, message stays in queue until acknowledged.
+ *
+ * \param[in]       client: MQTT client
+ */
+static void
+prv_queue_drain(lwgsm_mqtt_client_p client) {
+    lwgsmi_mqtt_queue_msg_t msg;
+    lwgsm_mqtt_request_t* request;
+    uint32_t raw_len, rem_len;
+    uint16_t pkt_id;
+
+    /* Streamed payload must be written completely before next packet */
+    if (client->queue == NULL || client->conn_state != LWGSM_MQTT_CONNECTED || client->stream_fn != NULL) {
+        return;
+    }
+    while (lwgsmi_mqtt_queue_next(client->queue, &msg)) {
+#if LWGSM_CFG_MQTT_V5
+        if (MQTT_IS_V5(client)) {
+            /* Stored message may exceed limits of current server, send it with what server accepts */
+            msg.qos = LWGSM_MIN(msg.qos, client->max_qos);
+            msg.retain = LWGSM_U8(msg.retain && client->retain_available);
+            if (msg.qos > 0 && client->pub_in_flight >= client->recv_max) {
+                break;
+            }
+        }
+#endif /* LWGSM_CFG_MQTT_V5 */
+        rem_len = msg.len + (msg.qos > 0 ? 2 : 0) + (MQTT_IS_V5(client) ? 1 : 0);
+        raw_len = prv_output_check_enough_memory(client, rem_len);
+#if LWGSM_CFG_MQTT_V5
+        if (MQTT_IS_V5(client) && client->max_packet_size != 0 && raw_len > client->max_packet_size) {
+            LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE_WARNING,
+                         "[LWGSM MQTT] Queued message exceeds server maximum packet size, dropped\r\n");
+            lwgsmi_mqtt_queue_drop(client->queue, &msg);
+            continue;
+        }
+#endif /* LWGSM_CFG_MQTT_V5 */
+        if (raw_len == 0) {
+            if (lwgsm_buff_get_full(&client->tx_buff) == 0 && client->stream_fn == NULL) {
+                /* Message stored before queue was set to this client never fits to TX buffer */
+                LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE_WARNING,
+                             "[LWGSM MQTT] Queued message too long for TX buffer, dropped\r\n");
+                lwgsmi_mqtt_queue_drop(client->queue, &msg);
+                continue;
+            }
+            break;
+        }
+        pkt_id = msg.qos > 0 ? prv_create_packet_id(client) : 0;
+        if ((request = prv_request_create(client, pkt_id, NULL)) == NULL) {
+            break;
+        }
+#if LWGSM_CFG_MQTT_RETRANSMIT
+        if (pkt_id != 0 && !prv_request_packet_alloc(request, raw_len)) {
+            prv_request_delete(client, request);
+            break;
+        }
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT */
+        request->status |= MQTT_REQUEST_FLAG_QUEUE;
+        request->queue_seq = msg.seq;
+#if LWGSM_CFG_MQTT_V5
+        if (pkt_id != 0) {
+            request->status |= MQTT_REQUEST_FLAG_PUBLISH_QOS;
+            ++client->pub_in_flight;
+        }
+#endif /* LWGSM_CFG_MQTT_V5 */
+        request->expected_sent_len = client->sent_total + LWGSM_U32(lwgsm_buff_get_full(&client->tx_buff)) + raw_len;
+
+        /* Topic length and topic are followed by packet ID, then payload */
+        prv_write_fixed_header(client, MQTT_MSG_TYPE_PUBLISH, 0, (lwgsm_mqtt_qos_t)msg.qos, msg.retain, rem_len);
+        if (!prv_queue_copy(client, msg.addr, 2 + (size_t)msg.topic_len)) {
+            prv_request_delete(client, request);
+            prv_mqtt_close(client); /* Packet is incomplete in TX buffer */
+            return;
+        }
+        if (pkt_id != 0) {
+            prv_write_u16(client, pkt_id);
+        }
+        if (MQTT_IS_V5(client)) {
+            prv_write_u8(client, 0); /* Empty properties */
+        }
+        if (!prv_queue_copy(client, msg.addr + 2 + msg.topic_len, msg.len - 2 - (size_t)msg.topic_len)) {
+            prv_request_delete(client, request);
+            prv_mqtt_close(client);
+            return;
+        }
+#if LWGSM_CFG_MQTT_RETRANSMIT
+        if (pkt_id != 0) {
+            prv_request_packet_store(client, request);
+        }
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT */
+        prv_request_set_pending(client, request);
+        lwgsmi_mqtt_queue_sent(client->queue, &msg);
+        LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] Queued message sent. QoS: %d, pkt_id: %d\r\n",
+                     (int)msg.qos, (int)pkt_id);
+    }
+    prv_send_data(client);
+}
+
+#endif /* LWGSM_CFG_MQTT_QUEUE || __DOXYGEN__ */
+
+#if LWGSM_CFG_MQTT_RETRANSMIT || __DOXYGEN__
+
+/**
+ * \brief           Write request packet to TX buffer again
+ *
+ * Publish packet is sent with `DUP` flag, publish waiting for `PUBCOMP` sends `PUBREL` instead
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       request: Request to send again
+ * \return          `1` on success, `0` if there is not enough memory in TX buffer
+ */
+static uint8_t
+prv_request_write_again(lwgsm_mqtt_client_p client, lwgsm_mqtt_request_t* request) {
+    if (request->status & MQTT_REQUEST_FLAG_PUBREL) {
+        return prv_write_ack_rec_rel_resp(client, MQTT_MSG_TYPE_PUBREL, request->packet_id, (lwgsm_mqtt_qos_t)1);
+    }
+    if (request->packet == NULL) { /* Nothing to send, wait for timeout */
+        return 1;
+    }
+    if (client->stream_fn != NULL || lwgsm_buff_get_free(&client->tx_buff) < request->packet_len) {
+        return 0;
+    }
+    if (!(request->status & (MQTT_REQUEST_FLAG_SUBSCRIBE | MQTT_REQUEST_FLAG_UNSUBSCRIBE))) {
+        request->packet[0] |= MQTT_PUBLISH_FLAG_DUP;
+    }
+    lwgsm_buff_write(&client->tx_buff, request->packet, request->packet_len);
+    LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] Packet with pkt_id: %d written again\r\n",
+                 (int)request->packet_id);
+    return 1;
+}
+
+/**
+ * \brief           Send again requests without reply from server and fail requests after last retry
+ *
+ * Timeout doubles after every retransmission, up to \ref LWGSM_CFG_MQTT_RETRANSMIT_TIMEOUT_MAX.
+ * Requests marked after reconnection are sent immediately and do not count as retry.
+ * They are sent in original order of `PUBLISH` and `PUBREL` packets, as required by MQTT specification.
+ * MQTT 5.0 connection sends requests again only after reconnection, timeout is not used.
+ *
+ * \param[in]       client: MQTT client
+ */
+static void
+prv_requests_retransmit(lwgsm_mqtt_client_p client) {
+    uint32_t now = lwgsm_sys_now();
+
+    /* Requests kept from previous connection first, oldest sent first */
+    while (1) {
+        lwgsm_mqtt_request_t* request = NULL;
+
+        for (size_t i = 0; i < client->requests_size; ++i) {
+            lwgsm_mqtt_request_t* r = &client->requests[i];
+
+            if ((r->status & (MQTT_REQUEST_FLAG_PENDING | MQTT_REQUEST_FLAG_RESEND))
+                    == (MQTT_REQUEST_FLAG_PENDING | MQTT_REQUEST_FLAG_RESEND)
+                && r->packet_id != 0
+                && (request == NULL || (int32_t)(r->send_seq - request->send_seq) < 0)) {
+                request = r;
+            }
+        }
+        if (request == NULL) {
+            break;
+        }
+        if (!prv_request_write_again(client, request)) {
+            prv_send_data(client);
+            return; /* Try again on next poll, others must not overtake remaining requests */
+        }
+        request->status &= LWGSM_U8(~MQTT_REQUEST_FLAG_RESEND);
+        request->timeout_start_time = now;
     }
 
-    lwgsm_core_lock();
-    if (client->conn_state == LWGSM_MQTT_CONNECTED
-        && prv_output_check_enough_memory(client, rem_len)) { /* Check if enough memory to write packet data */
-        pkt_id = prv_create_packet_id(client);                /* Create new packet ID */
-        /* Create request for packet */
-        if ((request = prv_request_create(client, pkt_id, arg)) != NULL) { /* Do we have a request */
-            prv_write_fixed_header(client, sub ? MQTT_MSG_TYPE_SUBSCRIBE : MQTT_MSG_TYPE_UNSUBSCRIBE, 0,
-                                   (lwgsm_mqtt_qos_t)1, 0, rem_len);
-            prv_write_u16(client, pkt_id);              /* Write packet ID */
-            prv_write_string(client, topic, len_topic); /* Write topic string to packet */
-            if (sub) {                                  /* Send quality of service only on subscribe */
-                prv_write_u8(client, LWGSM_MIN(LWGSM_U8(qos),
-                                               LWGSM_U8(LWGSM_MQTT_QOS_EXACTLY_ONCE))); /* Write quality of service */
-            }
+    for (size_t i = 0; i < client->requests_size; ++i) {
+        lwgsm_mqtt_request_t* request = &client->requests[i];
 
-            request->status |= sub ? MQTT_REQUEST_FLAG_SUBSCRIBE : MQTT_REQUEST_FLAG_UNSUBSCRIBE;
-            prv_request_set_pending(client, request); /* Set request as pending waiting for server reply */
-            prv_send_data(client);                    /* Try to send data */
-            ret = 1;
+        if (!(request->status & MQTT_REQUEST_FLAG_PENDING) || request->packet_id == 0) {
+            continue;
+        }
+        if ((now - request->timeout_start_time) < request->timeout) {
+            continue;
         }
+        if (request->retries >= LWGSM_CFG_MQTT_RETRANSMIT_MAX_RETRIES) {
+            uint8_t status = request->status, queued;
+            void* arg = request->arg;
+
+            LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE_WARNING, "[LWGSM MQTT] No reply for pkt_id: %d, request failed\r\n",
+                         (int)request->packet_id);
+            queued = prv_request_queue_ack(client, request, lwgsmTIMEOUT);
+            prv_request_delete(client, request);
+            if (!queued) {
+                prv_request_send_err_callback(client, status, arg, lwgsmTIMEOUT);
+            }
+            continue;
+        }
+        /* MQTT 5.0 client must not send packets again on the same connection, it only waits for reply */
+        if (!MQTT_IS_V5(client) && !prv_request_write_again(client, request)) {
+            break; /* Try again on next poll, when memory is available */
+        }
+        ++request->retries;
+        request->timeout = LWGSM_MIN(request->timeout * 2, LWGSM_CFG_MQTT_RETRANSMIT_TIMEOUT_MAX);
+        request->timeout_start_time = now;
     }
-    lwgsm_core_unlock();
-    return ret;
+    prv_send_data(client);
 }
 
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT || __DOXYGEN__ */
+
 /**
  * \brief           Process incoming fully received message
  * \param[in]       client: MQTT client
@@ -535,8 +1551,20 @@ prv_mqtt_process_incoming_message(lwgsm_mqtt_client_p client) {
         case MQTT_MSG_TYPE_CONNACK: {
             lwgsm_mqtt_conn_status_t err = (lwgsm_mqtt_conn_status_t)client->rx_buff[1];
             if (client->conn_state == LWGSM_MQTT_CONNECTING) {
+#if LWGSM_CFG_MQTT_V5
+                if (MQTT_IS_V5(client) && err == LWGSM_MQTT_CONN_STATUS_ACCEPTED && !prv_connack_props_parse(client)) {
+                    LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE_WARNING, "[LWGSM MQTT] Malformed CONNACK properties\r\n");
+                    err = LWGSM_MQTT_CONN_STATUS_V5_MALFORMED;
+                }
+#endif /* LWGSM_CFG_MQTT_V5 */
                 if (err == LWGSM_MQTT_CONN_STATUS_ACCEPTED) {
                     client->conn_state = LWGSM_MQTT_CONNECTED;
+#if LWGSM_CFG_MQTT_RETRANSMIT
+                    prv_requests_retransmit(client); /* Send requests kept from previous connection */
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT */
+#if LWGSM_CFG_MQTT_QUEUE
+                    prv_queue_drain(client); /* Start sending messages stored while offline */
+#endif /* LWGSM_CFG_MQTT_QUEUE */
                 }
                 LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] CONNACK received with result: %d\r\n", (int)err);
 
@@ -570,6 +1598,19 @@ prv_mqtt_process_incoming_message(lwgsm_mqtt_client_p client) {
             } else {
                 pkt_id = 0; /* No packet ID */
             }
+#if LWGSM_CFG_MQTT_V5
+            if (MQTT_IS_V5(client)) {
+                size_t end = prv_props_end(client, (size_t)(data - client->rx_buff), NULL);
+
+                /* Properties are skipped, inbound topic aliases are not allowed by client */
+                if (end == 0) {
+                    LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE_WARNING, "[LWGSM MQTT] Malformed PUBLISH properties\r\n");
+                    prv_mqtt_close(client);
+                    break;
+                }
+                data = &client->rx_buff[end];
+            }
+#endif /* LWGSM_CFG_MQTT_V5 */
             data_len = client->msg_rem_len - (data - client->rx_buff); /* Calculate length of remaining data */
 
             LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE,
@@ -598,9 +1639,23 @@ prv_mqtt_process_incoming_message(lwgsm_mqtt_client_p client) {
             client->evt.evt.publish_recv.payload_len = data_len;
             client->evt.evt.publish_recv.dup = dup;
             client->evt.evt.publish_recv.qos = qos;
+            client->evt.evt.publish_recv.pbuf = client->rx_pbuf;
+#if LWGSM_CFG_MQTT_ROUTER
+            if (lwgsmi_mqtt_router_dispatch(&client->router, client, &client->evt) > 0) {
+                break;
+            }
+#endif /* LWGSM_CFG_MQTT_ROUTER */
             client->evt_fn(client, &client->evt);
             break;
         }
+#if LWGSM_CFG_MQTT_V5
+        case MQTT_MSG_TYPE_DISCONNECT: { /* Server closes connection, with MQTT 5.0 only */
+            LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] DISCONNECT received with reason: 0x%02X\r\n",
+                         (unsigned)(client->msg_rem_len > 0 ? client->rx_buff[0] : 0));
+            prv_mqtt_close(client);
+            break;
+        }
+#endif /* LWGSM_CFG_MQTT_V5 */
         case MQTT_MSG_TYPE_PINGRESP: { /* Respond to PINGREQ received */
             LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] Ping response received\r\n");
 
@@ -614,9 +1669,51 @@ prv_mqtt_process_incoming_message(lwgsm_mqtt_client_p client) {
         case MQTT_MSG_TYPE_PUBREL:
         case MQTT_MSG_TYPE_PUBACK:
         case MQTT_MSG_TYPE_PUBCOMP: {
+            lwgsmr_t res = lwgsmOK;
+
             pkt_id = client->rx_buff[0] << 8 | client->rx_buff[1]; /* Get packet ID */
 
+            /* Result of the request, reason code follows packet ID */
+            if (msg_type == MQTT_MSG_TYPE_SUBACK) {
+                size_t pos = 2;
+#if LWGSM_CFG_MQTT_V5
+                if (MQTT_IS_V5(client)) {
+                    pos = prv_props_end(client, pos, NULL);
+                }
+#endif /* LWGSM_CFG_MQTT_V5 */
+                res = pos > 0 && pos < client->msg_rem_len && client->rx_buff[pos] < 3 ? lwgsmOK : lwgsmERR;
+#if LWGSM_CFG_MQTT_V5
+            } else if (MQTT_IS_V5(client) && msg_type == MQTT_MSG_TYPE_UNSUBACK) {
+                size_t pos = prv_props_end(client, 2, NULL);
+                res = pos > 0 && pos < client->msg_rem_len && !MQTT_REASON_IS_ERROR(client->rx_buff[pos]) ? lwgsmOK
+                                                                                                        : lwgsmERR;
+            } else if (MQTT_IS_V5(client) && client->msg_rem_len > 2 && MQTT_REASON_IS_ERROR(client->rx_buff[2])) {
+                LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] %s rejected with reason: 0x%02X\r\n",
+                             prv_mqtt_msg_type_to_str(msg_type), (unsigned)client->rx_buff[2]);
+                res = lwgsmERR;
+#endif /* LWGSM_CFG_MQTT_V5 */
+            }
+
+#if LWGSM_CFG_MQTT_V5
+            if (msg_type == MQTT_MSG_TYPE_PUBREC && res != lwgsmOK) {
+                /* Server rejected the message, there is no PUBREL to send, flow ends here */
+                msg_type = MQTT_MSG_TYPE_PUBCOMP;
+            }
+#endif /* LWGSM_CFG_MQTT_V5 */
             if (msg_type == MQTT_MSG_TYPE_PUBREC) { /* Publish record received from server */
+#if LWGSM_CFG_MQTT_RETRANSMIT
+                lwgsm_mqtt_request_t* request;
+
+                /* Publish is stored by server, from now on only PUBREL is sent again */
+                if ((request = prv_request_get_pending(client, pkt_id)) != NULL) {
+                    MQTT_RETX_FREE_S(request->packet);
+                    request->status |= MQTT_REQUEST_FLAG_PUBREL;
+                    request->retries = 0;
+                    request->timeout = LWGSM_CFG_MQTT_RETRANSMIT_TIMEOUT;
+                    request->timeout_start_time = lwgsm_sys_now();
+                    request->send_seq = client->requests_send_seq++; /* PUBREL takes place of PUBLISH in order */
+                }
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT */
                 prv_write_ack_rec_rel_resp(client, MQTT_MSG_TYPE_PUBREL, pkt_id,
                                            (lwgsm_mqtt_qos_t)1); /* Send back publish release message */
             } else if (msg_type == MQTT_MSG_TYPE_PUBREL) {       /* Publish release was received */
@@ -638,17 +1735,18 @@ prv_mqtt_process_incoming_message(lwgsm_mqtt_client_p client) {
                         client->evt.type =
                             msg_type == MQTT_MSG_TYPE_SUBACK ? LWGSM_MQTT_EVT_SUBSCRIBE : LWGSM_MQTT_EVT_UNSUBSCRIBE;
                         client->evt.evt.sub_unsub_scribed.arg = request->arg;
-                        client->evt.evt.sub_unsub_scribed.res = client->rx_buff[2] < 3 ? lwgsmOK : lwgsmERR;
+                        client->evt.evt.sub_unsub_scribed.res = res;
                         client->evt_fn(client, &client->evt);
 
                         /*
                          * Final acknowledge of packet received
                          * Ack type depends on QoS level being sent to server on request
                          */
-                    } else if (msg_type == MQTT_MSG_TYPE_PUBCOMP || msg_type == MQTT_MSG_TYPE_PUBACK) {
+                    } else if ((msg_type == MQTT_MSG_TYPE_PUBCOMP || msg_type == MQTT_MSG_TYPE_PUBACK)
+                               && !prv_request_queue_ack(client, request, lwgsmOK)) {
                         client->evt.type = LWGSM_MQTT_EVT_PUBLISH;
                         client->evt.evt.publish.arg = request->arg;
-                        client->evt.evt.publish.res = lwgsmOK;
+                        client->evt.evt.publish.res = res;
                         client->evt_fn(client, &client->evt);
                     }
                     prv_request_delete(client, request); /* Delete request object */
@@ -722,12 +1820,14 @@ prv_mqtt_parse_incoming(lwgsm_mqtt_client_p client, lwgsm_pbuf_p pbuf) {
                                 /* Set new client pointer */
                                 client->rx_buff = &d[idx + 1]; /* Data are one byte after */
                                 client->rx_buff_len = client->msg_rem_len;
+                                client->rx_pbuf = pbuf;
 
                                 prv_mqtt_process_incoming_message(client); /* Process new message */
 
                                 /* Reset to previous values */
                                 client->rx_buff = tmp_ptr;
                                 client->rx_buff_len = tmp_len;
+                                client->rx_pbuf = NULL;
                                 client->parser_state = MQTT_PARSER_STATE_INIT;
 
                                 idx +=
@@ -743,11 +1843,18 @@ prv_mqtt_parse_incoming(lwgsm_mqtt_client_p client, lwgsm_pbuf_p pbuf) {
                     break;
                 }
                 case MQTT_PARSER_STATE_READ_REM: { /* Read remaining bytes and write to RX buffer */
-                    /* Process only if rx buff length is big enough */
+                    size_t chunk, tocopy;
+
+                    /* Consume entire linear run belonging to current packet at once */
+                    chunk = LWGSM_MIN(buff_len - idx, client->msg_rem_len - client->msg_curr_pos);
+
+                    /* Copy only part that fits to rx buffer */
                     if (client->msg_curr_pos < client->rx_buff_len) {
-                        client->rx_buff[client->msg_curr_pos] = ch; /* Write received character */
+                        tocopy = LWGSM_MIN(chunk, client->rx_buff_len - client->msg_curr_pos);
+                        LWGSM_MEMCPY(&client->rx_buff[client->msg_curr_pos], &d[idx], tocopy);
                     }
-                    ++client->msg_curr_pos;
+                    client->msg_curr_pos += (uint32_t)chunk;
+                    idx += chunk - 1; /* Skip copied data, idx is increased again in for loop */
 
                     /* We reached end of received characters? */
                     if (client->msg_curr_pos == client->msg_rem_len) {
@@ -787,9 +1894,29 @@ prv_mqtt_parse_incoming(lwgsm_mqtt_client_p client, lwgsm_pbuf_p pbuf) {
 static void
 prv_mqtt_connected_cb(lwgsm_mqtt_client_p client) {
     uint16_t rem_len, len_id, len_pass = 0, len_user = 0, len_will_topic = 0, len_will_message = 0;
-    uint8_t flags = 0;
+    uint8_t flags = 0, version = MQTT_PROTOCOL_V311;
+#if LWGSM_CFG_MQTT_V5
+    uint32_t len_props = 0, max_packet_size = 0;
+#endif /* LWGSM_CFG_MQTT_V5 */
 
-    flags |= MQTT_FLAG_CONNECT_CLEAN_SESSION; /* Start as clean session */
+    if (!client->info->keep_session) {
+        flags |= MQTT_FLAG_CONNECT_CLEAN_SESSION; /* Start as clean session */
+    }
+    client->keep_alive = client->info->keep_alive;
+
+#if LWGSM_CFG_MQTT_V5
+    /* Limits of MQTT 3.1.1, until CONNACK properties say otherwise */
+    if (client->info->protocol_version == MQTT_PROTOCOL_V5) {
+        version = MQTT_PROTOCOL_V5;
+    }
+    client->version = version;
+    client->max_qos = LWGSM_U8(LWGSM_MQTT_QOS_EXACTLY_ONCE);
+    client->retain_available = 1;
+    client->recv_max = 0xFFFF;
+    client->max_packet_size = 0;
+    client->topic_alias_max = 0; /* Aliases are valid for single connection only */
+    LWGSM_MEMSET(client->topic_aliases, 0x00, sizeof(client->topic_aliases));
+#endif /* LWGSM_CFG_MQTT_V5 */
 
     /*
      * Remaining length consist of fixed header data
@@ -811,6 +1938,9 @@ prv_mqtt_connected_cb(lwgsm_mqtt_client_p client) {
 
         rem_len += len_will_topic + 2;   /* Add will topic parameter */
         rem_len += len_will_message + 2; /* Add will message parameter */
+        if (MQTT_IS_V5(client)) {
+            rem_len += 1; /* Empty will properties */
+        }
     }
 
     if (client->info->user != NULL) {        /* Check for username */
@@ -827,6 +1957,18 @@ prv_mqtt_connected_cb(lwgsm_mqtt_client_p client) {
         rem_len += len_pass + 2;                          /* Add password length including length entries */
     }
 
+#if LWGSM_CFG_MQTT_V5
+    if (MQTT_IS_V5(client)) {
+        /* Server must not send packets that do not fit to RX buffer */
+        max_packet_size = LWGSM_U32(client->rx_buff_len) + 1 + prv_varint_len(LWGSM_U32(client->rx_buff_len));
+        len_props = 5; /* Maximum packet size */
+        if (!(flags & MQTT_FLAG_CONNECT_CLEAN_SESSION)) {
+            len_props += 5; /* Session expiry interval */
+        }
+        rem_len += LWGSM_U16(prv_varint_len(len_props) + len_props);
+    }
+#endif /* LWGSM_CFG_MQTT_V5 */
+
     if (!prv_output_check_enough_memory(client, rem_len)) { /* Is there enough memory to write everything? */
         return;
     }
@@ -834,11 +1976,25 @@ prv_mqtt_connected_cb(lwgsm_mqtt_client_p client) {
     /* Write everything to output buffer */
     prv_write_fixed_header(client, MQTT_MSG_TYPE_CONNECT, 0, (lwgsm_mqtt_qos_t)0, 0, rem_len);
     prv_write_string(client, "MQTT", 4);                                    /* Protocol name */
-    prv_write_u8(client, 4);                                                /* Protocol version */
+    prv_write_u8(client, version);                                          /* Protocol version */
     prv_write_u8(client, flags);                                            /* Flags for CONNECT message */
     prv_write_u16(client, client->info->keep_alive);                        /* Keep alive timeout in units of seconds */
+#if LWGSM_CFG_MQTT_V5
+    if (MQTT_IS_V5(client)) {
+        prv_write_varint(client, len_props);
+        prv_write_u8(client, MQTT_PROP_MAX_PACKET_SIZE);
+        prv_write_u32(client, max_packet_size);
+        if (!(flags & MQTT_FLAG_CONNECT_CLEAN_SESSION)) {
+            prv_write_u8(client, MQTT_PROP_SESSION_EXPIRY);
+            prv_write_u32(client, 0xFFFFFFFF); /* Session does not expire */
+        }
+    }
+#endif /* LWGSM_CFG_MQTT_V5 */
     prv_write_string(client, client->info->id, len_id);                     /* This is client ID string */
     if (flags & MQTT_FLAG_CONNECT_WILL) {                                   /* Check for will topic */
+        if (MQTT_IS_V5(client)) {
+            prv_write_u8(client, 0); /* Empty will properties */
+        }
         prv_write_string(client, client->info->will_topic, len_will_topic); /* Write topic to packet */
         prv_write_string(client, client->info->will_message, len_will_message); /* Write message to packet */
     }
@@ -867,6 +2023,9 @@ static uint8_t
 prv_mqtt_data_recv_cb(lwgsm_mqtt_client_p client, lwgsm_pbuf_p pbuf) {
     prv_mqtt_parse_incoming(client, pbuf); /* We need to process incoming data */
     lwgsm_conn_recved(client->conn, pbuf); /* Notify stack about received data */
+#if LWGSM_CFG_MQTT_QUEUE
+    prv_queue_drain(client); /* Acknowledged messages make space for next ones */
+#endif /* LWGSM_CFG_MQTT_QUEUE */
     return 1;
 }
 
@@ -881,7 +2040,9 @@ static uint8_t
 prv_mqtt_data_sent_cb(lwgsm_mqtt_client_p client, size_t sent_len, uint8_t successful) {
     lwgsm_mqtt_request_t* request;
 
-    client->is_sending = 0; /* We are not sending anymore */
+    if (client->sends_in_flight > 0) {
+        --client->sends_in_flight; /* Segments complete in submission order */
+    }
     client->sent_total += sent_len;
 
     client->poll_time = 0; /* Reset kep alive time */
@@ -897,7 +2058,7 @@ prv_mqtt_data_sent_cb(lwgsm_mqtt_client_p client, size_t sent_len, uint8_t succe
                      "[LWGSM MQTT] Failed to send %d bytes. Manually closing down..\r\n", (int)sent_len);
         return 0;
     }
-    lwgsm_buff_skip(&client->tx_buff, sent_len); /* Skip buffer for actual sent data */
+    lwgsm_buff_read_advance(&client->tx_buff, sent_len); /* Release buffer for actual sent data */
 
     /*
      * Check pending publish requests without QoS because there is no confirmation received by server.
@@ -905,10 +2066,14 @@ prv_mqtt_data_sent_cb(lwgsm_mqtt_client_p client, size_t sent_len, uint8_t succe
      *
      * Requests without QoS have packet id set to 0
      */
-    while ((request = prv_request_get_pending(client, 0)) != NULL && client->sent_total >= request->expected_sent_len) {
+    while ((request = prv_request_get_sent(client)) != NULL) {
         void* arg = request->arg;
+        uint8_t queued = prv_request_queue_ack(client, request, lwgsmOK);
 
         prv_request_delete(client, request); /* Delete request and make space for next command */
+        if (queued) {
+            continue;
+        }
 
         /* Call published callback */
         client->evt.type = LWGSM_MQTT_EVT_PUBLISH;
@@ -916,6 +2081,10 @@ prv_mqtt_data_sent_cb(lwgsm_mqtt_client_p client, size_t sent_len, uint8_t succe
         client->evt.evt.publish.res = lwgsmOK;
         client->evt_fn(client, &client->evt);
     }
+    prv_stream_write(client); /* Continue with streamed payload first */
+#if LWGSM_CFG_MQTT_QUEUE
+    prv_queue_drain(client);
+#endif /* LWGSM_CFG_MQTT_QUEUE */
     prv_send_data(client); /* Try to send more */
     return 1;
 }
@@ -937,29 +2106,33 @@ prv_mqtt_poll_cb(lwgsm_mqtt_client_p client) {
     /*
      * Check for keep-alive time if equal or greater than
      * keep alive time. In that case, send packet
-     * to make sure we are still alive
+     * to make sure we are still alive.
+     * It stays due until written after streamed payload or when TX buffer has space
      */
-    if (client->info->keep_alive /* Keep alive must be enabled */
-        /* Poll time is in units of LWGSM_CFG_CONN_POLL_INTERVAL milliseconds,
-           while keep_alive is in units of seconds */
-        && (client->poll_time * LWGSM_CFG_CONN_POLL_INTERVAL) >= (uint32_t)(client->info->keep_alive * 1000)) {
-
-        if (prv_output_check_enough_memory(client, 0)) { /* Check if memory available in output buffer */
-            prv_write_fixed_header(client, MQTT_MSG_TYPE_PINGREQ, 0, (lwgsm_mqtt_qos_t)0, 0,
-                                   0); /* Write PINGREQ command to output buffer */
-            prv_send_data(client);     /* Force send data */
-            client->poll_time = 0;     /* Reset polling time */
-
-            LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] Sending PINGREQ packet\r\n");
+    if (prv_keep_alive_due(client)) {
+        if (prv_write_pingreq(client)) {
+            prv_send_data(client); /* Force send data */
         } else {
-            LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE_WARNING, "[LWGSM MQTT] No memory to send PINGREQ packet\r\n");
+            LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] PINGREQ pending until TX buffer is available\r\n");
         }
     }
 
+#if LWGSM_CFG_MQTT_RETRANSMIT
     /*
      * Process all active packets and
      * check for timeout if there was no reply from MQTT server
      */
+    if (client->conn_state == LWGSM_MQTT_CONNECTED) {
+        prv_requests_retransmit(client);
+    }
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT */
+    if (client->stream_fn != NULL) { /* Payload callback had no data available before */
+        prv_stream_write(client);
+        prv_send_data(client);
+    }
+#if LWGSM_CFG_MQTT_QUEUE
+    prv_queue_drain(client); /* Drain rate allows new messages over time */
+#endif /* LWGSM_CFG_MQTT_QUEUE */
     return 1;
 }
 
@@ -974,6 +2147,7 @@ static uint8_t
 prv_mqtt_closed_cb(lwgsm_mqtt_client_p client, lwgsmr_t res, uint8_t forced) {
     lwgsm_mqtt_state_t state = client->conn_state;
     lwgsm_mqtt_request_t* request;
+    uint8_t keep = 0;
 
     LWGSM_UNUSED(res);
     LWGSM_UNUSED(forced);
@@ -989,17 +2163,47 @@ prv_mqtt_closed_cb(lwgsm_mqtt_client_p client, lwgsmr_t res, uint8_t forced) {
     client->evt_fn(client, &client->evt);         /* Notify upper layer about closed connection */
     client->conn = NULL;                          /* Reset connection handle */
 
+#if LWGSM_CFG_MQTT_RETRANSMIT
+    /* Unacknowledged publish packets are kept for persistent session and sent again after reconnection */
+    keep = client->info != NULL && client->info->keep_session;
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT */
+
     /* Check all requests */
-    while ((request = prv_request_get_pending(client, -1)) != NULL) {
-        uint8_t status = request->status;
-        void* arg = request->arg;
+    for (size_t i = 0; i < client->requests_size; ++i) {
+        uint8_t status, queued;
+        void* arg;
 
-        prv_request_delete(client, request);                /* Delete request */
-        prv_request_send_err_callback(client, status, arg); /* Send error callback to user */
+        request = &client->requests[i];
+        if (!(request->status & MQTT_REQUEST_FLAG_PENDING)) {
+            continue;
+        }
+#if LWGSM_CFG_MQTT_RETRANSMIT
+        /* Streamed publish has no packet copy and is not sent again */
+        if (keep && request->packet_id != 0
+            && !(request->status
+                 & (MQTT_REQUEST_FLAG_SUBSCRIBE | MQTT_REQUEST_FLAG_UNSUBSCRIBE | MQTT_REQUEST_FLAG_QUEUE))
+            && (request->packet != NULL || (request->status & MQTT_REQUEST_FLAG_PUBREL))) {
+            request->status |= MQTT_REQUEST_FLAG_RESEND;
+            continue;
+        }
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT */
+        status = request->status;
+        arg = request->arg;
+        queued = prv_request_queue_ack(client, request, lwgsmERR); /* Message stays in queue, sent again */
+        prv_request_delete(client, request);                       /* Delete request */
+        if (!queued) {
+            prv_request_send_err_callback(client, status, arg, lwgsmERR); /* Send error callback to user */
+        }
+    }
+    if (!keep) {
+        prv_requests_reset(client);
     }
-    LWGSM_MEMSET(client->requests, 0x00, sizeof(client->requests));
 
-    client->is_sending = client->sent_total = client->written_total = 0;
+    client->sends_in_flight = 0;
+    client->sent_total = client->written_total = 0;
+    client->stream_fn = NULL; /* Incomplete streaming publish is dropped with TX buffer */
+    client->resp_pending_cnt = 0;
+    client->resp_pending_r = 0;
     client->parser_state = MQTT_PARSER_STATE_INIT;
     lwgsm_buff_reset(&client->tx_buff); /* Reset TX buffer */
 
@@ -1086,28 +2290,94 @@ prv_mqtt_conn_cb(lwgsm_evt_t* evt) {
 
 /**
  * \brief           Allocate a new MQTT client structure
+ * \note            Client supports up to \ref LWGSM_CFG_MQTT_MAX_REQUESTS requests in flight
  * \param[in]       tx_buff_len: Length of raw data output buffer
  * \param[in]       rx_buff_len: Length of raw data input buffer
  * \return          Pointer to new allocated MQTT client structure or `NULL` on failure
  */
 lwgsm_mqtt_client_t*
 lwgsm_mqtt_client_new(size_t tx_buff_len, size_t rx_buff_len) {
+    return lwgsm_mqtt_client_new_ex(tx_buff_len, rx_buff_len, LWGSM_CFG_MQTT_MAX_REQUESTS);
+}
+
+/**
+ * \brief           Allocate a new MQTT client structure with custom number of requests
+ *
+ * Request is used for every subscribe, unsubscribe and publish with QoS `1` or `2` until acknowledged by server,
+ * and for every publish with QoS `0` until it is sent. Lookup by packet ID takes constant time,
+ * regardless of number of requests.
+ *
+ * \param[in]       tx_buff_len: Length of raw data output buffer
+ * \param[in]       rx_buff_len: Length of raw data input buffer
+ * \param[in]       max_requests: Maximal number of requests in flight, up to `32767`.
+ *                      When \ref LWGSM_CFG_STATIC_ALLOC is enabled, it must not exceed \ref LWGSM_CFG_MQTT_MAX_REQUESTS
+ * \return          Pointer to new allocated MQTT client structure or `NULL` on failure
+ */
+lwgsm_mqtt_client_t*
+lwgsm_mqtt_client_new_ex(size_t tx_buff_len, size_t rx_buff_len, size_t max_requests) {
     lwgsm_mqtt_client_p client;
+    uint8_t* req_mem = NULL;
+    size_t idx_size;
+
+    if (max_requests == 0 || max_requests > 0x7FFF) {
+        return NULL;
+    }
+    /* Index table is at least twice as big, to keep probe sequences short */
+    for (idx_size = 2; idx_size < 2 * max_requests; idx_size <<= 1) {}
 
-    if ((client = lwgsm_mem_calloc(1, sizeof(*client))) != NULL) {
+#if LWGSM_CFG_STATIC_ALLOC
+    if (tx_buff_len == 0 || tx_buff_len > LWGSM_CFG_STATIC_MQTT_TX_BUFF_LEN
+        || rx_buff_len > LWGSM_CFG_STATIC_MQTT_RX_BUFF_LEN || max_requests > LWGSM_CFG_MQTT_MAX_REQUESTS) {
+        return NULL;
+    }
+    if ((client = lwgsmi_mem_pool_alloc(&lwgsmi_mqtt_client_pool)) != NULL) {
         client->conn_state = LWGSM_MQTT_CONN_DISCONNECTED; /* Set to disconnected mode */
 
-        if (!lwgsm_buff_init(&client->tx_buff, tx_buff_len)) {
-            lwgsm_mem_free_s((void**)&client);
-        }
-        if (client != NULL) {
-            client->rx_buff_len = rx_buff_len;
-            if ((client->rx_buff = lwgsm_mem_malloc(rx_buff_len)) == NULL) {
-                lwgsm_buff_free(&client->tx_buff);
-                lwgsm_mem_free_s((void**)&client);
-            }
+        /* Requests and buffers are part of the same pool block */
+        req_mem = (uint8_t*)client + MQTT_CLIENT_REQUESTS_OFFSET;
+        client->tx_buff.buff = (uint8_t*)client + MQTT_CLIENT_TX_BUFF_OFFSET;
+#if LWGSM_CFG_BUFF_POW2
+        /* Size must be power of 2, full block is available anyway */
+        client->tx_buff.size = LWGSM_CFG_STATIC_MQTT_TX_BUFF_LEN;
+#else  /* LWGSM_CFG_BUFF_POW2 */
+        client->tx_buff.size = tx_buff_len;
+#endif /* !LWGSM_CFG_BUFF_POW2 */
+        client->rx_buff = (uint8_t*)client + MQTT_CLIENT_RX_BUFF_OFFSET;
+        client->rx_buff_len = rx_buff_len;
+    }
+#else  /* LWGSM_CFG_STATIC_ALLOC */
+    if (tx_buff_len == 0) {
+        return NULL;
+    }
+    if ((client = lwgsm_mem_calloc_tag(LWGSM_MEM_TAG_MQTT, 1, sizeof(*client))) != NULL) {
+        client->conn_state = LWGSM_MQTT_CONN_DISCONNECTED; /* Set to disconnected mode */
+        client->rx_buff_len = rx_buff_len;
+
+        /* TX buffer memory is allocated here, to be accounted to MQTT memory budget */
+#if LWGSM_CFG_BUFF_POW2
+        for (client->tx_buff.size = 1; client->tx_buff.size < tx_buff_len; client->tx_buff.size <<= 1) {}
+#else  /* LWGSM_CFG_BUFF_POW2 */
+        client->tx_buff.size = tx_buff_len;
+#endif /* !LWGSM_CFG_BUFF_POW2 */
+        if ((client->tx_buff.buff = lwgsm_mem_malloc_tag(LWGSM_MEM_TAG_MQTT, client->tx_buff.size)) == NULL
+            || (client->rx_buff = lwgsm_mem_malloc_tag(LWGSM_MEM_TAG_MQTT, rx_buff_len)) == NULL
+            || (req_mem = lwgsm_mem_malloc_tag(LWGSM_MEM_TAG_MQTT, MQTT_REQUESTS_MEM_SIZE(max_requests, idx_size)))
+                   == NULL) {
+            lwgsm_mem_free_tag_s((void**)&client->rx_buff);
+            lwgsm_mem_free_tag_s((void**)&client->tx_buff.buff);
+            lwgsm_mem_free_tag_s((void**)&client);
         }
     }
+#endif /* !LWGSM_CFG_STATIC_ALLOC */
+    if (client != NULL) {
+        client->requests = (void*)req_mem;
+        client->requests_free = (void*)(req_mem + LWGSM_MEM_ALIGN(max_requests * sizeof(*client->requests)));
+        client->requests_fifo = client->requests_free + max_requests;
+        client->requests_idx = client->requests_fifo + max_requests;
+        client->requests_size = LWGSM_U16(max_requests);
+        client->requests_idx_mask = LWGSM_U16(idx_size - 1);
+        prv_requests_reset(client);
+    }
     return client;
 }
 
@@ -1119,10 +2389,44 @@ lwgsm_mqtt_client_new(size_t tx_buff_len, size_t rx_buff_len) {
 void
 lwgsm_mqtt_client_delete(lwgsm_mqtt_client_p client) {
     if (client != NULL) {
-        lwgsm_mem_free_s((void**)&client->rx_buff);
-        lwgsm_buff_free(&client->tx_buff);
-        lwgsm_mem_free_s((void**)&client);
+#if LWGSM_CFG_MQTT_RETRANSMIT
+        /* Release packet copies, kept for persistent session */
+        for (size_t i = 0; i < client->requests_size; ++i) {
+            MQTT_RETX_FREE_S(client->requests[i].packet);
+        }
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT */
+#if LWGSM_CFG_MQTT_ROUTER
+        lwgsmi_mqtt_router_free(&client->router);
+#endif /* LWGSM_CFG_MQTT_ROUTER */
+#if LWGSM_CFG_STATIC_ALLOC
+        lwgsmi_mem_pool_free(&lwgsmi_mqtt_client_pool, client);
+#else  /* LWGSM_CFG_STATIC_ALLOC */
+        lwgsm_mem_free_tag_s((void**)&client->requests);
+        lwgsm_mem_free_tag_s((void**)&client->rx_buff);
+        lwgsm_mem_free_tag_s((void**)&client->tx_buff.buff);
+        lwgsm_mem_free_tag_s((void**)&client);
+#endif /* !LWGSM_CFG_STATIC_ALLOC */
+    }
+}
+
+/**
+ * \brief           Get statistics of MQTT request table
+ * \param[in]       client: MQTT client
+ * \param[out]      stats: Pointer to output structure to fill
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_mqtt_client_get_request_stats(lwgsm_mqtt_client_p client, lwgsm_mqtt_request_stats_t* stats) {
+    if (client == NULL || stats == NULL) {
+        return lwgsmERRPAR;
     }
+    lwgsm_core_lock();
+    stats->size = client->requests_size;
+    stats->used = client->requests_size - client->requests_free_cnt;
+    stats->max_used = client->requests_max_used;
+    stats->failed = client->requests_failed;
+    lwgsm_core_unlock();
+    return lwgsmOK;
 }
 
 /**
@@ -1204,78 +2508,399 @@ lwgsm_mqtt_client_unsubscribe(lwgsm_mqtt_client_p client, const char* topic, voi
 }
 
 /**
- * \brief           Publish a new message on specific topic
+ * \brief           Write publish packet to TX buffer and create request for it
+ * \note            Client must be connected. Data are not sent, \ref prv_send_data must be called after
  * \param[in]       client: MQTT client
  * \param[in]       topic: Topic to send message to
  * \param[in]       payload: Message data
  * \param[in]       payload_len: Length of payload data
- * \param[in]       qos: Quality of service. This parameter can be a value of \ref lwgsm_mqtt_qos_t enumeration
- * \param[in]       retain: Retian parameter value
+ * \param[in]       qos: Quality of service
+ * \param[in]       retain: Retain parameter value
+ * \param[in]       payload_fn: Payload callback for streaming publish, `payload` is not used when set.
+ *                      Set to `NULL` to write `payload` to TX buffer at once
  * \param[in]       arg: User custom argument used in callback
  * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
  */
-lwgsmr_t
-lwgsm_mqtt_client_publish(lwgsm_mqtt_client_p client, const char* topic, const void* payload, uint16_t payload_len,
-                          lwgsm_mqtt_qos_t qos, uint8_t retain, void* arg) {
-    lwgsmr_t res = lwgsmOK;
+static lwgsmr_t
+prv_publish_write(lwgsm_mqtt_client_p client, const char* topic, const void* payload, uint32_t payload_len,
+                  lwgsm_mqtt_qos_t qos, uint8_t retain, lwgsm_mqtt_client_payload_fn payload_fn, void* arg) {
     lwgsm_mqtt_request_t* request = NULL;
     uint32_t rem_len, raw_len;
-    uint16_t len_topic, pkt_id;
+    uint16_t len_topic, len_topic_sent, pkt_id;
     uint8_t qos_u8 = LWGSM_U8(qos);
+#if LWGSM_CFG_MQTT_V5
+    uint16_t alias = 0;
+    uint8_t alias_known = 0;
+#endif /* LWGSM_CFG_MQTT_V5 */
 
     if ((len_topic = LWGSM_U16(strlen(topic))) == 0) { /* Topic length */
         return lwgsmERR;
     }
+    len_topic_sent = len_topic;
+#if LWGSM_CFG_MQTT_V5
+    if (MQTT_IS_V5(client)) {
+        if (qos_u8 > client->max_qos || (retain && !client->retain_available)) {
+            LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] QoS or retain not supported by server\r\n");
+            return lwgsmERRPAR;
+        }
+        if (qos_u8 > 0 && client->pub_in_flight >= client->recv_max) {
+            LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] Server receive maximum reached\r\n");
+            return lwgsmERRMEM;
+        }
+#if LWGSM_CFG_MQTT_RETRANSMIT
+        /* Stored packet may be retransmitted on new connection, where aliases are not valid anymore */
+        if (qos_u8 == 0)
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT */
+        {
+            alias = prv_topic_alias_select(client, topic, len_topic, &alias_known);
+            if (alias_known) {
+                len_topic_sent = 0; /* Server knows topic for this alias */
+            }
+        }
+    }
+#endif /* LWGSM_CFG_MQTT_V5 */
 
     /*
      * Calculate remaining length of packet
      *
      * rem_len = 2 (topic_len) + topic_len + payload_len + 2 (pkt_id, only if qos > 0)
+     *              + properties (only if MQTT 5.0)
+     */
+    rem_len = 2 + len_topic_sent + (payload != NULL || payload_fn != NULL ? payload_len : 0) + (qos_u8 > 0 ? 2 : 0);
+#if LWGSM_CFG_MQTT_V5
+    if (MQTT_IS_V5(client)) {
+        rem_len += 1 + (alias != 0 ? 3 : 0); /* Properties length and optional topic alias */
+    }
+#endif /* LWGSM_CFG_MQTT_V5 */
+
+    if (payload_fn != NULL) {
+        if (payload_len > MQTT_MAX_REM_LEN || rem_len > MQTT_MAX_REM_LEN) {
+            return lwgsmERRPAR;
+        }
+
+        /* Only headers must fit to TX buffer, payload is written as buffer drains */
+        raw_len = prv_packet_raw_len(rem_len);
+        if (client->stream_fn != NULL || lwgsm_buff_get_free(&client->tx_buff) < raw_len - payload_len) {
+            LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] Not enough memory to publish message\r\n");
+            return lwgsmERRMEM;
+        }
+    } else if ((raw_len = prv_output_check_enough_memory(client, rem_len)) == 0) {
+        LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] Not enough memory to publish message\r\n");
+        return lwgsmERRMEM;
+    }
+#if LWGSM_CFG_MQTT_V5
+    if (MQTT_IS_V5(client) && client->max_packet_size > 0 && raw_len > client->max_packet_size) {
+        LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] Message exceeds server maximum packet size\r\n");
+        return lwgsmERRPAR;
+    }
+#endif /* LWGSM_CFG_MQTT_V5 */
+    pkt_id = qos_u8 > 0 ? prv_create_packet_id(client) : 0; /* Create new packet ID */
+    request = prv_request_create(client, pkt_id, arg);      /* Create request for packet */
+#if LWGSM_CFG_MQTT_RETRANSMIT
+    /* Streamed payload is not kept, such packet is not sent again */
+    if (request != NULL && pkt_id != 0 && payload_fn == NULL
+        && !prv_request_packet_alloc(request, raw_len)) {
+        prv_request_delete(client, request);
+        request = NULL;
+    }
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT */
+    if (request == NULL) {
+        LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] No free request available to publish message\r\n");
+        return lwgsmERRMEM;
+    }
+
+    /*
+     * Set expected number of bytes we should send before
+     * we can say that this packet was sent.
+     * Used in case QoS is set to 0 where packet notification
+     * is not received by server. In this case, wait
+     * number of bytes sent before notifying user about success.
+     *
+     * All data currently in TX buffer (in flight or not yet submitted)
+     * are sent before this packet
      */
-    rem_len = 2 + len_topic + (payload != NULL ? payload_len : 0) + (qos_u8 > 0 ? 2 : 0);
+    request->expected_sent_len = client->sent_total + LWGSM_U32(lwgsm_buff_get_full(&client->tx_buff)) + raw_len;
+
+    prv_write_fixed_header(client, MQTT_MSG_TYPE_PUBLISH, 0,
+                           (lwgsm_mqtt_qos_t)LWGSM_MIN(qos_u8, LWGSM_U8(LWGSM_MQTT_QOS_EXACTLY_ONCE)), retain, rem_len);
+    prv_write_string(client, topic, len_topic_sent); /* Write topic string to packet */
+    if (qos_u8) {
+        prv_write_u16(client, pkt_id); /* Write packet ID */
+    }
+#if LWGSM_CFG_MQTT_V5
+    if (MQTT_IS_V5(client)) {
+        prv_write_u8(client, alias != 0 ? 3 : 0); /* Properties length */
+        if (alias != 0) {
+            prv_write_u8(client, MQTT_PROP_TOPIC_ALIAS);
+            prv_write_u16(client, alias);
+        }
+        prv_topic_alias_update(client, topic, len_topic, alias, alias_known);
+        if (pkt_id != 0) {
+            request->status |= MQTT_REQUEST_FLAG_PUBLISH_QOS;
+            ++client->pub_in_flight;
+        }
+    }
+#endif /* LWGSM_CFG_MQTT_V5 */
+    if (payload_fn != NULL) {
+        if (payload_len > 0) { /* Payload is written with prv_stream_write */
+            client->stream_fn = payload_fn;
+            client->stream_arg = arg;
+            client->stream_len = payload_len;
+            client->stream_offset = 0;
+        }
+    } else if (payload != NULL && payload_len) {
+        prv_write_data(client, payload, payload_len); /* Write RAW topic payload */
+    }
+#if LWGSM_CFG_MQTT_RETRANSMIT
+    if (pkt_id != 0 && payload_fn == NULL) {
+        prv_request_packet_store(client, request);
+    }
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT */
+    prv_request_set_pending(client, request); /* Set request as pending waiting for server reply */
+    LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] Pkt publish start. QoS: %d, pkt_id: %d\r\n", (int)qos_u8,
+                 (int)pkt_id);
+    return lwgsmOK;
+}
+
+/**
+ * \brief           Publish a new message on specific topic
+ * \note            When queue is set with \ref lwgsm_mqtt_client_set_queue, message is stored to the queue
+ *                  and sent from there, also when client is not connected.
+ *                  `arg` is then ignored and no \ref LWGSM_MQTT_EVT_PUBLISH event is sent
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic to send message to
+ * \param[in]       payload: Message data
+ * \param[in]       payload_len: Length of payload data
+ * \param[in]       qos: Quality of service. This parameter can be a value of \ref lwgsm_mqtt_qos_t enumeration
+ * \param[in]       retain: Retian parameter value
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_mqtt_client_publish(lwgsm_mqtt_client_p client, const char* topic, const void* payload, uint16_t payload_len,
+                          lwgsm_mqtt_qos_t qos, uint8_t retain, void* arg) {
+    const lwgsm_mqtt_client_publish_msg_t msg = {
+        .topic = topic,
+        .payload = payload,
+        .payload_len = payload_len,
+        .qos = qos,
+        .retain = retain,
+        .arg = arg,
+    };
+
+    return lwgsm_mqtt_client_publish_batch(client, &msg, 1, NULL);
+}
+
+/**
+ * \brief           Publish multiple messages with single transmission
+ *
+ * All packets are written to TX buffer first and sent together,
+ * instead of starting new send command for every message.
+ * \ref LWGSM_MQTT_EVT_PUBLISH event is sent for every accepted message, with its own argument.
+ *
+ * Messages are accepted in order. When one cannot be accepted, for example because TX buffer is full,
+ * remaining messages are not processed and messages before it are still sent.
+ *
+ * \note            When queue is set with \ref lwgsm_mqtt_client_set_queue, messages are stored to the queue
+ *                  and sent from there, also when client is not connected.
+ *                  `arg` member of messages is then ignored and no \ref LWGSM_MQTT_EVT_PUBLISH event is sent
+ * \param[in]       client: MQTT client
+ * \param[in]       msgs: Array of messages to publish
+ * \param[in]       msgs_len: Number of messages in array
+ * \param[out]      published: Pointer to output variable to save number of accepted messages. Can be set to `NULL`
+ * \return          \ref lwgsmOK when all messages are accepted, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_mqtt_client_publish_batch(lwgsm_mqtt_client_p client, const lwgsm_mqtt_client_publish_msg_t* msgs,
+                                size_t msgs_len, size_t* published) {
+    lwgsmr_t res = lwgsmOK;
+    size_t i = 0;
+#if LWGSM_CFG_MQTT_QUEUE
+    lwgsm_mqtt_queue_t* queue;
+#endif /* LWGSM_CFG_MQTT_QUEUE */
+
+    LWGSM_ASSERT(client != NULL);
+    LWGSM_ASSERT(msgs != NULL || msgs_len == 0);
 
+#if LWGSM_CFG_MQTT_QUEUE
     lwgsm_core_lock();
-    if (client->conn_state != LWGSM_MQTT_CONNECTED) {
-        res = lwgsmCLOSED;
-    } else if ((raw_len = prv_output_check_enough_memory(client, rem_len)) != 0) {
-        pkt_id = qos_u8 > 0 ? prv_create_packet_id(client) : 0; /* Create new packet ID */
-        request = prv_request_create(client, pkt_id, arg);      /* Create request for packet */
-        if (request != NULL) {
-            /*
-             * Set expected number of bytes we should send before
-             * we can say that this packet was sent.
-             * Used in case QoS is set to 0 where packet notification
-             * is not received by server. In this case, wait
-             * number of bytes sent before notifying user about success
-             */
-            request->expected_sent_len = client->written_total + raw_len;
+    queue = client->queue;
+    lwgsm_core_unlock();
 
-            prv_write_fixed_header(client, MQTT_MSG_TYPE_PUBLISH, 0,
-                                   (lwgsm_mqtt_qos_t)LWGSM_MIN(qos_u8, LWGSM_U8(LWGSM_MQTT_QOS_EXACTLY_ONCE)), retain,
-                                   rem_len);
-            prv_write_string(client, topic, len_topic); /* Write topic string to packet */
-            if (qos_u8) {
-                prv_write_u16(client, pkt_id); /* Write packet ID */
+    /* Messages are stored first and removed from queue once acknowledged */
+    if (queue != NULL) {
+        for (; i < msgs_len; ++i) { /* Storage is written without core lock */
+            if ((res = lwgsm_mqtt_queue_append(queue, msgs[i].topic, msgs[i].payload, msgs[i].payload_len,
+                                               msgs[i].qos, msgs[i].retain))
+                != lwgsmOK) {
+                break;
             }
-            if (payload != NULL && payload_len) {
-                prv_write_data(client, payload, payload_len); /* Write RAW topic payload */
-            }
-            prv_request_set_pending(client, request); /* Set request as pending waiting for server reply */
-            prv_send_data(client);                    /* Try to send data */
-            LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] Pkt publish start. QoS: %d, pkt_id: %d\r\n",
-                         (int)qos_u8, (int)pkt_id);
-        } else {
-            LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] No free request available to publish message\r\n");
-            res = lwgsmERRMEM;
         }
+        lwgsm_core_lock();
+        prv_queue_drain(client);
+        lwgsm_core_unlock();
+        if (published != NULL) {
+            *published = i;
+        }
+        return res;
+    }
+#endif /* LWGSM_CFG_MQTT_QUEUE */
+    lwgsm_core_lock();
+    if (client->conn_state != LWGSM_MQTT_CONNECTED) {
+        res = lwgsmCLOSED;
     } else {
-        LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT] Not enough memory to publish message\r\n");
-        res = lwgsmERRMEM;
+        for (; i < msgs_len; ++i) {
+            if ((res = prv_publish_write(client, msgs[i].topic, msgs[i].payload, msgs[i].payload_len, msgs[i].qos,
+                                         msgs[i].retain, NULL, msgs[i].arg))
+                != lwgsmOK) {
+                break;
+            }
+        }
+        if (i > 0) {
+            prv_send_data(client); /* Send all written packets together */
+        }
+    }
+    lwgsm_core_unlock();
+    if (published != NULL) {
+        *published = i;
+    }
+    return res;
+}
+
+/**
+ * \brief           Publish a new message with payload provided by callback while it is being sent
+ *
+ * Only packet headers must fit to TX buffer. Payload is requested from `payload_fn`
+ * in chunks as TX buffer drains, so message can be much longer than TX buffer.
+ * Other packets are not written to TX buffer until entire payload is written.
+ *
+ * \note            Message is not stored to store-and-forward queue and it is not sent again
+ *                  by \ref LWGSM_CFG_MQTT_RETRANSMIT, as its payload is not kept by client
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic to send message to
+ * \param[in]       payload_len: Length of payload data
+ * \param[in]       qos: Quality of service. This parameter can be a value of \ref lwgsm_mqtt_qos_t enumeration
+ * \param[in]       retain: Retain parameter value
+ * \param[in]       payload_fn: Payload callback function
+ * \param[in]       arg: User custom argument used in payload callback and publish event
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_mqtt_client_publish_stream(lwgsm_mqtt_client_p client, const char* topic, uint32_t payload_len,
+                                 lwgsm_mqtt_qos_t qos, uint8_t retain, lwgsm_mqtt_client_payload_fn payload_fn,
+                                 void* arg) {
+    lwgsmr_t res;
+
+    LWGSM_ASSERT(client != NULL);
+    LWGSM_ASSERT(topic != NULL);
+    LWGSM_ASSERT(payload_fn != NULL);
+
+    lwgsm_core_lock();
+    if (client->conn_state != LWGSM_MQTT_CONNECTED) {
+        res = lwgsmCLOSED;
+    } else if ((res = prv_publish_write(client, topic, NULL, payload_len, qos, retain, payload_fn, arg)) == lwgsmOK) {
+        prv_stream_write(client);
+        prv_send_data(client);
+    }
+    lwgsm_core_unlock();
+    return res;
+}
+
+#if LWGSM_CFG_MQTT_QUEUE || __DOXYGEN__
+
+/**
+ * \brief           Set store-and-forward queue for messages published while client is not connected
+ *
+ * With queue set, \ref lwgsm_mqtt_client_publish stores every message in the queue, also when client
+ * is not connected. Messages are sent in order and removed once acknowledged, so that no message is lost
+ * when connection drops while it is in flight. No \ref LWGSM_MQTT_EVT_PUBLISH event is sent
+ * for messages stored in the queue.
+ *
+ * Messages which do not fit to client TX buffer are refused by \ref lwgsm_mqtt_queue_append.
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       queue: Initialized queue or `NULL` to disable it
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_mqtt_client_set_queue(lwgsm_mqtt_client_p client, lwgsm_mqtt_queue_t* queue) {
+    uint32_t rem_len;
+
+    LWGSM_ASSERT(client != NULL);
+
+    lwgsm_core_lock();
+    client->queue = queue;
+    if (queue != NULL) {
+        /* Largest packet in empty TX buffer, with packet ID and MQTT 5.0 properties */
+        rem_len = LWGSM_U32(client->tx_buff.size > 1 ? client->tx_buff.size - 1 : 0);
+        while (rem_len > 0 && prv_packet_raw_len(rem_len) > client->tx_buff.size - 1) {
+            --rem_len;
+        }
+        lwgsmi_mqtt_queue_set_max_len(queue, rem_len > 3 ? rem_len - 3 : 1);
     }
+    prv_queue_drain(client);
+    lwgsm_core_unlock();
+    return lwgsmOK;
+}
+
+#endif /* LWGSM_CFG_MQTT_QUEUE || __DOXYGEN__ */
+
+#if LWGSM_CFG_MQTT_ROUTER || __DOXYGEN__
+
+/**
+ * \brief           Register handler for received messages on topic filter
+ *
+ * Filter may use `+` wildcard for single level and `#` wildcard, as last level, for any number of levels.
+ * Wildcards on first level do not match topics starting with `$`.
+ * The same handler may be registered for multiple filters, and multiple handlers for the same filter.
+ *
+ * \note            Function does not subscribe to topic on server, use \ref lwgsm_mqtt_client_subscribe
+ * \note            Function must not be called from route handler
+ * \param[in]       client: MQTT client
+ * \param[in]       filter: Topic filter
+ * \param[in]       fn: Handler function, called for every received message with matching topic
+ * \param[in]       arg: User argument passed to handler
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_mqtt_client_route_add(lwgsm_mqtt_client_p client, const char* filter, lwgsm_mqtt_route_fn fn, void* arg) {
+    lwgsmr_t res;
+
+    LWGSM_ASSERT(client != NULL);
+    LWGSM_ASSERT(filter != NULL);
+    LWGSM_ASSERT(fn != NULL);
+
+    lwgsm_core_lock();
+    res = lwgsmi_mqtt_router_add(&client->router, filter, fn, arg);
+    lwgsm_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Remove handler registered with \ref lwgsm_mqtt_client_route_add
+ * \note            Function must not be called from route handler
+ * \param[in]       client: MQTT client
+ * \param[in]       filter: Topic filter, as used on registration
+ * \param[in]       fn: Handler function, as used on registration
+ * \param[in]       arg: User argument, as used on registration
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_mqtt_client_route_remove(lwgsm_mqtt_client_p client, const char* filter, lwgsm_mqtt_route_fn fn, void* arg) {
+    lwgsmr_t res;
+
+    LWGSM_ASSERT(client != NULL);
+    LWGSM_ASSERT(filter != NULL);
+    LWGSM_ASSERT(fn != NULL);
+
+    lwgsm_core_lock();
+    res = lwgsmi_mqtt_router_remove(&client->router, filter, fn, arg);
     lwgsm_core_unlock();
     return res;
 }
 
+#endif /* LWGSM_CFG_MQTT_ROUTER || __DOXYGEN__ */
+
 /**
  * \brief           Test if client is connected to server and accepted to MQTT protocol
  * \note            Function will return error if TCP is connected but MQTT not accepted
@@ -53,6 +53,24 @@ struct lwgsm_mqtt_client_api {
     lwgsmr_t sub_pub_resp;                 /*!< Subscribe/Unsubscribe/Publish response */
 } lwgsm_mqtt_client_api_t;
 
+#if LWGSM_CFG_STATIC_ALLOC
+LWGSM_MEM_POOL_DEFINE(lwgsmi_mqtt_api_client_pool, LWGSM_MEM_POOL_MQTT_API_CLIENT, sizeof(lwgsm_mqtt_client_api_t),
+                      LWGSM_CFG_STATIC_MQTT_CLIENT_NUM);
+LWGSM_MEM_POOL_DEFINE(lwgsmi_mqtt_api_buf_pool, LWGSM_MEM_POOL_MQTT_API_BUF, LWGSM_CFG_STATIC_MQTT_API_BUF_SIZE,
+                      LWGSM_CFG_STATIC_MQTT_API_BUF_NUM);
+#define MQTT_API_CLIENT_ALLOC()   lwgsmi_mem_pool_alloc(&lwgsmi_mqtt_api_client_pool)
+#define MQTT_API_CLIENT_FREE_S(c) lwgsmi_mem_pool_free_s(&lwgsmi_mqtt_api_client_pool, (void**)&(c))
+#define MQTT_API_BUF_ALLOC(size)                                                                                       \
+    ((size) <= LWGSM_CFG_STATIC_MQTT_API_BUF_SIZE ? lwgsmi_mem_pool_alloc(&lwgsmi_mqtt_api_buf_pool) : NULL)
+#define MQTT_API_BUF_FREE_S(b)    lwgsmi_mem_pool_free_s(&lwgsmi_mqtt_api_buf_pool, (void**)&(b))
+#else /* LWGSM_CFG_STATIC_ALLOC */
+#define MQTT_API_CLIENT_ALLOC()                                                                                        \
+    lwgsm_mem_calloc_tag(LWGSM_MEM_TAG_MQTT, 1, LWGSM_MEM_ALIGN(sizeof(lwgsm_mqtt_client_api_t)))
+#define MQTT_API_CLIENT_FREE_S(c) lwgsm_mem_free_tag_s((void**)&(c))
+#define MQTT_API_BUF_ALLOC(size)  lwgsm_mem_malloc_tag(LWGSM_MEM_TAG_MQTT, (size))
+#define MQTT_API_BUF_FREE_S(b)    lwgsm_mem_free_tag_s((void**)&(b))
+#endif /* !LWGSM_CFG_STATIC_ALLOC */
+
 /**
  * \brief           Variable used as pointer for message queue when MQTT connection is closed
  */
@@ -123,11 +141,39 @@ prv_mqtt_evt(lwgsm_mqtt_client_p client, lwgsm_mqtt_evt_t* evt) {
 
             /* Calculate memory sizes */
             buf_size = LWGSM_MEM_ALIGN(sizeof(*buf));
+#if LWGSM_CFG_MQTT_API_ZERO_COPY
+            lwgsm_pbuf_p pbuf = lwgsm_mqtt_client_evt_publish_recv_get_pbuf(client, evt);
+
+            /* Keep reference to received buffer instead of copying data */
+            if (pbuf != NULL) {
+                if ((buf = MQTT_API_BUF_ALLOC(buf_size)) != NULL) {
+                    LWGSM_MEMSET(buf, 0x00, buf_size);
+                    buf->topic = (char*)topic;
+                    buf->payload = (uint8_t*)payload;
+                    buf->topic_len = topic_len;
+                    buf->payload_len = payload_len;
+                    buf->qos = qos;
+                    buf->pbuf = pbuf;
+                    lwgsm_pbuf_ref(pbuf);
+
+                    /* Write to receive queue */
+                    if (!lwgsm_sys_mbox_putnow(&api_client->rcv_mbox, buf)) {
+                        LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_API_TRACE_WARNING,
+                                     "[MQTT API] Cannot put new received MQTT publish to queue\r\n");
+                        lwgsm_mqtt_client_api_buf_free(buf);
+                    }
+                } else {
+                    LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_API_TRACE_WARNING,
+                                 "[MQTT API] Cannot allocate memory for packet buffer\r\n");
+                }
+                break;
+            }
+#endif /* LWGSM_CFG_MQTT_API_ZERO_COPY */
             topic_size = LWGSM_MEM_ALIGN(sizeof(*topic) * (topic_len + 1));
             payload_size = LWGSM_MEM_ALIGN(sizeof(*payload) * (payload_len + 1));
 
             size = buf_size + topic_size + payload_size;
-            if ((buf = lwgsm_mem_malloc(size)) != NULL) {
+            if ((buf = MQTT_API_BUF_ALLOC(size)) != NULL) {
                 LWGSM_MEMSET(buf, 0x00, size);
                 buf->topic = (void*)((uint8_t*)buf + buf_size);
                 buf->payload = (void*)((uint8_t*)buf + buf_size + topic_size);
@@ -143,7 +189,7 @@ prv_mqtt_evt(lwgsm_mqtt_client_p client, lwgsm_mqtt_evt_t* evt) {
                 if (!lwgsm_sys_mbox_putnow(&api_client->rcv_mbox, buf)) {
                     LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_API_TRACE_WARNING,
                                  "[MQTT API] Cannot put new received MQTT publish to queue\r\n");
-                    lwgsm_mem_free_s((void**)&buf);
+                    MQTT_API_BUF_FREE_S(buf);
                 }
             } else {
                 LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_API_TRACE_WARNING,
@@ -203,7 +249,7 @@ lwgsm_mqtt_client_api_new(size_t tx_buff_len, size_t rx_buff_len) {
     lwgsm_mqtt_client_api_p client;
 
     /* Allocate client memory */
-    if ((client = lwgsm_mem_calloc(1, LWGSM_MEM_ALIGN(sizeof(*client)))) != NULL) {
+    if ((client = MQTT_API_CLIENT_ALLOC()) != NULL) {
         /* Create MQTT raw client structure */
         if ((client->mc = lwgsm_mqtt_client_new(tx_buff_len, rx_buff_len)) != NULL) {
             /* Create receive mbox queue */
@@ -265,7 +311,7 @@ lwgsm_mqtt_client_api_delete(lwgsm_mqtt_client_api_p client) {
         lwgsm_mqtt_client_delete(client->mc);
         client->mc = NULL;
     }
-    lwgsm_mem_free_s((void**)&client);
+    MQTT_API_CLIENT_FREE_S(client);
 }
 
 /**
@@ -444,6 +490,9 @@ lwgsm_mqtt_client_api_is_connected(lwgsm_mqtt_client_api_p client) {
  * \note            This function can be called from separate thread
  *                      than the rest of API function, which allows you to
  *                      handle receive data separated with custom timeout
+ * \note            When \ref LWGSM_CFG_MQTT_API_ZERO_COPY is enabled, topic and payload
+ *                      may point directly to received packet buffer and are not `NULL` terminated.
+ *                      Always use `topic_len` and `payload_len` members
  * \param[in]       client: MQTT API client handle
  * \param[in]       p: Pointer to output buffer
  * \param[in]       timeout: Maximal time to wait before function returns timeout
@@ -481,5 +530,10 @@ lwgsm_mqtt_client_api_receive(lwgsm_mqtt_client_api_p client, lwgsm_mqtt_client_
  */
 void
 lwgsm_mqtt_client_api_buf_free(lwgsm_mqtt_client_api_buf_p p) {
-    lwgsm_mem_free_s((void**)&p);
+#if LWGSM_CFG_MQTT_API_ZERO_COPY
+    if (p != NULL && p->pbuf != NULL) {
+        lwgsm_pbuf_free(p->pbuf); /* Release received packet buffer */
+    }
+#endif /* LWGSM_CFG_MQTT_API_ZERO_COPY */
+    MQTT_API_BUF_FREE_S(p);
 }
@@ -0,0 +1,797 @@
+/**
+ * \file            lwgsm_mqtt_client_queue.c
+ * \brief           Persistent store-and-forward queue for MQTT client
+ */
+
+/*
+ * Copyright (c) 2022 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGSM - Lightweight GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include "lwgsm/apps/lwgsm_mqtt_client_queue.h"
+#include "lwgsm/lwgsm_private.h"
+
+#if LWGSM_CFG_MQTT_QUEUE || __DOXYGEN__
+
+/*
+ * Record header, `16` bytes, multi-byte values in little-endian format:
+ *
+ *  - [0]       Magic byte
+ *  - [1]       Record type
+ *  - [2]       Flags, quality of service in bits `0-1` and retain in bit `2`
+ *  - [3]       Reserved, `0xFF`
+ *  - [4-5]     Length of data after header
+ *  - [6-7]     Reserved, `0xFFFF`
+ *  - [8-11]    Sequence number: of sector, of message or first not acknowledged message
+ *  - [12-15]   CRC-32 of bytes `0-11` and data
+ *
+ * Data record holds topic length in MSB first format, topic and payload, as they are sent in publish packet.
+ * Every sector starts with sector record, records never cross sector boundary.
+ */
+#define QUEUE_REC_MAGIC       0x51
+#define QUEUE_REC_SECTOR      0x01 /*!< Sector start, with sector sequence number */
+#define QUEUE_REC_DATA        0x02 /*!< Message to publish */
+#define QUEUE_REC_ACK         0x03 /*!< All messages before sequence number are acknowledged */
+#define QUEUE_HDR_SIZE        16
+#define QUEUE_CHUNK_SIZE      32 /*!< Maximal program unit and size of stack buffer for programming */
+
+/* Record status on read */
+#define QUEUE_REC_ERASED      0x00
+#define QUEUE_REC_VALID       0x01
+#define QUEUE_REC_INVALID     0x02
+
+#define QUEUE_ALIGN(q, x)     (((x) + (q)->storage->prog_size - 1) & ~((q)->storage->prog_size - 1))
+#define QUEUE_SECTOR(q, a)    ((a) - (a) % (q)->storage->sector_size)
+#define QUEUE_FIRST_REC(q, s) ((s) + QUEUE_ALIGN((q), QUEUE_HDR_SIZE))
+#define QUEUE_IS_EMPTY(q)     ((q)->tail_seq == (q)->next_seq)
+
+/* Tracing debug message */
+#define LWGSM_CFG_DBG_MQTT_TRACE         (LWGSM_CFG_DBG_MQTT | LWGSM_DBG_TYPE_TRACE)
+#define LWGSM_CFG_DBG_MQTT_TRACE_WARNING (LWGSM_CFG_DBG_MQTT | LWGSM_DBG_TYPE_TRACE | LWGSM_DBG_LVL_WARNING)
+
+/**
+ * \brief           Parsed record header
+ */
+typedef struct {
+    uint8_t type;  /*!< Record type */
+    uint8_t flags; /*!< Record flags */
+    uint16_t len;  /*!< Length of data after header */
+    uint32_t seq;  /*!< Sequence number */
+} queue_rec_t;
+
+/**
+ * \brief           Update CRC-32 value with new data
+ * \param[in]       crc: Current CRC value, `0` for start
+ * \param[in]       data: Data to process
+ * \param[in]       len: Length of data
+ * \return          New CRC value
+ */
+static uint32_t
+prv_crc32(uint32_t crc, const void* data, size_t len) {
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    const uint8_t* d = data;
+
+    crc = ~crc;
+    for (; len > 0; --len, ++d) {
+        crc = (crc >> 4) ^ table[(crc ^ *d) & 0x0F];
+        crc = (crc >> 4) ^ table[(crc ^ (*d >> 4)) & 0x0F];
+    }
+    return ~crc;
+}
+
+/**
+ * \brief           Get size of record in storage, including header and padding
+ * \param[in]       queue: Queue handle
+ * \param[in]       len: Length of record data
+ * \return          Record size in units of bytes
+ */
+static uint32_t
+prv_rec_size(lwgsm_mqtt_queue_t* queue, size_t len) {
+    return QUEUE_ALIGN(queue, QUEUE_HDR_SIZE + LWGSM_U32(len));
+}
+
+/**
+ * \brief           Read and check record at specific address
+ * \param[in]       queue: Queue handle
+ * \param[in]       addr: Record address
+ * \param[out]      rec: Output record header
+ * \param[in]       check_crc: Set to `1` to read all data and check CRC
+ * \return          Record status, `QUEUE_REC_ERASED`, `QUEUE_REC_VALID` or `QUEUE_REC_INVALID`
+ */
+static uint8_t
+prv_rec_read(lwgsm_mqtt_queue_t* queue, uint32_t addr, queue_rec_t* rec, uint8_t check_crc) {
+    const lwgsm_mqtt_queue_storage_t* st = queue->storage;
+    uint8_t hdr[QUEUE_HDR_SIZE];
+    uint32_t crc;
+    size_t i;
+
+    if (addr + QUEUE_HDR_SIZE > QUEUE_SECTOR(queue, addr) + st->sector_size
+        || st->read(st->ctx, addr, hdr, sizeof(hdr)) != lwgsmOK) {
+        return QUEUE_REC_INVALID;
+    }
+    for (i = 0; i < sizeof(hdr) && hdr[i] == 0xFF; ++i) {}
+    if (i == sizeof(hdr)) {
+        return QUEUE_REC_ERASED;
+    }
+    rec->type = hdr[1];
+    rec->flags = hdr[2];
+    rec->len = LWGSM_U16(hdr[4] | hdr[5] << 8);
+    rec->seq = LWGSM_U32(hdr[8]) | LWGSM_U32(hdr[9]) << 8 | LWGSM_U32(hdr[10]) << 16 | LWGSM_U32(hdr[11]) << 24;
+    if (hdr[0] != QUEUE_REC_MAGIC || rec->type < QUEUE_REC_SECTOR || rec->type > QUEUE_REC_ACK
+        || addr % st->sector_size + prv_rec_size(queue, rec->len) > st->sector_size) {
+        return QUEUE_REC_INVALID;
+    }
+    if (check_crc) {
+        uint8_t buff[QUEUE_CHUNK_SIZE];
+
+        crc = prv_crc32(0, hdr, 12);
+        addr += QUEUE_HDR_SIZE;
+        for (size_t len = rec->len, chunk; len > 0; len -= chunk, addr += LWGSM_U32(chunk)) {
+            chunk = LWGSM_MIN(len, sizeof(buff));
+            if (st->read(st->ctx, addr, buff, chunk) != lwgsmOK) {
+                return QUEUE_REC_INVALID;
+            }
+            crc = prv_crc32(crc, buff, chunk);
+        }
+        if (crc
+            != (LWGSM_U32(hdr[12]) | LWGSM_U32(hdr[13]) << 8 | LWGSM_U32(hdr[14]) << 16 | LWGSM_U32(hdr[15]) << 24)) {
+            return QUEUE_REC_INVALID;
+        }
+    }
+    return QUEUE_REC_VALID;
+}
+
+/**
+ * \brief           Move head to next sector, erase it and write sector record
+ * \note            Called with storage mutex locked, core lock is taken only to check tail
+ * \param[in]       queue: Queue handle
+ * \param[in,out]   head: Address of next record to write, updated to first record of next sector
+ * \return          \ref lwgsmOK on success, \ref lwgsmERRMEM when sector still holds messages
+ */
+static lwgsmr_t
+prv_sector_next(lwgsm_mqtt_queue_t* queue, uint32_t* head) {
+    const lwgsm_mqtt_queue_storage_t* st = queue->storage;
+    uint8_t hdr[QUEUE_CHUNK_SIZE], full;
+    uint32_t sector, crc;
+    lwgsmr_t res;
+
+    sector = (QUEUE_SECTOR(queue, *head - 1) + st->sector_size) % st->size;
+    lwgsm_core_lock(); /* Tail only moves away from next sector afterwards */
+    full = LWGSM_U8(!QUEUE_IS_EMPTY(queue) && QUEUE_SECTOR(queue, queue->tail_addr) == sector);
+    lwgsm_core_unlock();
+    if (full) {
+        return lwgsmERRMEM; /* Oldest message is in next sector */
+    }
+    if ((res = st->erase(st->ctx, sector)) != lwgsmOK) {
+        return res;
+    }
+
+    /* Sector record has no data */
+    memset(hdr, 0xFF, sizeof(hdr));
+    hdr[0] = QUEUE_REC_MAGIC;
+    hdr[1] = QUEUE_REC_SECTOR;
+    hdr[4] = hdr[5] = 0;
+    ++queue->sector_seq;
+    for (size_t i = 0; i < 4; ++i) {
+        hdr[8 + i] = LWGSM_U8(queue->sector_seq >> (8 * i));
+    }
+    crc = prv_crc32(0, hdr, 12);
+    for (size_t i = 0; i < 4; ++i) {
+        hdr[12 + i] = LWGSM_U8(crc >> (8 * i));
+    }
+    *head = QUEUE_FIRST_REC(queue, sector);
+    return st->prog(st->ctx, sector, hdr, *head - sector);
+}
+
+/**
+ * \brief           Append record to the log
+ *
+ * Data are provided in `3` parts, to avoid copy of topic and payload.
+ * Record becomes visible once caller sets new head address with core locked.
+ *
+ * \note            Called with storage mutex locked and core unlocked
+ * \param[in]       queue: Queue handle
+ * \param[in]       type: Record type
+ * \param[in]       flags: Record flags
+ * \param[in]       seq: Sequence number
+ * \param[in]       parts: Array of `3` data parts, entries may be `NULL`
+ * \param[in]       lens: Array of `3` data part lengths
+ * \param[out]      addr: Address of written record
+ * \param[in,out]   head: Address of next record to write, updated after write, also on failure
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+static lwgsmr_t
+prv_rec_write(lwgsm_mqtt_queue_t* queue, uint8_t type, uint8_t flags, uint32_t seq, const void* const* parts,
+              const size_t* lens, uint32_t* addr, uint32_t* head) {
+    const lwgsm_mqtt_queue_storage_t* st = queue->storage;
+    uint8_t chunk[QUEUE_CHUNK_SIZE], hdr[QUEUE_HDR_SIZE];
+    size_t len = lens[0] + lens[1] + lens[2], fill = 0;
+    uint32_t size, crc, a;
+    lwgsmr_t res;
+
+    size = prv_rec_size(queue, len);
+    if (*head - QUEUE_SECTOR(queue, *head - 1) + size > st->sector_size) {
+        if ((res = prv_sector_next(queue, head)) != lwgsmOK) {
+            return res;
+        }
+    }
+
+    hdr[0] = QUEUE_REC_MAGIC;
+    hdr[1] = type;
+    hdr[2] = flags;
+    hdr[3] = hdr[6] = hdr[7] = 0xFF;
+    hdr[4] = LWGSM_U8(len);
+    hdr[5] = LWGSM_U8(len >> 8);
+    for (size_t i = 0; i < 4; ++i) {
+        hdr[8 + i] = LWGSM_U8(seq >> (8 * i));
+    }
+    crc = prv_crc32(0, hdr, 12);
+    for (size_t i = 0; i < 3; ++i) {
+        crc = parts[i] != NULL ? prv_crc32(crc, parts[i], lens[i]) : crc;
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        hdr[12 + i] = LWGSM_U8(crc >> (8 * i));
+    }
+
+    /* Stream header and all parts through chunk buffer, program full chunks */
+    *addr = a = *head;
+    for (size_t i = 0; i < 4; ++i) {
+        const uint8_t* d = i == 0 ? hdr : parts[i - 1];
+        size_t l = i == 0 ? sizeof(hdr) : lens[i - 1];
+
+        for (size_t c; d != NULL && l > 0; l -= c, d += c) {
+            c = LWGSM_MIN(l, sizeof(chunk) - fill);
+            memcpy(&chunk[fill], d, c);
+            if ((fill += c) == sizeof(chunk)) {
+                if ((res = st->prog(st->ctx, a, chunk, fill)) != lwgsmOK) {
+                    goto fail;
+                }
+                a += LWGSM_U32(fill);
+                fill = 0;
+            }
+        }
+    }
+    if (fill > 0) {
+        size_t p = QUEUE_ALIGN(queue, fill);
+
+        memset(&chunk[fill], 0xFF, p - fill);
+        if ((res = st->prog(st->ctx, a, chunk, p)) != lwgsmOK) {
+            goto fail;
+        }
+    }
+    *head += size;
+    return lwgsmOK;
+
+fail:
+    /* Partially programmed area cannot be used anymore */
+    *head = QUEUE_SECTOR(queue, *head - 1) + st->sector_size;
+    return res;
+}
+
+/**
+ * \brief           Find first data record at or after address
+ * \param[in]       queue: Queue handle
+ * \param[in,out]   addr: Start address on input, record address on output.
+ *                      Set to head address when there is no data record
+ * \param[out]      rec: Output record header
+ * \return          `1` if data record found, `0` otherwise
+ */
+static uint8_t
+prv_find_data(lwgsm_mqtt_queue_t* queue, uint32_t* addr, queue_rec_t* rec) {
+    const lwgsm_mqtt_queue_storage_t* st = queue->storage;
+
+    while (*addr != queue->head_addr) {
+        uint32_t sector = QUEUE_SECTOR(queue, *addr - 1);
+
+        if (*addr - sector < st->sector_size && prv_rec_read(queue, *addr, rec, 1) == QUEUE_REC_VALID) {
+            if (rec->type == QUEUE_REC_DATA) {
+                return 1;
+            }
+            *addr += prv_rec_size(queue, rec->len);
+        } else if (sector == QUEUE_SECTOR(queue, queue->head_addr - 1)) {
+            break; /* Rest of head sector is not usable */
+        } else {
+            *addr = QUEUE_FIRST_REC(queue, (sector + st->sector_size) % st->size);
+        }
+    }
+    *addr = queue->head_addr;
+    return 0;
+}
+
+/**
+ * \brief           Write acknowledge record for all messages before tail
+ * \note            Called with storage mutex locked and core unlocked
+ * \param[in]       queue: Queue handle
+ * \param[in]       batch: Minimal number of acknowledged messages to write record,
+ *                      record is always written when queue is empty
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+static lwgsmr_t
+prv_ack_persist(lwgsm_mqtt_queue_t* queue, uint32_t batch) {
+    static const size_t lens[3] = {0, 0, 0};
+    const void* parts[3] = {NULL, NULL, NULL};
+    uint32_t addr, head, tail_seq;
+    uint8_t empty;
+    lwgsmr_t res;
+
+    lwgsm_core_lock();
+    tail_seq = queue->tail_seq;
+    empty = LWGSM_U8(QUEUE_IS_EMPTY(queue));
+    head = queue->head_addr;
+    lwgsm_core_unlock();
+    if (tail_seq == queue->ack_persisted || (tail_seq - queue->ack_persisted < batch && !empty)) {
+        return lwgsmOK;
+    }
+
+    res = prv_rec_write(queue, QUEUE_REC_ACK, 0xFF, tail_seq, parts, lens, &addr, &head);
+    lwgsm_core_lock();
+    queue->head_addr = head;
+    lwgsm_core_unlock();
+    if (res == lwgsmOK) {
+        queue->ack_persisted = tail_seq;
+        if (queue->storage->sync != NULL) {
+            res = queue->storage->sync(queue->storage->ctx);
+        }
+    }
+    return res;
+}
+
+/**
+ * \brief           Refill tokens for sending, according to drain rate
+ * \param[in]       queue: Queue handle
+ */
+static void
+prv_tokens_refill(lwgsm_mqtt_queue_t* queue) {
+    uint32_t now = lwgsm_sys_now(), elapsed, add;
+
+    if (queue->rate == 0) {
+        return;
+    }
+    elapsed = now - queue->tokens_time;
+    if (elapsed >= 1000) {
+        queue->tokens = queue->rate; /* Burst of one second at most */
+        queue->tokens_time = now;
+    } else if ((add = elapsed * queue->rate / 1000) > 0) {
+        queue->tokens = LWGSM_MIN(queue->tokens + add, queue->rate);
+        queue->tokens_time += add * 1000 / queue->rate;
+    }
+}
+
+/**
+ * \brief           Initialize queue and rebuild its state from storage
+ *
+ * Storage without valid log is formatted. Messages not acknowledged before reset are sent again.
+ *
+ * \note            Queue must not be set to client during initialization
+ * \param[in]       queue: Queue handle
+ * \param[in]       storage: Storage interface. It must stay valid for as long as queue is used
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_mqtt_queue_init(lwgsm_mqtt_queue_t* queue, const lwgsm_mqtt_queue_storage_t* storage) {
+    uint32_t sectors, head = 0, oldest, last_seq = 0, ack = 0, addr;
+    uint8_t found = 0, has_data = 0, has_ack = 0, status = QUEUE_REC_ERASED;
+    lwgsmr_t res = lwgsmOK;
+    queue_rec_t rec;
+
+    LWGSM_ASSERT(queue != NULL);
+    LWGSM_ASSERT(storage != NULL);
+    LWGSM_ASSERT(storage->read != NULL && storage->prog != NULL && storage->erase != NULL);
+    LWGSM_ASSERT(storage->prog_size > 0 && storage->prog_size <= QUEUE_CHUNK_SIZE);
+    LWGSM_ASSERT((storage->prog_size & (storage->prog_size - 1)) == 0);
+    LWGSM_ASSERT(storage->sector_size >= 4 * QUEUE_CHUNK_SIZE && storage->sector_size % storage->prog_size == 0);
+    LWGSM_ASSERT(storage->size % storage->sector_size == 0 && storage->size / storage->sector_size >= 2);
+
+    memset(queue, 0x00, sizeof(*queue));
+    if (!lwgsm_sys_mutex_create(&queue->mutex)) {
+        LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE_WARNING, "[LWGSM MQTT QUEUE] Cannot allocate mutex\r\n");
+        return lwgsmERRMEM;
+    }
+    queue->storage = storage;
+    sectors = storage->size / storage->sector_size;
+
+    /* Find sector written last */
+    for (uint32_t i = 0; i < sectors; ++i) {
+        if (prv_rec_read(queue, i * storage->sector_size, &rec, 1) == QUEUE_REC_VALID && rec.type == QUEUE_REC_SECTOR
+            && (!found || (int32_t)(rec.seq - queue->sector_seq) > 0)) {
+            head = i;
+            queue->sector_seq = rec.seq;
+            found = 1;
+        }
+    }
+
+    if (!found) {
+        /* Empty or foreign storage, start new log in first sector */
+        queue->head_addr = storage->size;
+        res = prv_sector_next(queue, &queue->head_addr);
+        queue->tail_addr = queue->head_addr;
+        queue->tail_seq = queue->next_seq = 1;
+    } else {
+        /* Chain of sectors with consecutive sequence numbers, ending in head sector */
+        oldest = head;
+        for (uint32_t i = 1, seq = queue->sector_seq - 1; i < sectors; ++i, --seq) {
+            uint32_t s = (head + sectors - i) % sectors;
+            if (prv_rec_read(queue, s * storage->sector_size, &rec, 1) != QUEUE_REC_VALID
+                || rec.type != QUEUE_REC_SECTOR || rec.seq != seq) {
+                break;
+            }
+            oldest = s;
+        }
+
+        /* Scan all records for last message and last acknowledge */
+        for (uint32_t s = oldest;; s = (s + 1) % sectors) {
+            uint32_t base = s * storage->sector_size;
+
+            addr = QUEUE_FIRST_REC(queue, base);
+            while (addr < base + storage->sector_size
+                   && (status = prv_rec_read(queue, addr, &rec, 1)) == QUEUE_REC_VALID) {
+                if (rec.type == QUEUE_REC_DATA) {
+                    last_seq = rec.seq;
+                    has_data = 1;
+                } else if (rec.type == QUEUE_REC_ACK && (!has_ack || (int32_t)(rec.seq - ack) > 0)) {
+                    ack = rec.seq;
+                    has_ack = 1;
+                }
+                addr += prv_rec_size(queue, rec.len);
+            }
+            if (s == head) {
+                /* Write continues after last valid record, unless area is damaged */
+                queue->head_addr = addr < base + storage->sector_size && status == QUEUE_REC_ERASED
+                                       ? addr
+                                       : base + storage->sector_size;
+                break;
+            }
+        }
+        queue->next_seq = has_data ? last_seq + 1 : 1;
+        if (has_ack && (int32_t)(ack - queue->next_seq) > 0) {
+            queue->next_seq = ack;
+        }
+
+        /* Oldest message not covered by acknowledge */
+        addr = QUEUE_FIRST_REC(queue, oldest * storage->sector_size);
+        queue->tail_seq = queue->next_seq;
+        while (prv_find_data(queue, &addr, &rec)) {
+            if (!has_ack || (int32_t)(rec.seq - ack) >= 0) {
+                queue->tail_seq = rec.seq;
+                break;
+            }
+            addr += prv_rec_size(queue, rec.len);
+        }
+        queue->tail_addr = addr;
+    }
+    queue->read_addr = queue->tail_addr;
+    queue->read_seq = queue->ack_persisted = queue->tail_seq;
+    queue->rate = LWGSM_CFG_MQTT_QUEUE_DRAIN_RATE;
+    queue->tokens = queue->rate;
+    queue->tokens_time = lwgsm_sys_now();
+
+    LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE, "[LWGSM MQTT QUEUE] Initialized with %d pending messages\r\n",
+                 (int)(queue->next_seq - queue->tail_seq));
+    return res;
+}
+
+/**
+ * \brief           Append message to the queue
+ * \note            Called by \ref lwgsm_mqtt_client_publish for client with queue set
+ * \note            On storage error, message may still be sent if its record has been programmed completely
+ * \param[in]       queue: Queue handle
+ * \param[in]       topic: Topic to send message to
+ * \param[in]       payload: Message data
+ * \param[in]       len: Length of payload data
+ * \param[in]       qos: Quality of service. This parameter can be a value of \ref lwgsm_mqtt_qos_t enumeration
+ * \param[in]       retain: Retain parameter value
+ * \return          \ref lwgsmOK on success, \ref lwgsmERRMEM when storage is full,
+ *                      \ref lwgsmERRPAR when message is too long to be sent by client,
+ *                      member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_mqtt_queue_append(lwgsm_mqtt_queue_t* queue, const char* topic, const void* payload, uint16_t len,
+                        lwgsm_mqtt_qos_t qos, uint8_t retain) {
+    const void* parts[3];
+    size_t lens[3];
+    uint8_t topic_len[2];
+    uint32_t addr, head, max_len;
+    lwgsmr_t res;
+
+    LWGSM_ASSERT(queue != NULL && queue->storage != NULL);
+    LWGSM_ASSERT(topic != NULL && topic[0] != '\0');
+
+    lens[0] = sizeof(topic_len);
+    lens[1] = strlen(topic);
+    lens[2] = payload != NULL ? len : 0;
+    topic_len[0] = LWGSM_U8(lens[1] >> 8);
+    topic_len[1] = LWGSM_U8(lens[1]);
+    parts[0] = topic_len;
+    parts[1] = topic;
+    parts[2] = payload;
+
+    lwgsm_core_lock();
+    max_len = queue->max_len;
+    lwgsm_core_unlock();
+
+    /* Packet ID is added when sent, record must fit to the sector and packet to client TX buffer */
+    if (lens[0] + lens[1] + lens[2] > 0xFFFF - 2
+        || QUEUE_FIRST_REC(queue, 0) + prv_rec_size(queue, lens[0] + lens[1] + lens[2])
+               > queue->storage->sector_size
+        || (max_len > 0 && lens[0] + lens[1] + lens[2] > max_len)) {
+        return lwgsmERRPAR;
+    }
+
+    /* Storage is written with core unlocked, only new head and sequence are set with core locked */
+    lwgsm_sys_mutex_lock(&queue->mutex);
+    prv_ack_persist(queue, LWGSM_CFG_MQTT_QUEUE_ACK_BATCH); /* Acknowledged messages first, to free storage */
+    lwgsm_core_lock();
+    head = queue->head_addr;
+    lwgsm_core_unlock();
+    res = prv_rec_write(queue, QUEUE_REC_DATA, LWGSM_U8(LWGSM_MIN(LWGSM_U8(qos), 2) | (retain ? 0x04 : 0x00)),
+                        queue->next_seq, parts, lens, &addr, &head);
+    if (res == lwgsmOK && queue->storage->sync != NULL) {
+        res = queue->storage->sync(queue->storage->ctx);
+    }
+    lwgsm_core_lock();
+    queue->head_addr = head;
+    if (res == lwgsmOK) {
+        if (QUEUE_IS_EMPTY(queue)) {
+            queue->tail_addr = addr;
+        }
+        if (queue->read_seq == queue->next_seq) {
+            queue->read_addr = addr;
+        }
+        ++queue->next_seq;
+        ++queue->appended;
+    } else if (res == lwgsmERRMEM) {
+        ++queue->dropped;
+        LWGSM_DEBUGF(LWGSM_CFG_DBG_MQTT_TRACE_WARNING, "[LWGSM MQTT QUEUE] Storage full, message dropped\r\n");
+    } else {
+        /* Record may still be valid in storage, its sequence number is never used again */
+        if (QUEUE_IS_EMPTY(queue)) {
+            queue->tail_addr = queue->read_addr = head;
+            queue->tail_seq = queue->read_seq = queue->next_seq + 1;
+        }
+        ++queue->next_seq;
+    }
+    lwgsm_core_unlock();
+    lwgsm_sys_mutex_unlock(&queue->mutex);
+    return res;
+}
+
+/**
+ * \brief           Write pending acknowledgements to storage
+ *
+ * Acknowledgements are written by \ref lwgsm_mqtt_queue_append in batches
+ * of \ref LWGSM_CFG_MQTT_QUEUE_ACK_BATCH messages. Call this function periodically
+ * and before planned power down, to avoid sending the same messages again after reset.
+ *
+ * \param[in]       queue: Queue handle
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_mqtt_queue_flush(lwgsm_mqtt_queue_t* queue) {
+    lwgsmr_t res;
+
+    LWGSM_ASSERT(queue != NULL && queue->storage != NULL);
+
+    lwgsm_sys_mutex_lock(&queue->mutex);
+    res = prv_ack_persist(queue, 0);
+    lwgsm_sys_mutex_unlock(&queue->mutex);
+    return res;
+}
+
+/**
+ * \brief           Set maximal number of messages sent from queue per second
+ * \param[in]       queue: Queue handle
+ * \param[in]       rate: Number of messages per second. Set to `0` to send as fast as connection allows
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_mqtt_queue_set_drain_rate(lwgsm_mqtt_queue_t* queue, uint32_t rate) {
+    LWGSM_ASSERT(queue != NULL);
+
+    lwgsm_core_lock();
+    queue->rate = rate;
+    queue->tokens = LWGSM_MIN(queue->tokens, rate);
+    queue->tokens_time = lwgsm_sys_now();
+    lwgsm_core_unlock();
+    return lwgsmOK;
+}
+
+/**
+ * \brief           Get queue statistics
+ * \param[in]       queue: Queue handle
+ * \param[out]      stats: Pointer to output structure to fill
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_mqtt_queue_get_stats(lwgsm_mqtt_queue_t* queue, lwgsm_mqtt_queue_stats_t* stats) {
+    LWGSM_ASSERT(queue != NULL);
+    LWGSM_ASSERT(stats != NULL);
+
+    lwgsm_core_lock();
+    stats->pending = queue->next_seq - queue->tail_seq;
+    stats->appended = queue->appended;
+    stats->acked = queue->acked;
+    stats->dropped = queue->dropped;
+    lwgsm_core_unlock();
+    return lwgsmOK;
+}
+
+/**
+ * \brief           Get next message to send, if allowed by window and drain rate
+ * \note            Called with core locked
+ * \param[in]       queue: Queue handle
+ * \param[out]      msg: Output message information
+ * \return          `1` if message shall be sent now, `0` otherwise
+ */
+uint8_t
+lwgsmi_mqtt_queue_next(lwgsm_mqtt_queue_t* queue, lwgsmi_mqtt_queue_msg_t* msg) {
+    uint8_t topic_len[2];
+    queue_rec_t rec;
+    uint32_t pos;
+
+    prv_tokens_refill(queue);
+    if (queue->rate > 0 && queue->tokens == 0) {
+        return 0;
+    }
+    for (;;) {
+        if (!prv_find_data(queue, &queue->read_addr, &rec)) {
+            queue->read_seq = queue->next_seq;
+            return 0;
+        }
+        queue->read_seq = rec.seq;
+        if ((pos = rec.seq - queue->tail_seq) >= LWGSM_CFG_MQTT_QUEUE_WINDOW) {
+            return 0;
+        }
+        if (!(queue->acked_mask & (LWGSM_U32(1) << pos))) {
+            break;
+        }
+        queue->read_addr += prv_rec_size(queue, rec.len); /* Sent again after failure, but already acknowledged */
+    }
+    if (rec.len < 2
+        || queue->storage->read(queue->storage->ctx, queue->read_addr + QUEUE_HDR_SIZE, topic_len, sizeof(topic_len))
+               != lwgsmOK) {
+        return 0;
+    }
+    msg->seq = rec.seq;
+    msg->addr = queue->read_addr + QUEUE_HDR_SIZE;
+    msg->len = rec.len;
+    msg->topic_len = LWGSM_U16(topic_len[0] << 8 | topic_len[1]);
+    msg->qos = rec.flags & 0x03;
+    msg->retain = (rec.flags >> 2) & 0x01;
+    return 1;
+}
+
+/**
+ * \brief           Read message data from storage
+ * \note            Called with core locked
+ * \param[in]       queue: Queue handle
+ * \param[in]       addr: Storage address
+ * \param[out]      data: Output data memory
+ * \param[in]       len: Number of bytes to read
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsmi_mqtt_queue_read(lwgsm_mqtt_queue_t* queue, uint32_t addr, void* data, size_t len) {
+    return queue->storage->read(queue->storage->ctx, addr, data, len);
+}
+
+/**
+ * \brief           Notify queue that message from \ref lwgsmi_mqtt_queue_next has been written for transmission
+ * \note            Called with core locked
+ * \param[in]       queue: Queue handle
+ * \param[in]       msg: Message information
+ */
+void
+lwgsmi_mqtt_queue_sent(lwgsm_mqtt_queue_t* queue, const lwgsmi_mqtt_queue_msg_t* msg) {
+    if (queue->tokens > 0) {
+        --queue->tokens;
+    }
+    queue->read_addr = msg->addr - QUEUE_HDR_SIZE + prv_rec_size(queue, msg->len);
+    queue->read_seq = msg->seq + 1;
+}
+
+/**
+ * \brief           Process result of message sent from queue
+ *
+ * Messages are removed from the queue in order, once all previous ones are acknowledged too.
+ * On failure, all messages not acknowledged yet are sent again.
+ * Acknowledge is kept in memory only, storage is written later from application thread.
+ *
+ * \note            Called with core locked
+ * \param[in]       queue: Queue handle
+ * \param[in]       seq: Message sequence number
+ * \param[in]       res: Result, \ref lwgsmOK when acknowledged by server
+ */
+void
+lwgsmi_mqtt_queue_ack(lwgsm_mqtt_queue_t* queue, uint32_t seq, lwgsmr_t res) {
+    uint32_t pos = seq - queue->tail_seq;
+    queue_rec_t rec;
+
+    if (QUEUE_IS_EMPTY(queue) || pos >= LWGSM_CFG_MQTT_QUEUE_WINDOW) {
+        return;
+    }
+    if (res != lwgsmOK) {
+        queue->read_addr = queue->tail_addr;
+        queue->read_seq = queue->tail_seq;
+        return;
+    }
+    queue->acked_mask |= LWGSM_U32(1) << pos;
+
+    /* Remove acknowledged messages from tail */
+    while (queue->acked_mask & 0x01) {
+        uint32_t old = queue->tail_seq;
+
+        if (queue->dropped_mask & 0x01) {
+            ++queue->dropped;
+        } else {
+            ++queue->acked;
+        }
+        if (prv_rec_read(queue, queue->tail_addr, &rec, 0) == QUEUE_REC_VALID) {
+            queue->tail_addr += prv_rec_size(queue, rec.len);
+        }
+        queue->tail_seq = prv_find_data(queue, &queue->tail_addr, &rec) ? rec.seq : queue->next_seq;
+        pos = queue->tail_seq - old;
+        queue->acked_mask = pos >= 32 ? 0 : queue->acked_mask >> pos;
+        queue->dropped_mask = pos >= 32 ? 0 : queue->dropped_mask >> pos;
+    }
+    if ((int32_t)(queue->read_seq - queue->tail_seq) < 0) {
+        queue->read_addr = queue->tail_addr;
+        queue->read_seq = queue->tail_seq;
+    }
+}
+
+/**
+ * \brief           Remove message from \ref lwgsmi_mqtt_queue_next which can never be sent,
+ *                  and count it as dropped
+ * \note            Called with core locked
+ * \param[in]       queue: Queue handle
+ * \param[in]       msg: Message information
+ */
+void
+lwgsmi_mqtt_queue_drop(lwgsm_mqtt_queue_t* queue, const lwgsmi_mqtt_queue_msg_t* msg) {
+    uint32_t pos = msg->seq - queue->tail_seq;
+
+    lwgsmi_mqtt_queue_sent(queue, msg);
+    if (pos < LWGSM_CFG_MQTT_QUEUE_WINDOW) {
+        queue->dropped_mask |= LWGSM_U32(1) << pos;
+    }
+    lwgsmi_mqtt_queue_ack(queue, msg->seq, lwgsmOK);
+}
+
+/**
+ * \brief           Set maximal length of topic and payload, which fits to client TX buffer
+ * \note            Called with core locked
+ * \param[in]       queue: Queue handle
+ * \param[in]       max_len: Maximal length of topic length, topic and payload, `0` when not limited
+ */
+void
+lwgsmi_mqtt_queue_set_max_len(lwgsm_mqtt_queue_t* queue, uint32_t max_len) {
+    queue->max_len = max_len;
+}
+
+#endif /* LWGSM_CFG_MQTT_QUEUE || __DOXYGEN__ */
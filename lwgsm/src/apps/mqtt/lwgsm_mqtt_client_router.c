@@ -0,0 +1,446 @@
+/**
+ * \file            lwgsm_mqtt_client_router.c
+ * \brief           Topic filter router for MQTT client
+ */
+
+/*
+ * Copyright (c) 2022 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGSM - Lightweight GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include "lwgsm/apps/lwgsm_mqtt_client_router.h"
+#include "lwgsm/lwgsm_private.h"
+
+#if LWGSM_CFG_MQTT_ROUTER || __DOXYGEN__
+
+/**
+ * \brief           Registered handler
+ */
+typedef struct lwgsmi_mqtt_route_handler {
+    struct lwgsmi_mqtt_route_handler* next; /*!< Next handler on the same node, in order of registration */
+    lwgsm_mqtt_route_fn fn;                 /*!< Handler function */
+    void* arg;                              /*!< User argument */
+} lwgsmi_mqtt_route_handler_t;
+
+/**
+ * \brief           Tree node for single topic level
+ */
+typedef struct lwgsmi_mqtt_route_node {
+    struct lwgsmi_mqtt_route_node* next;     /*!< Next sibling with the same parent */
+    struct lwgsmi_mqtt_route_node* children; /*!< List of children with literal level */
+    struct lwgsmi_mqtt_route_node* plus;     /*!< Child for `+` wildcard level */
+    lwgsmi_mqtt_route_handler_t* handlers;   /*!< Handlers of filters ending at this level */
+    lwgsmi_mqtt_route_handler_t* hash;       /*!< Handlers of filters ending with `#` after this level */
+    uint16_t level_len;                      /*!< Length of level */
+    char level[];                            /*!< Level string, not `NULL` terminated */
+} lwgsmi_mqtt_route_node_t;
+
+#if LWGSM_CFG_STATIC_ALLOC
+/* Nodes and handlers share the pool, handler is always smaller than node */
+#define MQTT_ROUTE_BLK_SIZE (sizeof(lwgsmi_mqtt_route_node_t) + LWGSM_CFG_STATIC_MQTT_ROUTE_LEVEL_LEN)
+LWGSM_MEM_POOL_DEFINE(lwgsmi_mqtt_route_pool, LWGSM_MEM_POOL_MQTT_ROUTE, MQTT_ROUTE_BLK_SIZE,
+                      LWGSM_CFG_STATIC_MQTT_ROUTE_NUM);
+#define MQTT_ROUTE_ALLOC(size) ((size) <= MQTT_ROUTE_BLK_SIZE ? lwgsmi_mem_pool_alloc(&lwgsmi_mqtt_route_pool) : NULL)
+#define MQTT_ROUTE_FREE(p)     lwgsmi_mem_pool_free(&lwgsmi_mqtt_route_pool, (p))
+#else /* LWGSM_CFG_STATIC_ALLOC */
+#define MQTT_ROUTE_ALLOC(size) lwgsm_mem_calloc_tag(LWGSM_MEM_TAG_MQTT, 1, (size))
+#define MQTT_ROUTE_FREE(p)     lwgsm_mem_free_tag(p)
+#endif /* !LWGSM_CFG_STATIC_ALLOC */
+
+/* Check if level is single character wildcard */
+#define MQTT_ROUTE_IS_WILD(lvl, len, c) ((len) == 1 && (lvl)[0] == (c))
+
+/**
+ * \brief           Get length of first level in topic or filter
+ * \param[in]       lvl: Start of level
+ * \param[in]       rem: Remaining length of topic or filter
+ * \return          Length of level, without `/` separator
+ */
+static size_t
+prv_level_len(const char* lvl, size_t rem) {
+    const char* sep = memchr(lvl, '/', rem);
+    return sep != NULL ? (size_t)(sep - lvl) : rem;
+}
+
+/**
+ * \brief           Check if topic filter is valid
+ *
+ * Wildcard must occupy whole level and `#` may only be the last level
+ *
+ * \param[in]       filter: Topic filter
+ * \param[in]       len: Length of filter
+ * \return          `1` if valid, `0` otherwise
+ */
+static uint8_t
+prv_filter_is_valid(const char* filter, size_t len) {
+    size_t lvl_len;
+
+    if (len == 0) {
+        return 0;
+    }
+    for (;;) {
+        lvl_len = prv_level_len(filter, len);
+        if (lvl_len > UINT16_MAX) {
+            return 0;
+        }
+        for (size_t i = 0; i < lvl_len; ++i) {
+            if ((filter[i] == '+' || filter[i] == '#') && lvl_len != 1) {
+                return 0;
+            }
+        }
+        if (lvl_len == len) {
+            return 1;
+        }
+        if (MQTT_ROUTE_IS_WILD(filter, lvl_len, '#')) {
+            return 0;
+        }
+        filter += lvl_len + 1;
+        len -= lvl_len + 1;
+    }
+}
+
+/**
+ * \brief           Find child link for level, either for `+` wildcard or for literal level
+ * \param[in]       node: Parent node
+ * \param[in]       lvl: Level string
+ * \param[in]       lvl_len: Length of level
+ * \return          Pointer to link of child, pointing to `NULL` if child does not exist
+ */
+static lwgsmi_mqtt_route_node_t**
+prv_child_link(lwgsmi_mqtt_route_node_t* node, const char* lvl, size_t lvl_len) {
+    lwgsmi_mqtt_route_node_t** link;
+
+    if (MQTT_ROUTE_IS_WILD(lvl, lvl_len, '+')) {
+        return &node->plus;
+    }
+    for (link = &node->children; *link != NULL; link = &(*link)->next) {
+        if ((*link)->level_len == lvl_len && !memcmp((*link)->level, lvl, lvl_len)) {
+            break;
+        }
+    }
+    return link;
+}
+
+/**
+ * \brief           Allocate new node
+ * \param[in]       lvl: Level string
+ * \param[in]       lvl_len: Length of level
+ * \return          New node on success, `NULL` otherwise
+ */
+static lwgsmi_mqtt_route_node_t*
+prv_node_new(const char* lvl, size_t lvl_len) {
+    lwgsmi_mqtt_route_node_t* node;
+
+    if ((node = MQTT_ROUTE_ALLOC(sizeof(*node) + lvl_len)) != NULL) {
+        node->level_len = (uint16_t)lvl_len;
+        if (lvl_len > 0) {
+            LWGSM_MEMCPY(node->level, lvl, lvl_len);
+        }
+    }
+    return node;
+}
+
+/**
+ * \brief           Free node if it has no handlers and no children, and unlink it from parent
+ * \param[in,out]   link: Link to node in parent or router
+ */
+static void
+prv_node_free_if_unused(lwgsmi_mqtt_route_node_t** link) {
+    lwgsmi_mqtt_route_node_t* node = *link;
+
+    if (node != NULL && node->children == NULL && node->plus == NULL && node->handlers == NULL
+        && node->hash == NULL) {
+        *link = node->next;
+        MQTT_ROUTE_FREE(node);
+    }
+}
+
+/**
+ * \brief           Free node with all its children and handlers
+ * \param[in]       node: Node to free
+ */
+static void
+prv_node_free_all(lwgsmi_mqtt_route_node_t* node) {
+    lwgsmi_mqtt_route_node_t* next;
+    lwgsmi_mqtt_route_handler_t* h;
+
+    for (; node != NULL; node = next) {
+        next = node->next;
+        prv_node_free_all(node->children);
+        prv_node_free_all(node->plus);
+        while ((h = node->handlers) != NULL) {
+            node->handlers = h->next;
+            MQTT_ROUTE_FREE(h);
+        }
+        while ((h = node->hash) != NULL) {
+            node->hash = h->next;
+            MQTT_ROUTE_FREE(h);
+        }
+        MQTT_ROUTE_FREE(node);
+    }
+}
+
+/**
+ * \brief           Remove handler from list
+ * \param[in,out]   link: Link to first handler in list
+ * \param[in]       fn: Handler function, `NULL` to remove nothing
+ * \param[in]       arg: User argument of handler
+ * \return          `1` if handler was removed, `0` otherwise
+ */
+static uint8_t
+prv_handler_remove(lwgsmi_mqtt_route_handler_t** link, lwgsm_mqtt_route_fn fn, void* arg) {
+    lwgsmi_mqtt_route_handler_t* h;
+
+    for (; fn != NULL && (h = *link) != NULL; link = &h->next) {
+        if (h->fn == fn && h->arg == arg) {
+            *link = h->next;
+            MQTT_ROUTE_FREE(h);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Remove handler for filter and free nodes on its path that became unused
+ * \param[in]       node: Node of parent level
+ * \param[in]       lvl: Remaining filter, starting with level to process
+ * \param[in]       rem: Length of remaining filter
+ * \param[in]       fn: Handler function, `NULL` to only free unused nodes
+ * \param[in]       arg: User argument of handler
+ * \return          `1` if handler was removed, `0` otherwise
+ */
+static uint8_t
+prv_route_remove(lwgsmi_mqtt_route_node_t* node, const char* lvl, size_t rem, lwgsm_mqtt_route_fn fn, void* arg) {
+    lwgsmi_mqtt_route_node_t** link;
+    size_t lvl_len = prv_level_len(lvl, rem);
+    uint8_t removed = 0;
+
+    if (MQTT_ROUTE_IS_WILD(lvl, lvl_len, '#')) {
+        return prv_handler_remove(&node->hash, fn, arg);
+    }
+    link = prv_child_link(node, lvl, lvl_len);
+    if (*link != NULL) {
+        if (lvl_len == rem) {
+            removed = prv_handler_remove(&(*link)->handlers, fn, arg);
+        } else {
+            removed = prv_route_remove(*link, lvl + lvl_len + 1, rem - lvl_len - 1, fn, arg);
+        }
+        prv_node_free_if_unused(link);
+    }
+    return removed;
+}
+
+/**
+ * \brief           Call all handlers in list
+ * \param[in]       h: First handler
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Received publish event
+ * \return          Number of called handlers
+ */
+static size_t
+prv_handlers_call(const lwgsmi_mqtt_route_handler_t* h, lwgsm_mqtt_client_p client, lwgsm_mqtt_evt_t* evt) {
+    size_t cnt = 0;
+
+    for (; h != NULL; h = h->next, ++cnt) {
+        h->fn(client, evt, h->arg);
+    }
+    return cnt;
+}
+
+/**
+ * \brief           Match topic levels against subtree and call handlers of matching filters
+ *
+ * Recursion depth is limited by depth of registered filters, not by received topic
+ *
+ * \param[in]       node: Node of last matched level
+ * \param[in]       lvl: Remaining topic, starting with next level
+ * \param[in]       rem: Length of remaining topic
+ * \param[in]       done: Set to `1` when all topic levels were matched
+ * \param[in]       wild: Set to `1` if wildcards may match next level
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Received publish event
+ * \return          Number of called handlers
+ */
+static size_t
+prv_route_match(const lwgsmi_mqtt_route_node_t* node, const char* lvl, size_t rem, uint8_t done, uint8_t wild,
+                lwgsm_mqtt_client_p client, lwgsm_mqtt_evt_t* evt) {
+    const lwgsmi_mqtt_route_node_t* child;
+    size_t cnt = 0, lvl_len, next_rem;
+    uint8_t next_done;
+
+    /* `#` matches parent level too, "a/#" matches "a" */
+    if (wild) {
+        cnt += prv_handlers_call(node->hash, client, evt);
+    }
+    if (done) {
+        return cnt + prv_handlers_call(node->handlers, client, evt);
+    }
+
+    lvl_len = prv_level_len(lvl, rem);
+    next_done = LWGSM_U8(lvl_len == rem);
+    next_rem = next_done ? 0 : (rem - lvl_len - 1);
+    for (child = node->children; child != NULL; child = child->next) {
+        if (child->level_len == lvl_len && !memcmp(child->level, lvl, lvl_len)) {
+            cnt += prv_route_match(child, lvl + rem - next_rem, next_rem, next_done, 1, client, evt);
+            break;
+        }
+    }
+    if (wild && node->plus != NULL) {
+        cnt += prv_route_match(node->plus, lvl + rem - next_rem, next_rem, next_done, 1, client, evt);
+    }
+    return cnt;
+}
+
+/**
+ * \brief           Register handler for topic filter
+ * \note            Core must be locked when calling this function
+ * \param[in]       router: Router of client
+ * \param[in]       filter: Topic filter
+ * \param[in]       fn: Handler function
+ * \param[in]       arg: User argument passed to handler
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsmi_mqtt_router_add(lwgsmi_mqtt_router_t* router, const char* filter, lwgsm_mqtt_route_fn fn, void* arg) {
+    lwgsmi_mqtt_route_node_t *node, **link;
+    lwgsmi_mqtt_route_handler_t** hlink;
+    const char* lvl = filter;
+    size_t len = strlen(filter), rem = len, lvl_len;
+
+    if (router->dispatching) {
+        return lwgsmERR;
+    }
+    if (!prv_filter_is_valid(filter, len)) {
+        return lwgsmERRPAR;
+    }
+    if (router->root == NULL && (router->root = prv_node_new(NULL, 0)) == NULL) {
+        return LWGSMI_ERRMEM;
+    }
+
+    /* Find or create node for every level */
+    node = router->root;
+    for (;;) {
+        lvl_len = prv_level_len(lvl, rem);
+        if (MQTT_ROUTE_IS_WILD(lvl, lvl_len, '#')) {
+            hlink = &node->hash;
+            break;
+        }
+        link = prv_child_link(node, lvl, lvl_len);
+        if (*link == NULL && (*link = prv_node_new(lvl, lvl_len)) == NULL) {
+            hlink = NULL;
+            break;
+        }
+        node = *link;
+        if (lvl_len == rem) {
+            hlink = &node->handlers;
+            break;
+        }
+        lvl += lvl_len + 1;
+        rem -= lvl_len + 1;
+    }
+
+    /* Append handler, unless already registered */
+    if (hlink != NULL) {
+        for (; *hlink != NULL; hlink = &(*hlink)->next) {
+            if ((*hlink)->fn == fn && (*hlink)->arg == arg) {
+                return lwgsmOK;
+            }
+        }
+        if ((*hlink = MQTT_ROUTE_ALLOC(sizeof(**hlink))) != NULL) {
+            (*hlink)->fn = fn;
+            (*hlink)->arg = arg;
+            return lwgsmOK;
+        }
+    }
+
+    /* Allocation failed, release nodes created for this filter */
+    prv_route_remove(router->root, filter, len, NULL, NULL);
+    prv_node_free_if_unused(&router->root);
+    return LWGSMI_ERRMEM;
+}
+
+/**
+ * \brief           Remove handler for topic filter
+ * \note            Core must be locked when calling this function
+ * \param[in]       router: Router of client
+ * \param[in]       filter: Topic filter, as used on registration
+ * \param[in]       fn: Handler function
+ * \param[in]       arg: User argument, as used on registration
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsmi_mqtt_router_remove(lwgsmi_mqtt_router_t* router, const char* filter, lwgsm_mqtt_route_fn fn, void* arg) {
+    uint8_t removed;
+    size_t len = strlen(filter);
+
+    if (router->dispatching) {
+        return lwgsmERR;
+    }
+    if (router->root == NULL || !prv_filter_is_valid(filter, len)) {
+        return lwgsmERRPAR;
+    }
+    removed = prv_route_remove(router->root, filter, len, fn, arg);
+    prv_node_free_if_unused(&router->root);
+    return removed ? lwgsmOK : lwgsmERRPAR;
+}
+
+/**
+ * \brief           Dispatch received publish event to handlers with matching filter
+ * \note            Core must be locked when calling this function
+ * \param[in]       router: Router of client
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event with \ref LWGSM_MQTT_EVT_PUBLISH_RECV type
+ * \return          Number of called handlers
+ */
+size_t
+lwgsmi_mqtt_router_dispatch(lwgsmi_mqtt_router_t* router, lwgsm_mqtt_client_p client, lwgsm_mqtt_evt_t* evt) {
+    const char* topic = (const char*)evt->evt.publish_recv.topic;
+    size_t topic_len = evt->evt.publish_recv.topic_len, cnt;
+
+    if (router->root == NULL) {
+        return 0;
+    }
+
+    /* Topics starting with `$` are not matched by wildcards on first level */
+    router->dispatching = 1;
+    cnt = prv_route_match(router->root, topic, topic_len, 0, LWGSM_U8(topic_len == 0 || topic[0] != '$'), client,
+                          evt);
+    router->dispatching = 0;
+    return cnt;
+}
+
+/**
+ * \brief           Remove all handlers and free router memory
+ * \param[in]       router: Router of client
+ */
+void
+lwgsmi_mqtt_router_free(lwgsmi_mqtt_router_t* router) {
+    prv_node_free_all(router->root);
+    router->root = NULL;
+}
+
+#endif /* LWGSM_CFG_MQTT_ROUTER || __DOXYGEN__ */
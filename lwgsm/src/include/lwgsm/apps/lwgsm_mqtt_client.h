@@ -93,6 +93,14 @@ typedef struct {
     const char* will_topic;    /*!< Will topic */
     const char* will_message;  /*!< Will message */
     lwgsm_mqtt_qos_t will_qos; /*!< Will topic quality of service */
+
+    uint8_t keep_session; /*!< Set to `1` to connect without clean session flag.
+                                With \ref LWGSM_CFG_MQTT_RETRANSMIT enabled, unacknowledged publish packets
+                                are kept on connection loss and sent again after reconnection */
+#if LWGSM_CFG_MQTT_V5 || __DOXYGEN__
+    uint8_t protocol_version; /*!< Protocol version, `5` for MQTT 5.0, `4` or `0` for MQTT 3.1.1.
+                                    With MQTT 5.0 and `keep_session` set, session never expires on server */
+#endif /* LWGSM_CFG_MQTT_V5 || __DOXYGEN__ */
 } lwgsm_mqtt_client_info_t;
 
 /**
@@ -107,8 +115,42 @@ typedef struct {
                                                     on connection before we can say "packet was sent". */
 
     uint32_t timeout_start_time; /*!< Timeout start time in units of milliseconds */
+#if LWGSM_CFG_MQTT_RETRANSMIT || __DOXYGEN__
+    uint8_t* packet;     /*!< Copy of raw packet for retransmission */
+    uint16_t packet_len; /*!< Length of raw packet copy in units of bytes */
+    uint8_t retries;     /*!< Number of retransmissions so far */
+    uint32_t timeout;    /*!< Current timeout in units of milliseconds */
+    uint32_t send_seq;   /*!< Order of last `PUBLISH` or `PUBREL` sending,
+                                used to send requests again in the same order after reconnection */
+#endif /* LWGSM_CFG_MQTT_RETRANSMIT || __DOXYGEN__ */
+#if LWGSM_CFG_MQTT_QUEUE || __DOXYGEN__
+    uint32_t queue_seq; /*!< Sequence number of message sent from store-and-forward queue */
+#endif /* LWGSM_CFG_MQTT_QUEUE || __DOXYGEN__ */
 } lwgsm_mqtt_request_t;
 
+/**
+ * \brief           MQTT request table statistics
+ */
+typedef struct {
+    size_t size;     /*!< Number of request objects */
+    size_t used;     /*!< Number of requests currently in use */
+    size_t max_used; /*!< Maximal number of requests in use at the same time */
+    size_t failed;   /*!< Number of requests refused because all objects were in use */
+} lwgsm_mqtt_request_stats_t;
+
+/**
+ * \brief           Message for \ref lwgsm_mqtt_client_publish_batch
+ */
+typedef struct {
+    const char* topic;    /*!< Topic to send message to */
+    const void* payload;  /*!< Message data */
+    uint16_t payload_len; /*!< Length of payload data */
+    lwgsm_mqtt_qos_t qos; /*!< Quality of service */
+    uint8_t retain;       /*!< Retain flag */
+    void* arg;            /*!< User custom argument, used in \ref LWGSM_MQTT_EVT_PUBLISH event.
+                                Ignored when message is stored to queue */
+} lwgsm_mqtt_client_publish_msg_t;
+
 /**
  * \brief           MQTT event types
  */
@@ -135,6 +177,21 @@ typedef enum {
     LWGSM_MQTT_CONN_STATUS_REFUSED_SERVER = 0x03,           /*!< Connection refused, server unavailable */
     LWGSM_MQTT_CONN_STATUS_REFUSED_USER_PASS = 0x04,        /*!< Connection refused, bad user name or password */
     LWGSM_MQTT_CONN_STATUS_REFUSED_NOT_AUTHORIZED = 0x05,   /*!< Connection refused, not authorized */
+    LWGSM_MQTT_CONN_STATUS_V5_UNSPECIFIED = 0x80,           /*!< MQTT 5.0, unspecified error */
+    LWGSM_MQTT_CONN_STATUS_V5_MALFORMED = 0x81,             /*!< MQTT 5.0, malformed packet */
+    LWGSM_MQTT_CONN_STATUS_V5_PROTOCOL_ERROR = 0x82,        /*!< MQTT 5.0, protocol error */
+    LWGSM_MQTT_CONN_STATUS_V5_PROTOCOL_VERSION = 0x84,      /*!< MQTT 5.0, unsupported protocol version */
+    LWGSM_MQTT_CONN_STATUS_V5_ID = 0x85,                    /*!< MQTT 5.0, client identifier not valid */
+    LWGSM_MQTT_CONN_STATUS_V5_USER_PASS = 0x86,             /*!< MQTT 5.0, bad user name or password */
+    LWGSM_MQTT_CONN_STATUS_V5_NOT_AUTHORIZED = 0x87,        /*!< MQTT 5.0, not authorized */
+    LWGSM_MQTT_CONN_STATUS_V5_SERVER_UNAVAILABLE = 0x88,    /*!< MQTT 5.0, server unavailable */
+    LWGSM_MQTT_CONN_STATUS_V5_SERVER_BUSY = 0x89,           /*!< MQTT 5.0, server busy */
+    LWGSM_MQTT_CONN_STATUS_V5_BANNED = 0x8A,                /*!< MQTT 5.0, client is banned */
+    LWGSM_MQTT_CONN_STATUS_V5_PACKET_TOO_LARGE = 0x95,      /*!< MQTT 5.0, CONNECT packet too large */
+    LWGSM_MQTT_CONN_STATUS_V5_QUOTA_EXCEEDED = 0x97,        /*!< MQTT 5.0, quota exceeded */
+    LWGSM_MQTT_CONN_STATUS_V5_USE_ANOTHER_SERVER = 0x9C,    /*!< MQTT 5.0, use another server */
+    LWGSM_MQTT_CONN_STATUS_V5_SERVER_MOVED = 0x9D,          /*!< MQTT 5.0, server moved */
+    LWGSM_MQTT_CONN_STATUS_V5_RATE_EXCEEDED = 0x9F,         /*!< MQTT 5.0, connection rate exceeded */
     LWGSM_MQTT_CONN_STATUS_TCP_FAILED = 0x100,              /*!< TCP connection to server was not successful */
 } lwgsm_mqtt_conn_status_t;
 
@@ -170,6 +227,9 @@ typedef struct {
             size_t payload_len;   /*!< Length of topic payload */
             uint8_t dup;          /*!< Duplicate flag if message was sent again */
             lwgsm_mqtt_qos_t qos; /*!< Received packet quality of service */
+            lwgsm_pbuf_p pbuf;    /*!< Received packet buffer holding topic and payload,
+                                        or `NULL` when packet was assembled in RX buffer of client.
+                                        Reference it with \ref lwgsm_pbuf_ref to use data after callback returns */
         } publish_recv;           /*!< Publish received event */
     } evt;                        /*!< Event data parameters */
 } lwgsm_mqtt_evt_t;
@@ -181,7 +241,21 @@ typedef struct {
  */
 typedef void (*lwgsm_mqtt_evt_fn)(lwgsm_mqtt_client_p client, lwgsm_mqtt_evt_t* evt);
 
+/**
+ * \brief           Payload callback function for streaming publish
+ * \note            Function is called from stack thread and must not block
+ * \param[in]       client: MQTT client
+ * \param[out]      data: Memory in TX buffer to write next payload data to
+ * \param[in]       offset: Offset of requested data in payload, in units of bytes
+ * \param[in]       len: Maximal number of bytes to write
+ * \param[in]       arg: User argument passed to \ref lwgsm_mqtt_client_publish_stream
+ * \return          Number of bytes written, `0` when data are not available yet and function must be called again later
+ */
+typedef size_t (*lwgsm_mqtt_client_payload_fn)(lwgsm_mqtt_client_p client, void* data, size_t offset, size_t len,
+                                               void* arg);
+
 lwgsm_mqtt_client_p lwgsm_mqtt_client_new(size_t tx_buff_len, size_t rx_buff_len);
+lwgsm_mqtt_client_p lwgsm_mqtt_client_new_ex(size_t tx_buff_len, size_t rx_buff_len, size_t max_requests);
 void lwgsm_mqtt_client_delete(lwgsm_mqtt_client_p client);
 
 lwgsmr_t lwgsm_mqtt_client_connect(lwgsm_mqtt_client_p client, const char* host, lwgsm_port_t port,
@@ -194,10 +268,17 @@ lwgsmr_t lwgsm_mqtt_client_unsubscribe(lwgsm_mqtt_client_p client, const char* t
 
 lwgsmr_t lwgsm_mqtt_client_publish(lwgsm_mqtt_client_p client, const char* topic, const void* payload, uint16_t len,
                                    lwgsm_mqtt_qos_t qos, uint8_t retain, void* arg);
+lwgsmr_t lwgsm_mqtt_client_publish_batch(lwgsm_mqtt_client_p client, const lwgsm_mqtt_client_publish_msg_t* msgs,
+                                         size_t msgs_len, size_t* published);
+lwgsmr_t lwgsm_mqtt_client_publish_stream(lwgsm_mqtt_client_p client, const char* topic, uint32_t payload_len,
+                                          lwgsm_mqtt_qos_t qos, uint8_t retain, lwgsm_mqtt_client_payload_fn payload_fn,
+                                          void* arg);
 
 void* lwgsm_mqtt_client_get_arg(lwgsm_mqtt_client_p client);
 void lwgsm_mqtt_client_set_arg(lwgsm_mqtt_client_p client, void* arg);
 
+lwgsmr_t lwgsm_mqtt_client_get_request_stats(lwgsm_mqtt_client_p client, lwgsm_mqtt_request_stats_t* stats);
+
 /**
  * \}
  */
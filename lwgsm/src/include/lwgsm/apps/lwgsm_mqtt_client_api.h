@@ -62,6 +62,10 @@ typedef struct lwgsm_mqtt_client_api_buf {
     uint8_t* payload;     /*!< Payload data */
     size_t payload_len;   /*!< Payload length */
     lwgsm_mqtt_qos_t qos; /*!< Quality of service */
+#if LWGSM_CFG_MQTT_API_ZERO_COPY || __DOXYGEN__
+    lwgsm_pbuf_p pbuf; /*!< Referenced packet buffer holding topic and payload, `NULL` when data were copied.
+                            Topic and payload are not `NULL` terminated when set */
+#endif /* LWGSM_CFG_MQTT_API_ZERO_COPY || __DOXYGEN__ */
 } lwgsm_mqtt_client_api_buf_t;
 
 /**
@@ -209,6 +209,17 @@ extern "C" {
  */
 #define lwgsm_mqtt_client_evt_publish_recv_get_qos(client, evt)         ((evt)->evt.publish_recv.qos)
 
+/**
+ * \brief           Get packet buffer holding topic and payload of received publish packet
+ * \note            Topic and payload point to memory of this buffer.
+ *                  Reference it with \ref lwgsm_pbuf_ref to keep data valid after event callback returns
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Packet buffer, `NULL` when packet was assembled in RX buffer of client
+ * \hideinitializer
+ */
+#define lwgsm_mqtt_client_evt_publish_recv_get_pbuf(client, evt)        ((evt)->evt.publish_recv.pbuf)
+
 /**
  * \}
  */
@@ -0,0 +1,196 @@
+/**
+ * \file            lwgsm_mqtt_client_queue.h
+ * \brief           Persistent store-and-forward queue for MQTT client
+ */
+
+/*
+ * Copyright (c) 2022 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGSM - Lightweight GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#ifndef LWGSM_HDR_APP_MQTT_CLIENT_QUEUE_H
+#define LWGSM_HDR_APP_MQTT_CLIENT_QUEUE_H
+
+#include "lwgsm/apps/lwgsm_mqtt_client.h"
+#include "lwgsm/lwgsm_includes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWGSM_APP_MQTT_CLIENT
+ * \defgroup        LWGSM_APP_MQTT_CLIENT_QUEUE Store-and-forward queue
+ * \brief           Durable outbound queue for publish messages while offline
+ * \{
+ *
+ * Every message published with \ref lwgsm_mqtt_client_publish is appended to the log in storage first.
+ * Messages are sent in order while client is connected, or after the next accepted connection,
+ * at most \ref lwgsm_mqtt_queue_set_drain_rate messages per second.
+ * Messages are removed from the queue once acknowledged by server, or sent in case of QoS `0`.
+ *
+ * Storage is organized as append-only log in sectors. Every record has CRC and sequence number.
+ * Acknowledgements are written as separate records, each covering a batch of messages,
+ * thus nothing is ever overwritten in place and storage may be NOR flash with arbitrary program unit.
+ * After reset, queue is rebuilt from storage and unacknowledged messages are sent again.
+ *
+ * Queue is full when oldest sector still holds unacknowledged messages and new sector is required.
+ *
+ * Storage is written only from application thread, by \ref lwgsm_mqtt_queue_append
+ * and \ref lwgsm_mqtt_queue_flush, without core lock held. Acknowledgements from server
+ * are only recorded in memory and written to storage by next call of one of these functions.
+ */
+
+/**
+ * \brief           Storage interface for queue
+ *
+ * Memory must behave like NOR flash: erased sector reads as `0xFF`
+ * and every byte is programmed at most once between erases.
+ */
+typedef struct {
+    /**
+     * \brief           Read data from storage
+     * \param[in]       ctx: Storage context
+     * \param[in]       addr: Address relative to storage start
+     * \param[out]      data: Output data memory
+     * \param[in]       len: Number of bytes to read
+     * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+     */
+    lwgsmr_t (*read)(void* ctx, uint32_t addr, void* data, size_t len);
+
+    /**
+     * \brief           Program data to erased storage
+     * \param[in]       ctx: Storage context
+     * \param[in]       addr: Address relative to storage start, aligned to `prog_size`
+     * \param[in]       data: Data to program
+     * \param[in]       len: Number of bytes to program, multiple of `prog_size`
+     * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+     */
+    lwgsmr_t (*prog)(void* ctx, uint32_t addr, const void* data, size_t len);
+
+    /**
+     * \brief           Erase single sector
+     * \param[in]       ctx: Storage context
+     * \param[in]       addr: Sector start address relative to storage start
+     * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+     */
+    lwgsmr_t (*erase)(void* ctx, uint32_t addr);
+
+    /**
+     * \brief           Make all programmed data durable. Set to `NULL` if not required
+     * \param[in]       ctx: Storage context
+     * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+     */
+    lwgsmr_t (*sync)(void* ctx);
+
+    uint32_t size;        /*!< Storage size in units of bytes, multiple of `sector_size` with at least `2` sectors */
+    uint32_t sector_size; /*!< Erase unit in units of bytes */
+    uint32_t prog_size;   /*!< Program unit in units of bytes, power of `2` up to `32` */
+    void* ctx;            /*!< Context passed to every function */
+} lwgsm_mqtt_queue_storage_t;
+
+/**
+ * \brief           Store-and-forward queue
+ * \note            Structure is managed by queue functions, it shall not be modified by application
+ */
+typedef struct lwgsm_mqtt_queue {
+    const lwgsm_mqtt_queue_storage_t* storage; /*!< Storage interface */
+    lwgsm_sys_mutex_t mutex;                   /*!< Mutex for storage writes, taken without core lock */
+    uint32_t sector_seq;                       /*!< Sequence number of sector currently written */
+    uint32_t head_addr;                        /*!< Address of next record to write */
+    uint32_t tail_addr;                        /*!< Address of oldest unacknowledged message */
+    uint32_t tail_seq;                         /*!< Sequence number of oldest unacknowledged message */
+    uint32_t read_addr;                        /*!< Address of next message to send */
+    uint32_t read_seq;                         /*!< Sequence number of next message to send */
+    uint32_t next_seq;                         /*!< Sequence number of next appended message */
+    uint32_t acked_mask;                       /*!< Acknowledged messages in flight, bit `0` is `tail_seq` */
+    uint32_t dropped_mask;                     /*!< Messages in flight removed without delivery */
+    uint32_t max_len;                          /*!< Maximal length of topic and payload, `0` when not limited */
+    uint32_t ack_persisted;                    /*!< Sequence number written in last acknowledge record */
+    uint32_t rate;                             /*!< Maximal number of messages per second, `0` for unlimited */
+    uint32_t tokens;                           /*!< Number of messages allowed to be sent now */
+    uint32_t tokens_time;                      /*!< Time of last tokens refill in units of milliseconds */
+    uint32_t appended;                         /*!< Number of appended messages */
+    uint32_t acked;                            /*!< Number of acknowledged messages */
+    uint32_t dropped;                          /*!< Number of messages refused due to full storage or not sent */
+} lwgsm_mqtt_queue_t;
+
+/**
+ * \brief           Queue statistics
+ */
+typedef struct {
+    uint32_t pending;  /*!< Number of messages not yet acknowledged */
+    uint32_t appended; /*!< Number of messages appended since initialization */
+    uint32_t acked;    /*!< Number of messages acknowledged since initialization */
+    uint32_t dropped;  /*!< Number of messages refused because storage was full,
+                                or removed without delivery because server does not accept their size */
+} lwgsm_mqtt_queue_stats_t;
+
+lwgsmr_t lwgsm_mqtt_queue_init(lwgsm_mqtt_queue_t* queue, const lwgsm_mqtt_queue_storage_t* storage);
+lwgsmr_t lwgsm_mqtt_queue_append(lwgsm_mqtt_queue_t* queue, const char* topic, const void* payload, uint16_t len,
+                                 lwgsm_mqtt_qos_t qos, uint8_t retain);
+lwgsmr_t lwgsm_mqtt_queue_flush(lwgsm_mqtt_queue_t* queue);
+lwgsmr_t lwgsm_mqtt_queue_set_drain_rate(lwgsm_mqtt_queue_t* queue, uint32_t rate);
+lwgsmr_t lwgsm_mqtt_queue_get_stats(lwgsm_mqtt_queue_t* queue, lwgsm_mqtt_queue_stats_t* stats);
+
+lwgsmr_t lwgsm_mqtt_client_set_queue(lwgsm_mqtt_client_p client, lwgsm_mqtt_queue_t* queue);
+
+/* Storage implementations, available when respective file from system folder is compiled */
+lwgsmr_t lwgsm_mqtt_queue_storage_mmap_open(lwgsm_mqtt_queue_storage_t* storage, const char* path, uint32_t size,
+                                            uint32_t sector_size);
+void lwgsm_mqtt_queue_storage_mmap_close(lwgsm_mqtt_queue_storage_t* storage);
+lwgsmr_t lwgsm_mqtt_queue_storage_flash_init(lwgsm_mqtt_queue_storage_t* storage, uint32_t addr, uint32_t size);
+
+/**
+ * \}
+ */
+
+#if !__DOXYGEN__
+
+/* Message to send, used by MQTT client */
+typedef struct {
+    uint32_t seq;       /* Sequence number */
+    uint32_t addr;      /* Storage address of topic length, followed by topic and payload */
+    uint16_t len;       /* Length of topic length, topic and payload */
+    uint16_t topic_len; /* Length of topic */
+    uint8_t qos;        /* Quality of service */
+    uint8_t retain;     /* Retain flag */
+} lwgsmi_mqtt_queue_msg_t;
+
+uint8_t lwgsmi_mqtt_queue_next(lwgsm_mqtt_queue_t* queue, lwgsmi_mqtt_queue_msg_t* msg);
+lwgsmr_t lwgsmi_mqtt_queue_read(lwgsm_mqtt_queue_t* queue, uint32_t addr, void* data, size_t len);
+void lwgsmi_mqtt_queue_sent(lwgsm_mqtt_queue_t* queue, const lwgsmi_mqtt_queue_msg_t* msg);
+void lwgsmi_mqtt_queue_ack(lwgsm_mqtt_queue_t* queue, uint32_t seq, lwgsmr_t res);
+void lwgsmi_mqtt_queue_drop(lwgsm_mqtt_queue_t* queue, const lwgsmi_mqtt_queue_msg_t* msg);
+void lwgsmi_mqtt_queue_set_max_len(lwgsm_mqtt_queue_t* queue, uint32_t max_len);
+
+#endif /* !__DOXYGEN__ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWGSM_HDR_APP_MQTT_CLIENT_QUEUE_H */
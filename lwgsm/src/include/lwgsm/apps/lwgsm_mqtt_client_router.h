@@ -0,0 +1,101 @@
+/**
+ * \file            lwgsm_mqtt_client_router.h
+ * \brief           Topic filter router for MQTT client
+ */
+
+/*
+ * Copyright (c) 2022 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGSM - Lightweight GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#ifndef LWGSM_HDR_APP_MQTT_CLIENT_ROUTER_H
+#define LWGSM_HDR_APP_MQTT_CLIENT_ROUTER_H
+
+#include "lwgsm/apps/lwgsm_mqtt_client.h"
+#include "lwgsm/lwgsm_includes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWGSM_APP_MQTT_CLIENT
+ * \defgroup        LWGSM_APP_MQTT_CLIENT_ROUTER Topic router
+ * \brief           Dispatch of received publish messages to handlers per topic filter
+ * \{
+ *
+ * Handlers are registered per topic filter, that may include single-level `+`
+ * and multi-level `#` wildcards, as used in subscribe packet.
+ * Filters are stored in a tree keyed by topic levels, thus matching
+ * cost of received message depends on topic depth rather than number of handlers.
+ *
+ * Every handler with matching filter is called for \ref LWGSM_MQTT_EVT_PUBLISH_RECV event.
+ * Event is sent to callback function of the client only when no filter matches received topic.
+ *
+ * Router only dispatches received messages, subscription on the server
+ * must still be done with \ref lwgsm_mqtt_client_subscribe.
+ */
+
+/**
+ * \brief           Route handler function for received publish message
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event with \ref LWGSM_MQTT_EVT_PUBLISH_RECV type
+ * \param[in]       arg: User argument, set on registration
+ */
+typedef void (*lwgsm_mqtt_route_fn)(lwgsm_mqtt_client_p client, lwgsm_mqtt_evt_t* evt, void* arg);
+
+lwgsmr_t lwgsm_mqtt_client_route_add(lwgsm_mqtt_client_p client, const char* filter, lwgsm_mqtt_route_fn fn,
+                                     void* arg);
+lwgsmr_t lwgsm_mqtt_client_route_remove(lwgsm_mqtt_client_p client, const char* filter, lwgsm_mqtt_route_fn fn,
+                                        void* arg);
+
+/**
+ * \}
+ */
+
+#if !__DOXYGEN__
+
+struct lwgsmi_mqtt_route_node;
+
+/* Router of single client */
+typedef struct {
+    struct lwgsmi_mqtt_route_node* root; /* Root node, allocated with first filter */
+    uint8_t dispatching;                 /* Set while handlers are being called */
+} lwgsmi_mqtt_router_t;
+
+lwgsmr_t lwgsmi_mqtt_router_add(lwgsmi_mqtt_router_t* router, const char* filter, lwgsm_mqtt_route_fn fn, void* arg);
+lwgsmr_t lwgsmi_mqtt_router_remove(lwgsmi_mqtt_router_t* router, const char* filter, lwgsm_mqtt_route_fn fn,
+                                   void* arg);
+size_t lwgsmi_mqtt_router_dispatch(lwgsmi_mqtt_router_t* router, lwgsm_mqtt_client_p client, lwgsm_mqtt_evt_t* evt);
+void lwgsmi_mqtt_router_free(lwgsmi_mqtt_router_t* router);
+
+#endif /* !__DOXYGEN__ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWGSM_HDR_APP_MQTT_CLIENT_ROUTER_H */
@@ -68,6 +68,12 @@ size_t BUF_PREF(buff_write)(BUF_PREF(buff_t) * buff, const void* data, size_t bt
 size_t BUF_PREF(buff_read)(BUF_PREF(buff_t) * buff, void* data, size_t btr);
 size_t BUF_PREF(buff_peek)(BUF_PREF(buff_t) * buff, size_t skip_count, void* data, size_t btp);
 
+/* Zero-copy read/write functions */
+void* BUF_PREF(buff_write_reserve)(BUF_PREF(buff_t) * buff, size_t* len);
+size_t BUF_PREF(buff_write_commit)(BUF_PREF(buff_t) * buff, size_t len);
+const void* BUF_PREF(buff_read_peek)(BUF_PREF(buff_t) * buff, size_t skip_count, size_t* len);
+size_t BUF_PREF(buff_read_advance)(BUF_PREF(buff_t) * buff, size_t len);
+
 /* Buffer size information */
 size_t BUF_PREF(buff_get_free)(BUF_PREF(buff_t) * buff);
 size_t BUF_PREF(buff_get_full)(BUF_PREF(buff_t) * buff);
@@ -53,6 +53,7 @@ lwgsmr_t lwgsm_conn_close(lwgsm_conn_p conn, const uint32_t blocking);
 lwgsmr_t lwgsm_conn_send(lwgsm_conn_p conn, const void* data, size_t btw, size_t* const bw, const uint32_t blocking);
 lwgsmr_t lwgsm_conn_sendto(lwgsm_conn_p conn, const lwgsm_ip_t* const ip, lwgsm_port_t port, const void* data,
                            size_t btw, size_t* bw, const uint32_t blocking);
+lwgsmr_t lwgsm_conn_send_pbuf(lwgsm_conn_p conn, lwgsm_pbuf_p pbuf, size_t* const bw, const uint32_t blocking);
 lwgsmr_t lwgsm_conn_set_arg(lwgsm_conn_p conn, void* const arg);
 void* lwgsm_conn_get_arg(lwgsm_conn_p conn);
 uint8_t lwgsm_conn_is_client(lwgsm_conn_p conn);
@@ -64,6 +65,16 @@ lwgsm_conn_p lwgsm_conn_get_from_evt(lwgsm_evt_t* evt);
 lwgsmr_t lwgsm_conn_write(lwgsm_conn_p conn, const void* data, size_t btw, uint8_t flush, size_t* const mem_available);
 lwgsmr_t lwgsm_conn_recved(lwgsm_conn_p conn, lwgsm_pbuf_p pbuf);
 size_t lwgsm_conn_get_total_recved_count(lwgsm_conn_p conn);
+size_t lwgsm_conn_get_max_send_len(lwgsm_conn_p conn);
+#if LWGSM_CFG_CONN_STATS || __DOXYGEN__
+lwgsmr_t lwgsm_conn_get_stats(lwgsm_conn_p conn, lwgsm_conn_stats_t* stats);
+#endif /* LWGSM_CFG_CONN_STATS || __DOXYGEN__ */
+#if LWGSM_CFG_CONN_SCHED || __DOXYGEN__
+lwgsmr_t lwgsm_conn_set_sched_weight(lwgsm_conn_p conn, uint8_t weight);
+#endif /* LWGSM_CFG_CONN_SCHED || __DOXYGEN__ */
+#if LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT > 0 || __DOXYGEN__
+lwgsmr_t lwgsm_conn_set_write_flush(lwgsm_conn_p conn, uint32_t timeout, size_t threshold);
+#endif /* LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT > 0 || __DOXYGEN__ */
 
 uint8_t lwgsm_conn_get_remote_ip(lwgsm_conn_p conn, lwgsm_ip_t* ip);
 lwgsm_port_t lwgsm_conn_get_remote_port(lwgsm_conn_p conn);
@@ -0,0 +1,69 @@
+/**
+ * \file            lwgsm_conn_pool.h
+ * \brief           Connection pool with keep-alive reuse
+ */
+
+/*
+ * Copyright (c) 2022 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGSM - Lightweight GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#ifndef LWGSM_HDR_CONN_POOL_H
+#define LWGSM_HDR_CONN_POOL_H
+
+#include "lwgsm/lwgsm_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWGSM_CONN
+ * \defgroup        LWGSM_CONN_POOL Connection pool
+ * \brief           Keep-alive connection reuse, keyed by connection type, host and port
+ * \{
+ *
+ * Connections released to the pool stay open and are handed out again
+ * on next acquire for the same remote, saving full `CIPSTART` sequence.
+ *
+ * Idle connections are closed after \ref LWGSM_CFG_CONN_POOL_IDLE_TIMEOUT.
+ * Connections closed by remote side are detected and removed from the pool.
+ */
+
+lwgsmr_t lwgsm_conn_pool_acquire(lwgsm_conn_p* conn, lwgsm_conn_type_t type, const char* const host,
+                                 lwgsm_port_t port, void* const arg, lwgsm_evt_fn conn_evt_fn);
+lwgsmr_t lwgsm_conn_pool_release(lwgsm_conn_p conn, uint8_t reuse);
+size_t lwgsm_conn_pool_get_idle_count(void);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWGSM_HDR_CONN_POOL_H */
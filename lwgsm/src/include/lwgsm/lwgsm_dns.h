@@ -0,0 +1,73 @@
+/**
+ * \file            lwgsm_dns.h
+ * \brief           Domain name resolver with local cache
+ */
+
+/*
+ * Copyright (c) 2022 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGSM - Lightweight GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#ifndef LWGSM_HDR_DNS_H
+#define LWGSM_HDR_DNS_H
+
+#include "lwgsm/lwgsm_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWGSM
+ * \defgroup        LWGSM_DNS Domain name server
+ * \brief           Domain name resolver with local cache
+ * \{
+ *
+ * Host names are resolved with `AT+CDNSGIP` command.
+ * Successful results are kept in fixed-size cache for \ref LWGSM_CFG_DNS_CACHE_TTL milliseconds,
+ * least recently used entry is replaced when cache is full.
+ *
+ * \ref lwgsm_conn_start uses cached IP address instead of host name, to skip name resolution done by device.
+ * Host name not in cache is resolved and cached before connection starts.
+ * Entries in use are resolved again in background shortly before they expire.
+ * SSL connections always use host name, as it is needed by device for server verification.
+ */
+
+lwgsmr_t lwgsm_dns_gethostbyname(const char* host, lwgsm_ip_t* const ip, const lwgsm_api_cmd_evt_fn evt_fn,
+                                 void* const evt_arg, const uint32_t blocking);
+lwgsmr_t lwgsm_dns_prewarm(const char* host);
+uint8_t lwgsm_dns_cache_get(const char* host, lwgsm_ip_t* const ip);
+void lwgsm_dns_cache_flush(void);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWGSM_HDR_DNS_H */
@@ -61,6 +61,12 @@
 #if LWGSM_CFG_CONN || __DOXYGEN__
 #include "lwgsm/lwgsm_conn.h"
 #endif /* LWGSM_CFG_CONN || __DOXYGEN__ */
+#if LWGSM_CFG_CONN_POOL || __DOXYGEN__
+#include "lwgsm/lwgsm_conn_pool.h"
+#endif /* LWGSM_CFG_CONN_POOL || __DOXYGEN__ */
+#if LWGSM_CFG_DNS || __DOXYGEN__
+#include "lwgsm/lwgsm_dns.h"
+#endif /* LWGSM_CFG_DNS || __DOXYGEN__ */
 #if LWGSM_CFG_NETCONN || __DOXYGEN__
 #include "lwgsm/lwgsm_netconn.h"
 #endif /* LWGSM_CFG_NETCONN || __DOXYGEN__ */
@@ -49,6 +49,8 @@ extern "C" {
  */
 
 lwgsmr_t lwgsm_input(const void* data, size_t len);
+void* lwgsm_input_write_reserve(size_t* len);
+lwgsmr_t lwgsm_input_write_commit(size_t len);
 lwgsmr_t lwgsm_input_process(const void* data, size_t len);
 
 /**
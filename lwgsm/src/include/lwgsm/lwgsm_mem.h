@@ -57,7 +57,19 @@ typedef struct {
     size_t size;      /*!< Size in units of bytes of region */
 } lwgsm_mem_region_t;
 
+/**
+ * \brief           Dynamic memory statistics
+ */
+typedef struct {
+    size_t free_bytes;          /*!< Number of currently free bytes, including block metadata */
+    size_t min_ever_free_bytes; /*!< Minimum number of free bytes since memory was assigned */
+    size_t largest_free_block;  /*!< Usable size of largest free block in units of bytes */
+    size_t free_blocks;         /*!< Number of free blocks, higher value means more fragmented memory */
+    size_t failed_allocs;       /*!< Number of failed allocations */
+} lwgsm_mem_stats_t;
+
 uint8_t lwgsm_mem_assignmemory(const lwgsm_mem_region_t* regions, size_t size);
+lwgsmr_t lwgsm_mem_get_stats(lwgsm_mem_stats_t* stats);
 
 #endif /* !LWGSM_CFG_MEM_CUSTOM || __DOXYGEN__ */
 
@@ -67,6 +79,84 @@ void* lwgsm_mem_calloc(size_t num, size_t size);
 void lwgsm_mem_free(void* ptr);
 uint8_t lwgsm_mem_free_s(void** ptr);
 
+/**
+ * \brief           Memory allocation tag, used for per-subsystem budgets
+ */
+typedef enum {
+    LWGSM_MEM_TAG_GENERAL = 0x00, /*!< Allocations without dedicated budget */
+    LWGSM_MEM_TAG_IPD,            /*!< Packet buffers for received network data */
+    LWGSM_MEM_TAG_MSG,            /*!< Command messages */
+    LWGSM_MEM_TAG_TIMEOUT,        /*!< Timeout entries */
+    LWGSM_MEM_TAG_CONN,           /*!< Connection write buffers */
+    LWGSM_MEM_TAG_MQTT,           /*!< MQTT client structures and buffers */
+    LWGSM_MEM_TAG_NETCONN,        /*!< Netconn structures and buffers */
+    LWGSM_MEM_TAG_END,            /*!< Last element, number of tags */
+} lwgsm_mem_tag_t;
+
+/**
+ * \brief           Memory budget statistics for single tag
+ */
+typedef struct {
+    size_t limit;    /*!< Budget in units of bytes, `0` when unlimited */
+    size_t used;     /*!< Currently allocated bytes, including tag header */
+    size_t max_used; /*!< Maximum allocated bytes */
+    size_t failed;   /*!< Number of refused or failed allocations */
+} lwgsm_mem_budget_stats_t;
+
+#if LWGSM_CFG_MEM_BUDGET || __DOXYGEN__
+
+void* lwgsm_mem_malloc_tag(lwgsm_mem_tag_t tag, size_t size);
+void* lwgsm_mem_calloc_tag(lwgsm_mem_tag_t tag, size_t num, size_t size);
+void lwgsm_mem_free_tag(void* ptr);
+uint8_t lwgsm_mem_free_tag_s(void** ptr);
+lwgsmr_t lwgsm_mem_set_budget(lwgsm_mem_tag_t tag, size_t limit);
+lwgsmr_t lwgsm_mem_get_budget_stats(lwgsm_mem_tag_t tag, lwgsm_mem_budget_stats_t* stats);
+
+#else /* LWGSM_CFG_MEM_BUDGET || __DOXYGEN__ */
+
+#define lwgsm_mem_malloc_tag(tag, size)      lwgsm_mem_malloc(size)
+#define lwgsm_mem_calloc_tag(tag, num, size) lwgsm_mem_calloc((num), (size))
+#define lwgsm_mem_free_tag(ptr)              lwgsm_mem_free(ptr)
+#define lwgsm_mem_free_tag_s(ptr)            lwgsm_mem_free_s(ptr)
+
+#endif /* !(LWGSM_CFG_MEM_BUDGET || __DOXYGEN__) */
+
+/**
+ * \brief           Static memory pool identifier
+ */
+typedef enum {
+    LWGSM_MEM_POOL_MSG = 0x00,      /*!< Command messages */
+    LWGSM_MEM_POOL_TIMEOUT,         /*!< Timeout entries */
+    LWGSM_MEM_POOL_EVT_FUNC,        /*!< Event function entries */
+    LWGSM_MEM_POOL_CONN_BUFF,       /*!< Connection write buffers */
+    LWGSM_MEM_POOL_PBUF_SLICE,      /*!< Packet buffer slice headers */
+    LWGSM_MEM_POOL_NETCONN,         /*!< Netconn structures */
+    LWGSM_MEM_POOL_NETCONN_BUFF,    /*!< Netconn write buffers */
+    LWGSM_MEM_POOL_MQTT_CLIENT,     /*!< MQTT clients with TX and RX buffers */
+    LWGSM_MEM_POOL_MQTT_API_CLIENT, /*!< MQTT API clients */
+    LWGSM_MEM_POOL_MQTT_API_BUF,    /*!< MQTT API received publish buffers */
+    LWGSM_MEM_POOL_MQTT_RETX,       /*!< MQTT packet copies for retransmission */
+    LWGSM_MEM_POOL_MQTT_ROUTE,      /*!< MQTT topic router nodes and handlers */
+    LWGSM_MEM_POOL_END,             /*!< Last element, number of pools */
+} lwgsm_mem_pool_id_t;
+
+/**
+ * \brief           Static memory pool statistics
+ */
+typedef struct {
+    size_t size;     /*!< Size of single block in units of bytes */
+    size_t total;    /*!< Number of all blocks in pool */
+    size_t used;     /*!< Number of currently allocated blocks */
+    size_t max_used; /*!< Maximal number of allocated blocks at the same time */
+    size_t failed;   /*!< Number of failed allocations, when pool was empty */
+} lwgsm_mem_pool_stats_t;
+
+#if LWGSM_CFG_STATIC_ALLOC || __DOXYGEN__
+
+lwgsmr_t lwgsm_mem_pool_get_stats(lwgsm_mem_pool_id_t id, lwgsm_mem_pool_stats_t* stats);
+
+#endif /* LWGSM_CFG_STATIC_ALLOC || __DOXYGEN__ */
+
 /**
  * \}
  */
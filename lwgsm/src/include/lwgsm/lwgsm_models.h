@@ -32,10 +32,10 @@
  * Version:         v0.1.1
  */
 
-/* Order: Device name; Device model identification, Is_2G, Is_LTE */
-LWGSM_DEVICE_MODEL_ENTRY(SIM800x, "SIM800", 1, 0)
-LWGSM_DEVICE_MODEL_ENTRY(SIM900x, "SIM900", 1, 0)
-//LWGSM_DEVICE_MODEL_ENTRY(SIM7000x, "SIM7000", 1, 0)
-//LWGSM_DEVICE_MODEL_ENTRY(SIM7020x, "SIM7020", 1, 0)
+/* Order: Device name; Device model identification, Is_2G, Is_LTE, Max data length for single send command or 0 for default */
+LWGSM_DEVICE_MODEL_ENTRY(SIM800x, "SIM800", 1, 0, 0)
+LWGSM_DEVICE_MODEL_ENTRY(SIM900x, "SIM900", 1, 0, 0)
+//LWGSM_DEVICE_MODEL_ENTRY(SIM7000x, "SIM7000", 1, 0, 0)
+//LWGSM_DEVICE_MODEL_ENTRY(SIM7020x, "SIM7020", 1, 0, 1024)
 
 #undef LWGSM_DEVICE_MODEL_ENTRY
\ No newline at end of file
@@ -96,6 +96,167 @@
 #define LWGSM_CFG_MEM_ALIGNMENT 4
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` two-level segregated-fit allocator for dynamic memory
+ *
+ * When enabled, built-in allocator uses segregated free lists indexed by block size
+ * with constant allocation and free time and immediate coalescing of neighbour blocks.
+ * When disabled, first-fit allocator with single free list is used.
+ *
+ * \note            Both allocators use same \ref lwgsm_mem_assignmemory interface.
+ *                  Option has no effect when \ref LWGSM_CFG_MEM_CUSTOM is enabled
+ */
+#ifndef LWGSM_CFG_MEM_TLSF
+#define LWGSM_CFG_MEM_TLSF 0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` per-subsystem memory budgets
+ *
+ * When enabled, stack allocations are tagged by subsystem and accounted separately.
+ * Allocation is refused once subsystem reaches its budget, so that one subsystem,
+ * such as flooded receive connection, cannot exhaust memory needed by others.
+ *
+ * Every tagged allocation uses small additional header to keep tag and size.
+ *
+ * \note            Budgets are set with `LWGSM_CFG_MEM_BUDGET_*` options
+ *                  and may be changed at runtime with \ref lwgsm_mem_set_budget
+ */
+#ifndef LWGSM_CFG_MEM_BUDGET
+#define LWGSM_CFG_MEM_BUDGET 0
+#endif
+
+/**
+ * \brief           Memory budget in units of bytes for received network data packet buffers
+ *
+ * When budget is reached, further received data are dropped until application frees packet buffers.
+ * Set to `0` for unlimited budget
+ *
+ * \note            Used only when \ref LWGSM_CFG_MEM_BUDGET is enabled
+ */
+#ifndef LWGSM_CFG_MEM_BUDGET_IPD
+#define LWGSM_CFG_MEM_BUDGET_IPD 0
+#endif
+
+/**
+ * \brief           Memory budget in units of bytes for command messages
+ *
+ * Set to `0` for unlimited budget
+ *
+ * \note            Used only when \ref LWGSM_CFG_MEM_BUDGET is enabled
+ */
+#ifndef LWGSM_CFG_MEM_BUDGET_MSG
+#define LWGSM_CFG_MEM_BUDGET_MSG 0
+#endif
+
+/**
+ * \brief           Memory budget in units of bytes for timeout entries
+ *
+ * Set to `0` for unlimited budget
+ *
+ * \note            Used only when \ref LWGSM_CFG_MEM_BUDGET is enabled
+ */
+#ifndef LWGSM_CFG_MEM_BUDGET_TIMEOUT
+#define LWGSM_CFG_MEM_BUDGET_TIMEOUT 0
+#endif
+
+/**
+ * \brief           Memory budget in units of bytes for connection write buffers
+ *
+ * Set to `0` for unlimited budget
+ *
+ * \note            Used only when \ref LWGSM_CFG_MEM_BUDGET is enabled
+ */
+#ifndef LWGSM_CFG_MEM_BUDGET_CONN
+#define LWGSM_CFG_MEM_BUDGET_CONN 0
+#endif
+
+/**
+ * \brief           Memory budget in units of bytes for MQTT client structures and buffers
+ *
+ * Set to `0` for unlimited budget
+ *
+ * \note            Used only when \ref LWGSM_CFG_MEM_BUDGET is enabled
+ */
+#ifndef LWGSM_CFG_MEM_BUDGET_MQTT
+#define LWGSM_CFG_MEM_BUDGET_MQTT 0
+#endif
+
+/**
+ * \brief           Memory budget in units of bytes for netconn structures and buffers
+ *
+ * Set to `0` for unlimited budget
+ *
+ * \note            Used only when \ref LWGSM_CFG_MEM_BUDGET is enabled
+ */
+#ifndef LWGSM_CFG_MEM_BUDGET_NETCONN
+#define LWGSM_CFG_MEM_BUDGET_NETCONN 0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` fully static memory allocation
+ *
+ * When enabled, runtime objects (command messages, timeouts, packet buffers, connection write buffers,
+ * event function entries, netconns and MQTT clients with their buffers) are taken from
+ * fixed-size pools, sized at compile time with `LWGSM_CFG_STATIC_*` options.
+ * Dynamic memory functions are then only used during \ref lwgsm_init.
+ *
+ * When pool is empty, functions return \ref lwgsmERRMEMPOOL (or `NULL`)
+ * and pool failure counter is increased, see \ref lwgsm_mem_pool_get_stats.
+ *
+ * \note            \ref LWGSM_CFG_PBUF_POOL must be enabled. Packet buffers larger
+ *                  than largest pool class cannot be allocated in this mode
+ */
+#ifndef LWGSM_CFG_STATIC_ALLOC
+#define LWGSM_CFG_STATIC_ALLOC 0
+#endif
+
+/**
+ * \brief           Number of command messages in static pool
+ *
+ * \note            Used only when \ref LWGSM_CFG_STATIC_ALLOC is enabled
+ */
+#ifndef LWGSM_CFG_STATIC_MSG_NUM
+#define LWGSM_CFG_STATIC_MSG_NUM 8
+#endif
+
+/**
+ * \brief           Number of timeout entries in static pool
+ *
+ * \note            Used only when \ref LWGSM_CFG_STATIC_ALLOC is enabled
+ */
+#ifndef LWGSM_CFG_STATIC_TIMEOUT_NUM
+#define LWGSM_CFG_STATIC_TIMEOUT_NUM 8
+#endif
+
+/**
+ * \brief           Number of event function entries for \ref lwgsm_evt_register in static pool
+ *
+ * \note            Used only when \ref LWGSM_CFG_STATIC_ALLOC is enabled
+ */
+#ifndef LWGSM_CFG_STATIC_EVT_FUNC_NUM
+#define LWGSM_CFG_STATIC_EVT_FUNC_NUM 4
+#endif
+
+/**
+ * \brief           Number of connection write buffers, each \ref LWGSM_CFG_CONN_MAX_DATA_LEN bytes long, in static pool
+ *
+ * \note            Used only when \ref LWGSM_CFG_STATIC_ALLOC is enabled
+ */
+#ifndef LWGSM_CFG_STATIC_CONN_BUFF_NUM
+#define LWGSM_CFG_STATIC_CONN_BUFF_NUM 2
+#endif
+
+/**
+ * \brief           Number of packet buffer slice headers in static pool
+ *
+ * \note            Used only when \ref LWGSM_CFG_STATIC_ALLOC is enabled
+ * \sa              lwgsm_pbuf_slice
+ */
+#ifndef LWGSM_CFG_STATIC_PBUF_SLICE_NUM
+#define LWGSM_CFG_STATIC_PBUF_SLICE_NUM 4
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` callback function and custom parameter for API functions
  *
@@ -127,6 +288,10 @@
  * \note            This is limitation of GSM AT commands and on systems where RAM
  *                  is not an issue, it should be set to maximal value (`1460`)
  *                  to optimize data transfer speed performance
+ *
+ * \note            Value is upper limit only. Actual length per connection is queried
+ *                  from device with `AT+CIPSEND?` when connection becomes active,
+ *                  see \ref lwgsm_conn_get_max_send_len
  */
 #ifndef LWGSM_CFG_CONN_MAX_DATA_LEN
 #define LWGSM_CFG_CONN_MAX_DATA_LEN 1460
@@ -151,6 +316,177 @@
 #define LWGSM_CFG_IPD_MAX_BUFF_SIZE 1460
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` fixed-size packet buffer pools
+ *
+ * Packet buffers for network receive data are allocated from static pools in `3` size classes
+ * with constant allocation time, instead of from heap memory.
+ * Buffers bigger than largest class and buffers allocated by application
+ * with \ref lwgsm_pbuf_new are still allocated from heap, unless \ref LWGSM_CFG_STATIC_ALLOC is enabled.
+ *
+ * \sa              LWGSM_CFG_PBUF_POOL_RESERVE
+ */
+#ifndef LWGSM_CFG_PBUF_POOL
+#define LWGSM_CFG_PBUF_POOL 0
+#endif
+
+/**
+ * \brief           Payload size of small packet buffer pool class
+ */
+#ifndef LWGSM_CFG_PBUF_POOL_SMALL_SIZE
+#define LWGSM_CFG_PBUF_POOL_SMALL_SIZE 128
+#endif
+
+/**
+ * \brief           Number of packet buffers in small pool class
+ */
+#ifndef LWGSM_CFG_PBUF_POOL_SMALL_NUM
+#define LWGSM_CFG_PBUF_POOL_SMALL_NUM 8
+#endif
+
+/**
+ * \brief           Payload size of medium packet buffer pool class
+ */
+#ifndef LWGSM_CFG_PBUF_POOL_MEDIUM_SIZE
+#define LWGSM_CFG_PBUF_POOL_MEDIUM_SIZE 512
+#endif
+
+/**
+ * \brief           Number of packet buffers in medium pool class
+ */
+#ifndef LWGSM_CFG_PBUF_POOL_MEDIUM_NUM
+#define LWGSM_CFG_PBUF_POOL_MEDIUM_NUM 4
+#endif
+
+/**
+ * \brief           Payload size of large packet buffer pool class
+ */
+#ifndef LWGSM_CFG_PBUF_POOL_LARGE_SIZE
+#define LWGSM_CFG_PBUF_POOL_LARGE_SIZE LWGSM_CFG_IPD_MAX_BUFF_SIZE
+#endif
+
+/**
+ * \brief           Number of packet buffers in large pool class
+ */
+#ifndef LWGSM_CFG_PBUF_POOL_LARGE_NUM
+#define LWGSM_CFG_PBUF_POOL_LARGE_NUM 4
+#endif
+
+/**
+ * \brief           Number of large packet buffers reserved for network receive data
+ *
+ * Reserved buffers are used only by receive path, when all other buffers are taken,
+ * so that incoming data are not dropped when application holds many packet buffers
+ * allocated from pools with \ref LWGSM_CFG_STATIC_ALLOC enabled
+ *
+ * \note            Value must be smaller than \ref LWGSM_CFG_PBUF_POOL_LARGE_NUM
+ */
+#ifndef LWGSM_CFG_PBUF_POOL_RESERVE
+#define LWGSM_CFG_PBUF_POOL_RESERVE 1
+#endif
+
+/**
+ * \brief           Inactivity time in units of milliseconds after which
+ *                  data written with \ref lwgsm_conn_write are sent automatically
+ *
+ * Small writes are coalesced in connection write buffer and sent as single `CIPSEND` command,
+ * either when application stops writing for this time or when \ref LWGSM_CFG_CONN_WRITE_FLUSH_THRESHOLD is reached.
+ *
+ * \note            Set to `0` to disable automatic flush. Application must then call
+ *                  \ref lwgsm_conn_write with `flush` parameter set to `1` to send the data
+ * \note            Value is default for all connections, use \ref lwgsm_conn_set_write_flush
+ *                  to change it for single connection
+ */
+#ifndef LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT
+#define LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT 0
+#endif
+
+/**
+ * \brief           Number of bytes in connection write buffer that triggers immediate send
+ *
+ * \note            Used only when \ref LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT is enabled.
+ *                  Buffer is always sent when full, regardless of this value.
+ *                  Value is default for all connections, use \ref lwgsm_conn_set_write_flush
+ *                  to change it for single connection
+ */
+#ifndef LWGSM_CFG_CONN_WRITE_FLUSH_THRESHOLD
+#define LWGSM_CFG_CONN_WRITE_FLUSH_THRESHOLD LWGSM_CFG_CONN_MAX_DATA_LEN
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` per-connection statistics
+ *
+ * Statistics are available with \ref lwgsm_conn_get_stats function
+ * and are reset each time connection becomes active
+ */
+#ifndef LWGSM_CFG_CONN_STATS
+#define LWGSM_CFG_CONN_STATS 0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` connection pool with keep-alive reuse
+ *
+ * \note            \ref LWGSM_CFG_CONN must be enabled to use this feature
+ * \sa              LWGSM_CONN_POOL
+ */
+#ifndef LWGSM_CFG_CONN_POOL
+#define LWGSM_CFG_CONN_POOL 0
+#endif
+
+/**
+ * \brief           Maximal number of connections tracked by the pool
+ */
+#ifndef LWGSM_CFG_CONN_POOL_SIZE
+#define LWGSM_CFG_CONN_POOL_SIZE LWGSM_CFG_MAX_CONNS
+#endif
+
+/**
+ * \brief           Maximal length of host name (including `NULL` termination) for pooled connection
+ */
+#ifndef LWGSM_CFG_CONN_POOL_HOST_MAX_LEN
+#define LWGSM_CFG_CONN_POOL_HOST_MAX_LEN 64
+#endif
+
+/**
+ * \brief           Time in units of milliseconds after which idle pooled connection is closed
+ */
+#ifndef LWGSM_CFG_CONN_POOL_IDLE_TIMEOUT
+#define LWGSM_CFG_CONN_POOL_IDLE_TIMEOUT 30000
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` fair send scheduling between connections
+ *
+ * Send commands are kept in per-connection transmit queues
+ * and sent chunk by chunk in round-robin order between connections,
+ * so that large transfer on one connection does not block other connections.
+ *
+ * \sa              LWGSM_CFG_CONN_SCHED_WEIGHT
+ */
+#ifndef LWGSM_CFG_CONN_SCHED
+#define LWGSM_CFG_CONN_SCHED 0
+#endif
+
+/**
+ * \brief           Default number of `CIPSEND` chunks connection may send
+ *                  before it gives turn to other connections
+ *
+ * Value may be changed per connection with \ref lwgsm_conn_set_sched_weight
+ */
+#ifndef LWGSM_CFG_CONN_SCHED_WEIGHT
+#define LWGSM_CFG_CONN_SCHED_WEIGHT 1
+#endif
+
+/**
+ * \brief           Maximal number of send messages waiting in transmit queue of single connection
+ *
+ * When queue is full, blocking send waits for free slot
+ * and non-blocking send fails with \ref lwgsmERRMEM
+ */
+#ifndef LWGSM_CFG_CONN_SCHED_QUEUE_LEN
+#define LWGSM_CFG_CONN_SCHED_QUEUE_LEN LWGSM_CFG_THREAD_PRODUCER_MBOX_SIZE
+#endif
+
 /**
  * \}
  */
@@ -179,6 +515,19 @@
 #define LWGSM_CFG_RCV_BUFF_SIZE 0x400
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` power-of-two ring buffer mode
+ *
+ * When enabled, all ring buffers (input buffer and MQTT TX buffer) have power-of-two size
+ * and wrap read and write pointers with mask instead of compare and subtract.
+ * Sizes passed to \ref lwgsm_buff_init are rounded up to next power of `2`.
+ *
+ * \note            \ref LWGSM_CFG_RCV_BUFF_SIZE must be power of `2` when enabled
+ */
+#ifndef LWGSM_CFG_BUFF_POW2
+#define LWGSM_CFG_BUFF_POW2 0
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` reset sequence after \ref lwgsm_init call
  *
@@ -527,6 +876,15 @@
 #define LWGSM_CFG_NETCONN_RECEIVE_QUEUE_LEN 8
 #endif
 
+/**
+ * \brief           Number of netconn structures and netconn write buffers in static pools
+ *
+ * \note            Used only when \ref LWGSM_CFG_STATIC_ALLOC is enabled
+ */
+#ifndef LWGSM_CFG_STATIC_NETCONN_NUM
+#define LWGSM_CFG_STATIC_NETCONN_NUM LWGSM_CFG_MAX_CONNS
+#endif
+
 /**
  * \}
  */
@@ -540,11 +898,41 @@
 /**
  * \brief           Maximal number of open MQTT requests at a time
  *
+ * Used by \ref lwgsm_mqtt_client_new. Use \ref lwgsm_mqtt_client_new_ex to set different value per client.
+ *
+ * \note            When \ref LWGSM_CFG_STATIC_ALLOC is enabled, this is also maximal value for every client
  */
 #ifndef LWGSM_CFG_MQTT_MAX_REQUESTS
 #define LWGSM_CFG_MQTT_MAX_REQUESTS 8
 #endif
 
+/**
+ * \brief           Maximal number of TX buffer segments submitted to connection at a time
+ *
+ * Each segment is sent with separate \ref lwgsm_conn_send call directly from MQTT TX buffer.
+ * With value `1`, next segment is sent only after previous one has been confirmed.
+ * Value of `2` or more allows both parts of wrapped TX buffer and newly written packets
+ * to be queued while previous data are still being sent.
+ *
+ * \note            Every segment in flight uses one message from producer queue
+ */
+#ifndef LWGSM_CFG_MQTT_MAX_SENDS_IN_FLIGHT
+#define LWGSM_CFG_MQTT_MAX_SENDS_IN_FLIGHT 2
+#endif
+
+/**
+ * \brief           Maximal number of response packets waiting for space in MQTT TX buffer
+ *
+ * `PUBACK`, `PUBREC`, `PUBREL` and `PUBCOMP` responses cannot be written
+ * in the middle of streamed publish payload or to full TX buffer.
+ * They are kept in client structure and written at next packet boundary.
+ *
+ * \note            Each entry takes `4` bytes of memory in client structure
+ */
+#ifndef LWGSM_CFG_MQTT_PENDING_RESP_NUM
+#define LWGSM_CFG_MQTT_PENDING_RESP_NUM 8
+#endif
+
 /**
  * \brief           Size of MQTT API message queue for received messages
  *
@@ -553,6 +941,234 @@
 #define LWGSM_CFG_MQTT_API_MBOX_SIZE 8
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` zero-copy receive in MQTT API
+ *
+ * When received publish packet is contained in single received packet buffer,
+ * API buffer keeps reference to it and topic and payload point directly to its memory.
+ * Packet buffer is released with \ref lwgsm_mqtt_client_api_buf_free.
+ * Packets assembled from multiple received buffers are still copied.
+ *
+ * \note            Topic and payload are not `NULL` terminated in zero-copy buffers.
+ *                  Referenced packet buffers stay allocated until API buffers are freed
+ */
+#ifndef LWGSM_CFG_MQTT_API_ZERO_COPY
+#define LWGSM_CFG_MQTT_API_ZERO_COPY 0
+#endif
+
+/**
+ * \brief           Number of MQTT clients in static pool
+ *
+ * \note            Used only when \ref LWGSM_CFG_STATIC_ALLOC is enabled
+ */
+#ifndef LWGSM_CFG_STATIC_MQTT_CLIENT_NUM
+#define LWGSM_CFG_STATIC_MQTT_CLIENT_NUM 1
+#endif
+
+/**
+ * \brief           Maximal TX buffer length of MQTT client in static pool
+ *
+ * \note            Used only when \ref LWGSM_CFG_STATIC_ALLOC is enabled
+ */
+#ifndef LWGSM_CFG_STATIC_MQTT_TX_BUFF_LEN
+#define LWGSM_CFG_STATIC_MQTT_TX_BUFF_LEN 256
+#endif
+
+/**
+ * \brief           Maximal RX buffer length of MQTT client in static pool
+ *
+ * \note            Used only when \ref LWGSM_CFG_STATIC_ALLOC is enabled
+ */
+#ifndef LWGSM_CFG_STATIC_MQTT_RX_BUFF_LEN
+#define LWGSM_CFG_STATIC_MQTT_RX_BUFF_LEN 256
+#endif
+
+/**
+ * \brief           Number of received publish buffers of MQTT API in static pool
+ *
+ * \note            Used only when \ref LWGSM_CFG_STATIC_ALLOC is enabled
+ */
+#ifndef LWGSM_CFG_STATIC_MQTT_API_BUF_NUM
+#define LWGSM_CFG_STATIC_MQTT_API_BUF_NUM LWGSM_CFG_MQTT_API_MBOX_SIZE
+#endif
+
+/**
+ * \brief           Size of single received publish buffer of MQTT API in static pool,
+ *                  including buffer structure, topic and payload
+ *
+ * Received publish messages, which do not fit to this size, are dropped
+ *
+ * \note            Used only when \ref LWGSM_CFG_STATIC_ALLOC is enabled
+ */
+#ifndef LWGSM_CFG_STATIC_MQTT_API_BUF_SIZE
+#define LWGSM_CFG_STATIC_MQTT_API_BUF_SIZE 256
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` retransmission of unacknowledged MQTT packets
+ *
+ * Copy of every publish with QoS `1` or `2`, subscribe and unsubscribe packet is kept
+ * until server acknowledges it. Packet is sent again with `DUP` flag when no reply is received in time,
+ * with exponentially increasing timeout. Request fails with \ref lwgsmTIMEOUT result
+ * after \ref LWGSM_CFG_MQTT_RETRANSMIT_MAX_RETRIES retransmissions.
+ *
+ * When \ref lwgsm_mqtt_client_info_t::keep_session is set, unacknowledged publish packets
+ * survive connection loss and are sent again after reconnection.
+ *
+ * \note            MQTT 5.0 does not allow to send packets again on active connection,
+ *                  with such connection packets are sent again only after reconnection.
+ *                  Request still fails with \ref lwgsmTIMEOUT result when no reply is received
+ *                  within the same timeouts
+ */
+#ifndef LWGSM_CFG_MQTT_RETRANSMIT
+#define LWGSM_CFG_MQTT_RETRANSMIT 0
+#endif
+
+/**
+ * \brief           Initial timeout in units of milliseconds to wait for server reply before retransmission
+ *
+ * \note            Timeouts are checked every \ref LWGSM_CFG_CONN_POLL_INTERVAL milliseconds
+ */
+#ifndef LWGSM_CFG_MQTT_RETRANSMIT_TIMEOUT
+#define LWGSM_CFG_MQTT_RETRANSMIT_TIMEOUT 5000
+#endif
+
+/**
+ * \brief           Maximal timeout in units of milliseconds between retransmissions
+ *
+ * Timeout doubles after every retransmission, until it reaches this value
+ */
+#ifndef LWGSM_CFG_MQTT_RETRANSMIT_TIMEOUT_MAX
+#define LWGSM_CFG_MQTT_RETRANSMIT_TIMEOUT_MAX 60000
+#endif
+
+/**
+ * \brief           Maximal number of retransmissions before request fails
+ */
+#ifndef LWGSM_CFG_MQTT_RETRANSMIT_MAX_RETRIES
+#define LWGSM_CFG_MQTT_RETRANSMIT_MAX_RETRIES 4
+#endif
+
+/**
+ * \brief           Number of packet copies for retransmission in static pool,
+ *                  each of \ref LWGSM_CFG_STATIC_MQTT_TX_BUFF_LEN bytes
+ *
+ * \note            Used only when \ref LWGSM_CFG_STATIC_ALLOC and \ref LWGSM_CFG_MQTT_RETRANSMIT are enabled
+ */
+#ifndef LWGSM_CFG_STATIC_MQTT_RETX_NUM
+#define LWGSM_CFG_STATIC_MQTT_RETX_NUM (LWGSM_CFG_STATIC_MQTT_CLIENT_NUM * LWGSM_CFG_MQTT_MAX_REQUESTS)
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` persistent store-and-forward queue for MQTT client
+ *
+ * When queue is set with \ref lwgsm_mqtt_client_set_queue, published messages are stored in the queue
+ * until acknowledged, and messages published while client is not connected are sent after reconnection.
+ *
+ * \sa              LWGSM_APP_MQTT_CLIENT_QUEUE
+ */
+#ifndef LWGSM_CFG_MQTT_QUEUE
+#define LWGSM_CFG_MQTT_QUEUE 0
+#endif
+
+/**
+ * \brief           Default number of messages sent from queue per second, after reconnection
+ *
+ * Set to `0` to send as fast as connection allows.
+ * Use \ref lwgsm_mqtt_queue_set_drain_rate to change it for each queue
+ */
+#ifndef LWGSM_CFG_MQTT_QUEUE_DRAIN_RATE
+#define LWGSM_CFG_MQTT_QUEUE_DRAIN_RATE 10
+#endif
+
+/**
+ * \brief           Maximal number of messages from queue sent and waiting for acknowledge at a time
+ *
+ * \note            Value must be between `1` and `32`
+ */
+#ifndef LWGSM_CFG_MQTT_QUEUE_WINDOW
+#define LWGSM_CFG_MQTT_QUEUE_WINDOW 4
+#endif
+
+/**
+ * \brief           Number of acknowledged messages covered by single acknowledge record in storage
+ *
+ * Higher value reduces storage writes, but more messages may be sent again after reset.
+ * Record is written by \ref lwgsm_mqtt_queue_append, or by \ref lwgsm_mqtt_queue_flush regardless of batch size.
+ * Acknowledge record is always written when queue becomes empty.
+ */
+#ifndef LWGSM_CFG_MQTT_QUEUE_ACK_BATCH
+#define LWGSM_CFG_MQTT_QUEUE_ACK_BATCH 16
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` topic filter router for received publish messages
+ *
+ * When enabled, handlers may be registered per topic filter with \ref lwgsm_mqtt_client_route_add.
+ * Received message is dispatched to all handlers with matching filter,
+ * and to client event callback only when no filter matches.
+ *
+ * \sa              LWGSM_APP_MQTT_CLIENT_ROUTER
+ */
+#ifndef LWGSM_CFG_MQTT_ROUTER
+#define LWGSM_CFG_MQTT_ROUTER 0
+#endif
+
+/**
+ * \brief           Number of router entries in static pool, shared by all clients
+ *
+ * Every topic level of registered filters, every registered handler
+ * and root of every client with at least one filter take one entry
+ *
+ * \note            Used only when \ref LWGSM_CFG_STATIC_ALLOC and \ref LWGSM_CFG_MQTT_ROUTER are enabled
+ */
+#ifndef LWGSM_CFG_STATIC_MQTT_ROUTE_NUM
+#define LWGSM_CFG_STATIC_MQTT_ROUTE_NUM 16
+#endif
+
+/**
+ * \brief           Maximal length of single topic level in filter, in units of bytes
+ *
+ * \note            Used only when \ref LWGSM_CFG_STATIC_ALLOC and \ref LWGSM_CFG_MQTT_ROUTER are enabled
+ */
+#ifndef LWGSM_CFG_STATIC_MQTT_ROUTE_LEVEL_LEN
+#define LWGSM_CFG_STATIC_MQTT_ROUTE_LEVEL_LEN 16
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` MQTT 5.0 protocol support
+ *
+ * Protocol version is selected for each connection with `protocol_version` member
+ * of \ref lwgsm_mqtt_client_info_t structure.
+ * With MQTT 5.0, server limits from CONNACK properties are respected,
+ * receive maximum of server limits number of publish packets waiting for acknowledge
+ * and topic aliases are assigned automatically to frequently used topics.
+ */
+#ifndef LWGSM_CFG_MQTT_V5
+#define LWGSM_CFG_MQTT_V5 0
+#endif
+
+/**
+ * \brief           Maximal number of topic aliases used by client on MQTT 5.0 connection
+ *
+ * Actual number is limited by topic alias maximum, received from server.
+ * Each alias takes \ref LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_LEN bytes of memory in client structure
+ *
+ * \note            Value must be between `1` and `255`
+ */
+#ifndef LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_NUM
+#define LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_NUM 8
+#endif
+
+/**
+ * \brief           Maximal topic length, in units of bytes, to be replaced with topic alias
+ *
+ * \note            Value must be between `1` and `255`
+ */
+#ifndef LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_LEN
+#define LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_LEN 48
+#endif
+
 /**
  * \brief           Set debug level for MQTT client module
  *
@@ -656,6 +1272,50 @@
 #define LWGSM_CFG_PING 0
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` DNS API with local cache.
+ *
+ * \note            \ref LWGSM_CFG_NETWORK must be enabled to use connection feature
+ * \sa              LWGSM_DNS
+ */
+#ifndef LWGSM_CFG_DNS
+#define LWGSM_CFG_DNS 0
+#endif
+
+/**
+ * \brief           Number of entries in DNS cache
+ */
+#ifndef LWGSM_CFG_DNS_CACHE_SIZE
+#define LWGSM_CFG_DNS_CACHE_SIZE 4
+#endif
+
+/**
+ * \brief           Time in units of milliseconds cached DNS entry is considered valid
+ *
+ * `AT+CDNSGIP` command does not report record TTL, hence fixed time is used for all entries
+ */
+#ifndef LWGSM_CFG_DNS_CACHE_TTL
+#define LWGSM_CFG_DNS_CACHE_TTL 300000
+#endif
+
+/**
+ * \brief           Time in units of milliseconds before cached DNS entry expires,
+ *                  when lookup of the entry starts resolving it again in background
+ *
+ * Entries in use are kept valid this way, without waiting for name resolution.
+ * Set to `0` to disable refresh
+ */
+#ifndef LWGSM_CFG_DNS_CACHE_REFRESH
+#define LWGSM_CFG_DNS_CACHE_REFRESH 30000
+#endif
+
+/**
+ * \brief           Maximal length of host name (including `NULL` termination) kept in DNS cache
+ */
+#ifndef LWGSM_CFG_DNS_HOST_MAX_LEN
+#define LWGSM_CFG_DNS_HOST_MAX_LEN 64
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` USSD API.
  *
@@ -743,6 +1403,63 @@ void *  my_memset(void* dst, int b, size_t len);
 #endif /* LWGSM_CFG_INPUT_USE_PROCESS */
 #endif /* !LWGSM_CFG_OS */
 
+#if LWGSM_CFG_PBUF_POOL && LWGSM_CFG_PBUF_POOL_RESERVE >= LWGSM_CFG_PBUF_POOL_LARGE_NUM
+#error "LWGSM_CFG_PBUF_POOL_RESERVE must be smaller than LWGSM_CFG_PBUF_POOL_LARGE_NUM!"
+#endif /* LWGSM_CFG_PBUF_POOL && LWGSM_CFG_PBUF_POOL_RESERVE >= LWGSM_CFG_PBUF_POOL_LARGE_NUM */
+
+#if LWGSM_CFG_CONN_POOL && !LWGSM_CFG_CONN
+#error "LWGSM_CFG_CONN_POOL may only be enabled when LWGSM_CFG_CONN is enabled!"
+#endif /* LWGSM_CFG_CONN_POOL && !LWGSM_CFG_CONN */
+
+#if LWGSM_CFG_CONN_SCHED && !LWGSM_CFG_CONN
+#error "LWGSM_CFG_CONN_SCHED may only be enabled when LWGSM_CFG_CONN is enabled!"
+#endif /* LWGSM_CFG_CONN_SCHED && !LWGSM_CFG_CONN */
+
+#if LWGSM_CFG_CONN_SCHED && LWGSM_CFG_CONN_SCHED_QUEUE_LEN == 0
+#error "LWGSM_CFG_CONN_SCHED_QUEUE_LEN must be greater than 0!"
+#endif /* LWGSM_CFG_CONN_SCHED && LWGSM_CFG_CONN_SCHED_QUEUE_LEN == 0 */
+
+#if LWGSM_CFG_DNS && !LWGSM_CFG_NETWORK
+#error "LWGSM_CFG_DNS may only be enabled when LWGSM_CFG_NETWORK is enabled!"
+#endif /* LWGSM_CFG_DNS && !LWGSM_CFG_NETWORK */
+
+#if LWGSM_CFG_DNS && LWGSM_CFG_DNS_CACHE_REFRESH >= LWGSM_CFG_DNS_CACHE_TTL
+#error "LWGSM_CFG_DNS_CACHE_REFRESH must be lower than LWGSM_CFG_DNS_CACHE_TTL!"
+#endif /* LWGSM_CFG_DNS && LWGSM_CFG_DNS_CACHE_REFRESH >= LWGSM_CFG_DNS_CACHE_TTL */
+
+#if LWGSM_CFG_STATIC_ALLOC && !LWGSM_CFG_PBUF_POOL
+#error "LWGSM_CFG_PBUF_POOL must be enabled when LWGSM_CFG_STATIC_ALLOC is enabled!"
+#endif /* LWGSM_CFG_STATIC_ALLOC && !LWGSM_CFG_PBUF_POOL */
+
+#if LWGSM_CFG_BUFF_POW2
+#if (LWGSM_CFG_RCV_BUFF_SIZE & (LWGSM_CFG_RCV_BUFF_SIZE - 1)) != 0
+#error "LWGSM_CFG_RCV_BUFF_SIZE must be power of 2 when LWGSM_CFG_BUFF_POW2 is enabled!"
+#endif /* (LWGSM_CFG_RCV_BUFF_SIZE & (LWGSM_CFG_RCV_BUFF_SIZE - 1)) != 0 */
+#if LWGSM_CFG_STATIC_ALLOC && (LWGSM_CFG_STATIC_MQTT_TX_BUFF_LEN & (LWGSM_CFG_STATIC_MQTT_TX_BUFF_LEN - 1)) != 0
+#error "LWGSM_CFG_STATIC_MQTT_TX_BUFF_LEN must be power of 2 when LWGSM_CFG_BUFF_POW2 is enabled!"
+#endif /* LWGSM_CFG_STATIC_ALLOC && (LWGSM_CFG_STATIC_MQTT_TX_BUFF_LEN & (LWGSM_CFG_STATIC_MQTT_TX_BUFF_LEN - 1)) != 0 */
+#endif /* LWGSM_CFG_BUFF_POW2 */
+
+#if LWGSM_CFG_MQTT_MAX_SENDS_IN_FLIGHT < 1 || LWGSM_CFG_MQTT_MAX_SENDS_IN_FLIGHT > 255
+#error "LWGSM_CFG_MQTT_MAX_SENDS_IN_FLIGHT must be between 1 and 255!"
+#endif /* LWGSM_CFG_MQTT_MAX_SENDS_IN_FLIGHT < 1 || LWGSM_CFG_MQTT_MAX_SENDS_IN_FLIGHT > 255 */
+
+#if LWGSM_CFG_MQTT_PENDING_RESP_NUM < 1 || LWGSM_CFG_MQTT_PENDING_RESP_NUM > 255
+#error "LWGSM_CFG_MQTT_PENDING_RESP_NUM must be between 1 and 255!"
+#endif /* LWGSM_CFG_MQTT_PENDING_RESP_NUM < 1 || LWGSM_CFG_MQTT_PENDING_RESP_NUM > 255 */
+
+#if LWGSM_CFG_MQTT_QUEUE && (LWGSM_CFG_MQTT_QUEUE_WINDOW < 1 || LWGSM_CFG_MQTT_QUEUE_WINDOW > 32)
+#error "LWGSM_CFG_MQTT_QUEUE_WINDOW must be between 1 and 32!"
+#endif /* LWGSM_CFG_MQTT_QUEUE && (LWGSM_CFG_MQTT_QUEUE_WINDOW < 1 || LWGSM_CFG_MQTT_QUEUE_WINDOW > 32) */
+
+#if LWGSM_CFG_MQTT_V5 && (LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_NUM < 1 || LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_NUM > 255)
+#error "LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_NUM must be between 1 and 255!"
+#endif /* LWGSM_CFG_MQTT_V5 && (LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_NUM < 1 || LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_NUM > 255) */
+
+#if LWGSM_CFG_MQTT_V5 && (LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_LEN < 1 || LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_LEN > 255)
+#error "LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_LEN must be between 1 and 255!"
+#endif /* LWGSM_CFG_MQTT_V5 && (LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_LEN < 1 || LWGSM_CFG_MQTT_V5_TOPIC_ALIAS_LEN > 255) */
+
 #endif /* !__DOXYGEN__ */
 
 #include "lwgsm/lwgsm_debug.h"
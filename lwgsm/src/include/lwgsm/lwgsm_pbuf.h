@@ -66,11 +66,23 @@ size_t lwgsm_pbuf_strfind(const lwgsm_pbuf_p pbuf, const char* str, size_t off);
 
 uint8_t lwgsm_pbuf_advance(lwgsm_pbuf_p pbuf, int len);
 lwgsm_pbuf_p lwgsm_pbuf_skip(lwgsm_pbuf_p pbuf, size_t offset, size_t* new_offset);
+lwgsm_pbuf_p lwgsm_pbuf_slice(const lwgsm_pbuf_p pbuf, size_t offset, size_t len);
 
 void* lwgsm_pbuf_get_linear_addr(const lwgsm_pbuf_p pbuf, size_t offset, size_t* new_len);
 
 void lwgsm_pbuf_set_ip(lwgsm_pbuf_p pbuf, const lwgsm_ip_t* ip, lwgsm_port_t port);
 
+#if LWGSM_CFG_PBUF_POOL || __DOXYGEN__
+
+/**
+ * \brief           Number of packet buffer pool classes
+ */
+#define LWGSM_PBUF_POOL_CLASSES 3
+
+lwgsmr_t lwgsm_pbuf_pool_get_stats(size_t index, lwgsm_pbuf_pool_stats_t* stats);
+
+#endif /* LWGSM_CFG_PBUF_POOL || __DOXYGEN__ */
+
 /**
  * \}
  */
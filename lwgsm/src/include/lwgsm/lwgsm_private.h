@@ -209,6 +209,7 @@ typedef enum {
     LWGSM_CMD_CIPMUX,     /*!< Start Up Multi-IP Connection */
     LWGSM_CMD_CIPSTART,   /*!< Start Up TCP or UDP Connection */
     LWGSM_CMD_CIPSEND,    /*!< Send Data Through TCP or UDP Connection */
+    LWGSM_CMD_CIPSEND_GET, /*!< Query maximal data length for send command per connection */
     LWGSM_CMD_CIPQSEND,   /*!< Select Data Transmitting Mode */
     LWGSM_CMD_CIPACK,     /*!< Query Previous Connection Data Transmitting State */
     LWGSM_CMD_CIPCLOSE,   /*!< Close TCP or UDP Connection */
@@ -307,6 +308,28 @@ typedef struct lwgsm_conn {
     lwgsm_linbuff_t buff; /*!< Linear buffer structure */
 
     size_t total_recved; /*!< Total number of bytes received */
+    size_t max_send_len; /*!< Maximal number of bytes for single `CIPSEND` command on this connection.
+                                Queried from device when connection becomes active,
+                                never bigger than \ref LWGSM_CFG_CONN_MAX_DATA_LEN */
+    uint32_t write_time; /*!< Time of last \ref lwgsm_conn_write call, used for automatic flush */
+#if LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT > 0 || __DOXYGEN__
+    uint32_t write_flush_timeout; /*!< Write inactivity time before automatic flush.
+                                        Set to `0` to use \ref LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT */
+    size_t write_flush_threshold; /*!< Number of buffered bytes that triggers immediate send.
+                                        Set to `0` to use \ref LWGSM_CFG_CONN_WRITE_FLUSH_THRESHOLD */
+#endif                            /* LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT > 0 || __DOXYGEN__ */
+
+    struct lwgsm_msg* start_msg; /*!< Start message waiting for `CONNECT OK` or `CONNECT FAIL` from device */
+#if LWGSM_CFG_CONN_SCHED || __DOXYGEN__
+    uint8_t sched_weight; /*!< Number of send chunks before turn is given to other connections.
+                                Set to `0` to use \ref LWGSM_CFG_CONN_SCHED_WEIGHT */
+#endif                    /* LWGSM_CFG_CONN_SCHED || __DOXYGEN__ */
+    uint32_t connect_time;       /*!< Time when `AT+CIPSTART` has been accepted by device */
+
+#if LWGSM_CFG_CONN_STATS || __DOXYGEN__
+    lwgsm_conn_stats_t stats; /*!< Connection statistics */
+    uint32_t stats_rtt_sum;   /*!< Sum of all round-trip times, used for average calculation */
+#endif                        /* LWGSM_CFG_CONN_STATS || __DOXYGEN__ */
 
     union {
         struct {
@@ -316,6 +339,9 @@ typedef struct lwgsm_conn {
             uint8_t in_closing    : 1; /*!< Status if connection is in closing mode.
                                                     When in closing mode, ignore any possible received data from function */
             uint8_t bearer        : 1; /*!< Bearer used. Can be `1` or `0` */
+            uint8_t write_tmr     : 1; /*!< Status if write buffer flush timeout is scheduled */
+            uint8_t connecting    : 1; /*!< Status if connection is being established */
+            uint8_t connect_tmr   : 1; /*!< Status if connection establishment timeout is scheduled */
         } f;                           /*!< Connection flags */
     } status;                          /*!< Connection status union with flag bits */
 } lwgsm_conn_t;
@@ -325,13 +351,17 @@ typedef struct lwgsm_conn {
  * \brief           Packet buffer structure
  */
 typedef struct lwgsm_pbuf {
-    struct lwgsm_pbuf* next; /*!< Next pbuf in chain list */
-    size_t tot_len;          /*!< Total length of pbuf chain */
-    size_t len;              /*!< Length of payload */
-    size_t ref;              /*!< Number of references to this structure */
-    uint8_t* payload;        /*!< Pointer to payload memory */
-    lwgsm_ip_t ip;           /*!< Remote address for received IPD data */
-    lwgsm_port_t port;       /*!< Remote port for received IPD data */
+    struct lwgsm_pbuf* next;   /*!< Next pbuf in chain list */
+    size_t tot_len;            /*!< Total length of pbuf chain */
+    size_t len;                /*!< Length of payload */
+    size_t ref;                /*!< Number of references to this structure */
+    uint8_t* payload;          /*!< Pointer to payload memory */
+    lwgsm_ip_t ip;             /*!< Remote address for received IPD data */
+    lwgsm_port_t port;         /*!< Remote port for received IPD data */
+    struct lwgsm_pbuf* parent; /*!< Pbuf owning payload memory when this pbuf is a slice, `NULL` otherwise */
+#if LWGSM_CFG_PBUF_POOL || __DOXYGEN__
+    uint8_t pool; /*!< Pool class index buffer was allocated from, `0xFF` for heap memory */
+#endif            /* LWGSM_CFG_PBUF_POOL || __DOXYGEN__ */
 } lwgsm_pbuf_t;
 
 /**
@@ -466,7 +496,15 @@ typedef struct lwgsm_msg {
             lwgsm_evt_fn evt_func;             /*!< Callback function to use on connection */
             uint8_t num;                       /*!< Connection number used for start */
             lwgsm_conn_connect_res_t conn_res; /*!< Connection result status */
-        } conn_start;                          /*!< Structure for starting new connection */
+            uint8_t pending;                   /*!< Command finished, waiting for connection result from device */
+            uint8_t detached;                  /*!< Producer thread is done with message,
+                                                        it is finished when connection result is received */
+#if LWGSM_CFG_DNS || __DOXYGEN__
+            lwgsm_ip_t ip;   /*!< Host IP address from DNS cache, used when `use_ip` is set */
+            uint8_t use_ip;  /*!< Set to `1` when `ip` shall be used instead of `host` */
+            uint8_t resolve; /*!< Set to `1` when `host` shall be resolved and cached before connection */
+#endif                       /* LWGSM_CFG_DNS || __DOXYGEN__ */
+        } conn_start;       /*!< Structure for starting new connection */
 
         struct {
             lwgsm_conn_t* conn; /*!< Pointer to connection to close */
@@ -478,6 +516,8 @@ typedef struct lwgsm_msg {
             size_t btw;                  /*!< Number of remaining bytes to write */
             size_t ptr;                  /*!< Current write pointer for data */
             const uint8_t* data;         /*!< Data to send */
+            lwgsm_pbuf_p pbuf;           /*!< Packet buffer chain to send instead of linear `data`.
+                                                Stack holds a reference until command finishes */
             size_t sent;                 /*!< Number of bytes sent in last packet */
             size_t sent_all;             /*!< Number of bytes sent all together */
             uint8_t tries;               /*!< Number of tries used for last packet */
@@ -487,6 +527,14 @@ typedef struct lwgsm_msg {
             uint8_t fau;                 /*!< Free after use flag to free memory after data are sent (or not) */
             size_t* bw;                  /*!< Number of bytes written so far */
             uint8_t val_id;              /*!< Connection current validation ID when command was sent to queue */
+#if LWGSM_CFG_CONN_STATS || __DOXYGEN__
+            uint32_t prompt_time; /*!< Time when data were written to device after `> ` prompt */
+#endif                            /* LWGSM_CFG_CONN_STATS || __DOXYGEN__ */
+#if LWGSM_CFG_CONN_SCHED || __DOXYGEN__
+            struct lwgsm_msg* sched_next; /*!< Next message in connection transmit queue */
+            uint8_t sched_chunks;         /*!< Number of chunks sent since message got its turn */
+            uint8_t yield;                /*!< Set to `1` when message gives turn to other connections */
+#endif                                    /* LWGSM_CFG_CONN_SCHED || __DOXYGEN__ */
         } conn_send;                     /*!< Structure to send data on connection */
 #endif                                   /* LWGSM_CFG_CONN || __DOXYGEN__ */
 #if LWGSM_CFG_SMS || __DOXYGEN__
@@ -599,6 +647,14 @@ typedef struct lwgsm_msg {
             const char *data;
             size_t length;
         } service_call;
+#if LWGSM_CFG_DNS || __DOXYGEN__
+        struct {
+            const char* host;                           /*!< Host name to resolve */
+            lwgsm_ip_t* ip;                             /*!< Pointer to output IP variable. May be `NULL` */
+            char host_copy[LWGSM_CFG_DNS_HOST_MAX_LEN]; /*!< Copy of host name, used when caller memory
+                                                            may not be valid until command is executed */
+        } dns_getbyhostname;                            /*!< DNS function */
+#endif                        /* LWGSM_CFG_DNS || __DOXYGEN__ */
 #endif                        /* LWGSM_CFG_NETWORK || __DOXYGEN__ */
     } msg;                    /*!< Group of different possible message contents */
 } lwgsm_msg_t;
@@ -779,8 +835,30 @@ typedef struct {
     const char* id_str;         /*!< Model string identification */
     uint8_t is_2g;              /*!< Status if modem is 2G */
     uint8_t is_lte;             /*!< Status if modem is LTE */
+    uint16_t max_data_len;      /*!< Default maximal number of bytes for single `CIPSEND` command,
+                                        used when device does not report it for connection.
+                                        Set to `0` to use \ref LWGSM_CFG_CONN_MAX_DATA_LEN */
 } lwgsm_dev_model_map_t;
 
+#if LWGSM_CFG_STATIC_ALLOC || __DOXYGEN__
+
+/**
+ * \brief           Fixed-size block memory pool
+ */
+typedef struct {
+    uint8_t* mem;           /*!< Pool memory */
+    size_t size;            /*!< Size of single block */
+    size_t num;             /*!< Number of blocks in pool */
+    lwgsm_mem_pool_id_t id; /*!< Pool identifier for statistics */
+    void* free_blk;         /*!< List of free blocks, linked with first word of block */
+    size_t free_cnt;        /*!< Number of free blocks */
+    size_t max_used;        /*!< Maximal number of used blocks at the same time */
+    size_t failed;          /*!< Number of failed allocations */
+    uint8_t initialized;    /*!< Set to `1` when free list is prepared */
+} lwgsm_mem_pool_t;
+
+#endif /* LWGSM_CFG_STATIC_ALLOC || __DOXYGEN__ */
+
 /**
  * \}
  */
@@ -810,16 +888,60 @@ extern const size_t lwgsm_dev_model_map_size;
 #define CRLF                       "\r\n"
 #define CRLF_LEN                   2
 
+#if LWGSM_CFG_STATIC_ALLOC
+/* Size of pool block, large enough to keep free list link */
+#define LWGSM_MEM_POOL_BLOCK_SIZE(size) LWGSM_MEM_ALIGN(LWGSM_MAX(LWGSM_SZ(size), sizeof(void*)))
+
+/* Define pool with static memory, in units of words to keep it aligned */
+#define LWGSM_MEM_POOL_DEFINE(name, pool_id, blk_size, blk_num)                                                        \
+    static size_t name##_mem[(LWGSM_MEM_POOL_BLOCK_SIZE(blk_size) * (blk_num) + sizeof(size_t) - 1) / sizeof(size_t)]; \
+    lwgsm_mem_pool_t name = {.mem = (uint8_t*)name##_mem,                                                              \
+                             .size = LWGSM_MEM_POOL_BLOCK_SIZE(blk_size),                                              \
+                             .num = (blk_num),                                                                         \
+                             .id = (pool_id)}
+
+/* Error returned when object cannot be allocated */
+#define LWGSMI_ERRMEM lwgsmERRMEMPOOL
+
+extern lwgsm_mem_pool_t lwgsmi_msg_pool;
+extern lwgsm_mem_pool_t lwgsmi_conn_buff_pool;
+
+#define LWGSMI_MSG_ALLOC()         lwgsmi_mem_pool_alloc(&lwgsmi_msg_pool)
+#define LWGSMI_MSG_FREE_S(m)       lwgsmi_mem_pool_free_s(&lwgsmi_msg_pool, (void**)&(m))
+#define LWGSMI_CONN_BUFF_ALLOC()   lwgsmi_mem_pool_alloc(&lwgsmi_conn_buff_pool)
+#define LWGSMI_CONN_BUFF_FREE_S(b) lwgsmi_mem_pool_free_s(&lwgsmi_conn_buff_pool, (void**)&(b))
+#else /* LWGSM_CFG_STATIC_ALLOC */
+#define LWGSMI_ERRMEM lwgsmERRMEM
+
+#define LWGSMI_MSG_ALLOC()         lwgsm_mem_malloc_tag(LWGSM_MEM_TAG_MSG, sizeof(lwgsm_msg_t))
+#define LWGSMI_MSG_FREE_S(m)       lwgsm_mem_free_tag_s((void**)&(m))
+#define LWGSMI_CONN_BUFF_ALLOC()   lwgsm_mem_malloc_tag(LWGSM_MEM_TAG_CONN, sizeof(uint8_t) * LWGSM_CFG_CONN_MAX_DATA_LEN)
+#define LWGSMI_CONN_BUFF_FREE_S(b) lwgsm_mem_free_tag_s((void**)&(b))
+#endif /* !LWGSM_CFG_STATIC_ALLOC */
+
+#if LWGSM_CFG_CONN
+/* Release pbuf reference of send command, if command never reached the point where it is released */
+#define LWGSM_MSG_VAR_FREE_CONN_PBUF(name)                                                                             \
+    do {                                                                                                               \
+        if ((name)->cmd_def == LWGSM_CMD_CIPSEND && (name)->msg.conn_send.pbuf != NULL) {                              \
+            lwgsm_pbuf_free((name)->msg.conn_send.pbuf);                                                               \
+            (name)->msg.conn_send.pbuf = NULL;                                                                         \
+        }                                                                                                              \
+    } while (0)
+#else /* LWGSM_CFG_CONN */
+#define LWGSM_MSG_VAR_FREE_CONN_PBUF(name)
+#endif /* !LWGSM_CFG_CONN */
+
 #define LWGSM_MSG_VAR_DEFINE(name) lwgsm_msg_t* name
 #define LWGSM_MSG_VAR_ALLOC(name, blocking)                                                                            \
     do {                                                                                                               \
-        (name) = lwgsm_mem_malloc(sizeof(*(name)));                                                                    \
+        (name) = LWGSMI_MSG_ALLOC();                                                                                   \
         LWGSM_DEBUGW(LWGSM_CFG_DBG_VAR | LWGSM_DBG_TYPE_TRACE, (name) != NULL,                                         \
                      "[MSG VAR] Allocated %d bytes at %p\r\n", (int)sizeof(*(name)), (void*)(name));                   \
         LWGSM_DEBUGW(LWGSM_CFG_DBG_VAR | LWGSM_DBG_TYPE_TRACE, (name) == NULL,                                         \
                      "[MSG VAR] Error allocating %d bytes\r\n", (int)sizeof(*(name)));                                 \
         if ((name) == NULL) {                                                                                          \
-            return lwgsmERRMEM;                                                                                        \
+            return LWGSMI_ERRMEM;                                                                                      \
         }                                                                                                              \
         LWGSM_MEMSET((name), 0x00, sizeof(*(name)));                                                                   \
         (name)->is_blocking = LWGSM_U8((blocking) > 0);                                                                \
@@ -832,7 +954,8 @@ extern const size_t lwgsm_dev_model_map_size;
             lwgsm_sys_sem_delete(&((name)->sem));                                                                      \
             lwgsm_sys_sem_invalid(&((name)->sem));                                                                     \
         }                                                                                                              \
-        lwgsm_mem_free_s((void**)&(name));                                                                             \
+        LWGSM_MSG_VAR_FREE_CONN_PBUF(name);                                                                            \
+        LWGSMI_MSG_FREE_S(name);                                                                                       \
     } while (0)
 #if LWGSM_CFG_USE_API_FUNC_EVT
 #define LWGSM_MSG_VAR_SET_EVT(name, e_fn, e_arg)                                                                       \
@@ -870,8 +993,27 @@ void lwgsmi_conn_init(void);
 lwgsmr_t lwgsmi_send_msg_to_producer_mbox(lwgsm_msg_t* msg, lwgsmr_t (*process_fn)(lwgsm_msg_t*),
                                           uint32_t max_block_time);
 uint32_t lwgsmi_get_from_mbox_with_timeout_checks(lwgsm_sys_mbox_t* b, void** m, uint32_t timeout);
+lwgsmr_t lwgsmi_timeout_remove_arg(lwgsm_timeout_fn fn, void* arg);
 uint8_t lwgsmi_conn_closed_process(uint8_t conn_num, uint8_t forced);
 void lwgsmi_conn_start_timeout(lwgsm_conn_p conn);
+void lwgsmi_conn_set_default_data_len(lwgsm_conn_p conn);
+void lwgsmi_conn_set_max_send_len(lwgsm_conn_p conn, size_t len);
+lwgsmr_t lwgsmi_conn_query_max_send_len(void);
+void lwgsmi_conn_start_connect_timeout(lwgsm_conn_p conn);
+void lwgsmi_conn_remove_timeouts(lwgsm_conn_p conn);
+void lwgsmi_conn_connect_result(uint8_t num, lwgsm_conn_connect_res_t res, lwgsmr_t err);
+uint8_t lwgsmi_conn_sched_put(lwgsm_msg_t* msg, uint8_t front);
+lwgsm_msg_t* lwgsmi_conn_sched_get(void);
+uint8_t lwgsmi_conn_sched_is_wakeup(lwgsm_msg_t* msg);
+uint8_t lwgsmi_conn_sched_yield(lwgsm_msg_t* msg);
+void lwgsmi_dns_cache_add(const char* host, const lwgsm_ip_t* ip);
+lwgsm_pbuf_p lwgsmi_pbuf_new_ipd(size_t len);
+
+#if LWGSM_CFG_STATIC_ALLOC
+void* lwgsmi_mem_pool_alloc(lwgsm_mem_pool_t* pool);
+void lwgsmi_mem_pool_free(lwgsm_mem_pool_t* pool, void* ptr);
+uint8_t lwgsmi_mem_pool_free_s(lwgsm_mem_pool_t* pool, void** ptr);
+#endif /* LWGSM_CFG_STATIC_ALLOC */
 
 lwgsmr_t lwgsmi_get_sim_info(const uint32_t blocking);
 
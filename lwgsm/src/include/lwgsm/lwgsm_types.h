@@ -82,6 +82,7 @@ typedef enum {
     lwgsmERRWIFINOTCONNECTED, /*!< Wifi not connected to access point */
     lwgsmERRNODEVICE,         /*!< Device is not present */
     lwgsmERRBLOCKING,         /*!< Blocking mode command is not allowed */
+    lwgsmERRMEMPOOL,          /*!< Static memory pool is exhausted */
 } lwgsmr_t;
 
 /**
@@ -90,7 +91,7 @@ typedef enum {
  */
 typedef enum {
 
-#define LWGSM_DEVICE_MODEL_ENTRY(name, str_id, is_2g, is_lte) LWGSM_DEVICE_MODEL_##name,
+#define LWGSM_DEVICE_MODEL_ENTRY(name, str_id, is_2g, is_lte, max_data_len) LWGSM_DEVICE_MODEL_##name,
 #include "lwgsm/lwgsm_models.h"
     LWGSM_DEVICE_MODEL_END,     /*!< End of device model */
     LWGSM_DEVICE_MODEL_UNKNOWN, /*!< Unknown device model */
@@ -157,6 +158,24 @@ typedef enum {
     LWGSM_CONN_TYPE_SSL, /*!< Connection type is TCP over SSL */
 } lwgsm_conn_type_t;
 
+/**
+ * \ingroup         LWGSM_CONN
+ * \brief           Connection statistics
+ * \note            Round-trip time is measured from `> ` prompt (data written to device) to `SEND OK` response
+ */
+typedef struct {
+    size_t bytes_sent;      /*!< Number of bytes successfully sent */
+    uint32_t segments_sent; /*!< Number of `CIPSEND` data segments written to device */
+    uint32_t send_ok;       /*!< Number of `SEND OK` responses */
+    uint32_t send_fail;     /*!< Number of `SEND FAIL` responses */
+    uint32_t send_retries;  /*!< Number of segments sent again after failure */
+    uint32_t rtt_min;       /*!< Minimal round-trip time in units of milliseconds */
+    uint32_t rtt_avg;       /*!< Average round-trip time in units of milliseconds */
+    uint32_t rtt_max;       /*!< Maximal round-trip time in units of milliseconds */
+    uint32_t recv_pbufs;    /*!< Number of packet buffers passed to application */
+    size_t recv_dropped;    /*!< Number of received bytes dropped due to memory or closing connection */
+} lwgsm_conn_stats_t;
+
 /**
  * \ingroup         LWGSM_TYPES
  * \brief           Available device memories
@@ -374,6 +393,18 @@ typedef struct lwgsm_conn* lwgsm_conn_p;
  */
 typedef struct lwgsm_pbuf* lwgsm_pbuf_p;
 
+/**
+ * \ingroup         LWGSM_PBUF
+ * \brief           Packet buffer pool class statistics
+ */
+typedef struct {
+    size_t size;     /*!< Payload size of single buffer */
+    size_t total;    /*!< Number of all buffers in class */
+    size_t used;     /*!< Number of currently allocated buffers */
+    size_t max_used; /*!< Maximal number of allocated buffers at the same time */
+    size_t failed;   /*!< Number of failed allocations, when class and all bigger classes were empty */
+} lwgsm_pbuf_pool_stats_t;
+
 /**
  * \ingroup         LWGSM_EVT
  * \brief           Event function prototype
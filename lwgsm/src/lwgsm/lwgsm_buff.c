@@ -46,8 +46,17 @@
 #define BUF_MIN(x, y)   ((x) < (y) ? (x) : (y))
 #define BUF_MAX(x, y)   ((x) > (y) ? (x) : (y))
 
+#if LWGSM_CFG_BUFF_POW2
+/* Size is power of 2, wrap index with mask */
+#define BUF_WRAP(b, idx) ((idx) & ((b)->size - 1))
+#else /* LWGSM_CFG_BUFF_POW2 */
+/* Index is always less than `2 * size`, single subtraction is enough */
+#define BUF_WRAP(b, idx) ((idx) >= (b)->size ? (idx) - (b)->size : (idx))
+#endif /* !LWGSM_CFG_BUFF_POW2 */
+
 /**
  * \brief           Initialize buffer
+ * \note            When \ref LWGSM_CFG_BUFF_POW2 is enabled, size is rounded up to next power of `2`
  * \param[in]       buff: Pointer to buffer structure
  * \param[in]       size: Size of buffer in units of bytes
  * \return          `1` on success, `0` otherwise
@@ -59,6 +68,18 @@ BUF_PREF(buff_init)(BUF_PREF(buff_t) * buff, size_t size) {
     }
     BUF_MEMSET(buff, 0, sizeof(*buff));
 
+#if LWGSM_CFG_BUFF_POW2
+    /* Round size up to next power of 2 */
+    for (size_t s = 1; s > 0; s <<= 1) {
+        if (s >= size) {
+            size = s;
+            break;
+        }
+    }
+    if ((size & (size - 1)) != 0) {
+        return 0;
+    }
+#endif /* LWGSM_CFG_BUFF_POW2 */
     buff->size = size;                                         /* Set default values */
     buff->buff = lwgsm_mem_malloc(sizeof(*buff->buff) * size); /* Allocate memory for buffer */
 
@@ -116,10 +137,7 @@ BUF_PREF(buff_write)(BUF_PREF(buff_t) * buff, const void* data, size_t btw) {
         BUF_MEMCPY(buff->buff, (void*)&d[tocopy], btw);
         buff->w = btw;
     }
-
-    if (buff->w >= buff->size) {
-        buff->w = 0;
-    }
+    buff->w = BUF_WRAP(buff, buff->w);
     return tocopy + btw;
 }
 
@@ -160,9 +178,7 @@ BUF_PREF(buff_read)(BUF_PREF(buff_t) * buff, void* data, size_t btr) {
     }
 
     /* Step 3: Check end of buffer */
-    if (buff->r >= buff->size) {
-        buff->r = 0;
-    }
+    buff->r = BUF_WRAP(buff, buff->r);
     return tocopy + btr;
 }
 
@@ -192,11 +208,8 @@ BUF_PREF(buff_peek)(BUF_PREF(buff_t) * buff, size_t skip_count, void* data, size
     if (skip_count >= full) {
         return 0;
     }
-    r += skip_count;
+    r = BUF_WRAP(buff, r + skip_count);
     full -= skip_count;
-    if (r >= buff->size) {
-        r -= buff->size;
-    }
 
     /* Check maximum number of bytes available to read after skip */
     btp = BUF_MIN(full, btp);
@@ -232,6 +245,9 @@ BUF_PREF(buff_get_free)(BUF_PREF(buff_t) * buff) {
     /* Use temporary values in case they are changed during operations */
     w = buff->w;
     r = buff->r;
+#if LWGSM_CFG_BUFF_POW2
+    size = BUF_WRAP(buff, r - w - 1);
+#else  /* LWGSM_CFG_BUFF_POW2 */
     if (w == r) {
         size = buff->size;
     } else if (r > w) {
@@ -241,7 +257,9 @@ BUF_PREF(buff_get_free)(BUF_PREF(buff_t) * buff) {
     }
 
     /* Buffer free size is always 1 less than actual size */
-    return size - 1;
+    --size;
+#endif /* !LWGSM_CFG_BUFF_POW2 */
+    return size;
 }
 
 /**
@@ -260,6 +278,9 @@ BUF_PREF(buff_get_full)(BUF_PREF(buff_t) * buff) {
     /* Use temporary values in case they are changed during operations */
     w = buff->w;
     r = buff->r;
+#if LWGSM_CFG_BUFF_POW2
+    size = BUF_WRAP(buff, w - r);
+#else  /* LWGSM_CFG_BUFF_POW2 */
     if (w == r) {
         size = 0;
     } else if (w > r) {
@@ -267,6 +288,7 @@ BUF_PREF(buff_get_full)(BUF_PREF(buff_t) * buff) {
     } else {
         size = buff->size - (r - w);
     }
+#endif /* !LWGSM_CFG_BUFF_POW2 */
     return size;
 }
 
@@ -337,11 +359,8 @@ BUF_PREF(buff_skip)(BUF_PREF(buff_t) * buff, size_t len) {
         return 0;
     }
 
-    full = BUF_PREF(buff_get_full)(buff); /* Get buffer used length */
-    buff->r += BUF_MIN(len, full);        /* Advance read pointer */
-    if (buff->r >= buff->size) {          /* Subtract possible overflow */
-        buff->r -= buff->size;
-    }
+    full = BUF_PREF(buff_get_full)(buff);                 /* Get buffer used length */
+    buff->r = BUF_WRAP(buff, buff->r + BUF_MIN(len, full)); /* Advance read pointer and wrap */
     return len;
 }
 
@@ -412,10 +431,88 @@ BUF_PREF(buff_advance)(BUF_PREF(buff_t) * buff, size_t len) {
         return 0;
     }
 
-    free = BUF_PREF(buff_get_free)(buff); /* Get buffer free length */
-    buff->w += BUF_MIN(len, free);        /* Advance write pointer */
-    if (buff->w >= buff->size) {          /* Subtract possible overflow */
-        buff->w -= buff->size;
-    }
+    free = BUF_PREF(buff_get_free)(buff);                 /* Get buffer free length */
+    buff->w = BUF_WRAP(buff, buff->w + BUF_MIN(len, free)); /* Advance write pointer and wrap */
     return len;
 }
+
+/**
+ * \brief           Reserve contiguous free region for in-place write
+ *
+ * Returns address of linear free memory, where hardware (DMA) or application
+ * can write directly, without intermediate copy with \ref lwgsm_buff_write.
+ * Once data are written, call \ref lwgsm_buff_write_commit to make them available for read.
+ *
+ * \note            Only single writer may reserve memory at a time.
+ *                  Free region after buffer wrap is returned by next call, after commit
+ * \param[in]       buff: Buffer handle
+ * \param[out]      len: Output variable to write length of reserved region in units of bytes
+ * \return          Address of reserved region or `NULL` if buffer is full
+ */
+void*
+BUF_PREF(buff_write_reserve)(BUF_PREF(buff_t) * buff, size_t* len) {
+    if (len == NULL) {
+        return NULL;
+    }
+    *len = BUF_PREF(buff_get_linear_block_write_length)(buff);
+    return *len > 0 ? BUF_PREF(buff_get_linear_block_write_address)(buff) : NULL;
+}
+
+/**
+ * \brief           Commit data written to region reserved with \ref lwgsm_buff_write_reserve
+ * \param[in]       buff: Buffer handle
+ * \param[in]       len: Number of bytes written, must not exceed reserved length
+ * \return          Number of bytes committed
+ */
+size_t
+BUF_PREF(buff_write_commit)(BUF_PREF(buff_t) * buff, size_t len) {
+    len = BUF_MIN(len, BUF_PREF(buff_get_linear_block_write_length)(buff));
+    return BUF_PREF(buff_advance)(buff, len);
+}
+
+/**
+ * \brief           Get address of contiguous readable region without copy
+ *
+ * Buffer content may be split in `2` segments. First call with `skip_count = 0`
+ * returns first segment, call with `skip_count` equal to first segment length returns second one.
+ * Data stay in the buffer until \ref lwgsm_buff_read_advance is called.
+ *
+ * \param[in]       buff: Buffer handle
+ * \param[in]       skip_count: Number of bytes to skip before start of region
+ * \param[out]      len: Output variable to write length of linear region in units of bytes
+ * \return          Address of region or `NULL` if no data available after skip
+ */
+const void*
+BUF_PREF(buff_read_peek)(BUF_PREF(buff_t) * buff, size_t skip_count, size_t* len) {
+    size_t full, lin;
+
+    if (len == NULL) {
+        return NULL;
+    }
+    *len = 0;
+    full = BUF_PREF(buff_get_full)(buff);
+    if (skip_count >= full) {
+        return NULL;
+    }
+
+    /* Region starts either in first linear block or in overflow part at the beginning of buffer */
+    lin = BUF_PREF(buff_get_linear_block_read_length)(buff);
+    if (skip_count < lin) {
+        *len = lin - skip_count;
+        return (uint8_t*)BUF_PREF(buff_get_linear_block_read_address)(buff) + skip_count;
+    }
+    *len = full - skip_count;
+    return &buff->buff[skip_count - lin];
+}
+
+/**
+ * \brief           Mark data returned by \ref lwgsm_buff_read_peek as read
+ * \param[in]       buff: Buffer handle
+ * \param[in]       len: Number of bytes to release
+ * \return          Number of bytes released
+ */
+size_t
+BUF_PREF(buff_read_advance)(BUF_PREF(buff_t) * buff, size_t len) {
+    len = BUF_MIN(len, BUF_PREF(buff_get_full)(buff));
+    return BUF_PREF(buff_skip)(buff, len);
+}
@@ -36,6 +36,12 @@
 
 #if LWGSM_CFG_CONN || __DOXYGEN__
 
+#if LWGSM_CFG_STATIC_ALLOC
+/* Static pool for connection write buffers */
+LWGSM_MEM_POOL_DEFINE(lwgsmi_conn_buff_pool, LWGSM_MEM_POOL_CONN_BUFF, LWGSM_CFG_CONN_MAX_DATA_LEN,
+                      LWGSM_CFG_STATIC_CONN_BUFF_NUM);
+#endif /* LWGSM_CFG_STATIC_ALLOC */
+
 /**
  * \brief           Check if connection is closed or in closing state
  * \param[in]       conn: Connection handle
@@ -80,6 +86,122 @@ lwgsmi_conn_start_timeout(lwgsm_conn_p conn) {
     lwgsm_timeout_add(LWGSM_CFG_CONN_POLL_INTERVAL, conn_timeout_cb, conn); /* Add connection timeout */
 }
 
+/**
+ * \brief           Set maximal send length for connection
+ * \param[in]       conn: Connection handle
+ * \param[in]       len: Maximal number of bytes device accepts in single send command.
+ *                      Value is capped to \ref LWGSM_CFG_CONN_MAX_DATA_LEN
+ */
+void
+lwgsmi_conn_set_max_send_len(lwgsm_conn_p conn, size_t len) {
+    if (len == 0 || len > LWGSM_CFG_CONN_MAX_DATA_LEN) {
+        len = LWGSM_CFG_CONN_MAX_DATA_LEN;
+    }
+    conn->max_send_len = len;
+}
+
+/**
+ * \brief           Set default data lengths for connection, according to currently detected device model
+ * \note            Used when connection becomes active, before device reports its values
+ * \param[in]       conn: Connection handle
+ */
+void
+lwgsmi_conn_set_default_data_len(lwgsm_conn_p conn) {
+    size_t len = LWGSM_CFG_CONN_MAX_DATA_LEN;
+
+    for (size_t i = 0; i < lwgsm_dev_model_map_size; ++i) {
+        if (lwgsm_dev_model_map[i].model == lwgsm.m.model) {
+            len = lwgsm_dev_model_map[i].max_data_len;
+            break;
+        }
+    }
+    lwgsmi_conn_set_max_send_len(conn, len);
+}
+
+/**
+ * \brief           Query maximal send length for all active connections
+ * \note            Function is called from processing thread when connection becomes active
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsmi_conn_query_max_send_len(void) {
+    LWGSM_MSG_VAR_DEFINE(msg);
+
+    LWGSM_MSG_VAR_ALLOC(msg, 0);
+    LWGSM_MSG_VAR_REF(msg).cmd_def = LWGSM_CMD_CIPSEND_GET;
+
+    return lwgsmi_send_msg_to_producer_mbox(&LWGSM_MSG_VAR_REF(msg), lwgsmi_initiate_cmd, 1000);
+}
+
+/**
+ * \brief           Timeout callback for connection establishment
+ * \param[in]       arg: Timeout callback custom argument
+ */
+static void
+conn_connect_timeout_cb(void* arg) {
+    lwgsm_conn_p conn = arg; /* Argument is actual connection */
+    uint32_t diff, timeout;
+
+    /* Timeout is removed when connection start finishes, flag is only a safety check */
+    if (!conn->status.f.connect_tmr) {
+        return;
+    }
+    conn->status.f.connect_tmr = 0;
+    if (!conn->status.f.connecting || conn->start_msg == NULL) {
+        return;
+    }
+
+    diff = lwgsm_sys_now() - conn->connect_time;
+    timeout = conn->start_msg->block_time;
+    if (diff >= timeout) {
+        LWGSM_DEBUGF(LWGSM_CFG_DBG_CONN | LWGSM_DBG_TYPE_TRACE | LWGSM_DBG_LVL_WARNING,
+                     "[LWGSM CONN] Connection %d start timeout\r\n", (int)conn->num);
+        lwgsmi_conn_connect_result(conn->num, LWGSM_CONN_CONNECT_ERROR, lwgsmTIMEOUT);
+    } else {
+        lwgsmi_conn_start_connect_timeout(conn); /* Start time moved, wait for the rest */
+    }
+}
+
+/**
+ * \brief           Start timeout for connection establishment, if not already scheduled
+ *
+ * When device does not report `CONNECT OK` or `CONNECT FAIL` in time,
+ * connection start is finished with \ref lwgsmTIMEOUT
+ *
+ * \param[in]       conn: Connection handle with start message set
+ */
+void
+lwgsmi_conn_start_connect_timeout(lwgsm_conn_p conn) {
+    uint32_t diff;
+
+    if (conn->status.f.connect_tmr || conn->start_msg == NULL) {
+        return;
+    }
+    diff = lwgsm_sys_now() - conn->connect_time;
+    diff = diff < conn->start_msg->block_time ? (conn->start_msg->block_time - diff) : 0;
+    if (lwgsm_timeout_add(diff, conn_connect_timeout_cb, conn) == lwgsmOK) {
+        conn->status.f.connect_tmr = 1;
+    }
+}
+
+/**
+ * \brief           Get maximal number of bytes stack sends to device with single command on connection
+ * \param[in]       conn: Connection handle
+ * \return          Maximal data length for single send command
+ */
+size_t
+lwgsm_conn_get_max_send_len(lwgsm_conn_p conn) {
+    size_t len = LWGSM_CFG_CONN_MAX_DATA_LEN;
+    if (conn != NULL) {
+        lwgsm_core_lock();
+        if (conn->max_send_len > 0) {
+            len = conn->max_send_len;
+        }
+        lwgsm_core_unlock();
+    }
+    return len;
+}
+
 /**
  * \brief           Get connection validation ID
  * \param[in]       conn: Connection handle
@@ -160,7 +282,7 @@ flush_buff(lwgsm_conn_p conn) {
         if (res != lwgsmOK) {
             LWGSM_DEBUGF(LWGSM_CFG_DBG_CONN | LWGSM_DBG_TYPE_TRACE, "[LWGSM CONN] Free write buffer: %p\r\n",
                          (void*)conn->buff.buff);
-            lwgsm_mem_free_s((void**)&conn->buff.buff);
+            LWGSMI_CONN_BUFF_FREE_S(conn->buff.buff);
         }
         conn->buff.buff = NULL;
     }
@@ -168,6 +290,275 @@ flush_buff(lwgsm_conn_p conn) {
     return res;
 }
 
+#if LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT > 0 || __DOXYGEN__
+
+static void conn_write_start_flush_timeout(lwgsm_conn_p conn, uint32_t time);
+
+/* Per-connection flush parameters, `0` selects global configuration */
+#define CONN_WRITE_FLUSH_TIMEOUT(conn)                                                                                 \
+    ((conn)->write_flush_timeout > 0 ? (conn)->write_flush_timeout : LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT)
+#define CONN_WRITE_FLUSH_THRESHOLD(conn)                                                                               \
+    ((conn)->write_flush_threshold > 0 ? (conn)->write_flush_threshold : LWGSM_CFG_CONN_WRITE_FLUSH_THRESHOLD)
+
+/**
+ * \brief           Timeout callback to flush connection write buffer after inactivity
+ * \param[in]       arg: Timeout callback custom argument
+ */
+static void
+conn_write_flush_timeout_cb(void* arg) {
+    lwgsm_conn_p conn = arg; /* Argument is actual connection */
+    uint32_t diff;
+
+    /* Timeout is removed when connection closes, flag is only a safety check */
+    if (!conn->status.f.write_tmr) {
+        return;
+    }
+    conn->status.f.write_tmr = 0;
+    if (!conn->status.f.active || conn->buff.buff == NULL || conn->buff.ptr == 0) {
+        return;
+    }
+
+    diff = lwgsm_sys_now() - conn->write_time;
+    if (diff >= CONN_WRITE_FLUSH_TIMEOUT(conn)) {
+        LWGSM_DEBUGF(LWGSM_CFG_DBG_CONN | LWGSM_DBG_TYPE_TRACE, "[LWGSM CONN] Flush write buffer on timeout: %p\r\n",
+                     (void*)conn);
+        flush_buff(conn);
+    } else {
+        /* Application wrote more data in the meantime, wait for the rest of inactivity time */
+        conn_write_start_flush_timeout(conn, CONN_WRITE_FLUSH_TIMEOUT(conn) - diff);
+    }
+}
+
+/**
+ * \brief           Schedule flush of connection write buffer if not already scheduled
+ * \param[in]       conn: Connection handle
+ * \param[in]       time: Time in milliseconds until timeout expires
+ */
+static void
+conn_write_start_flush_timeout(lwgsm_conn_p conn, uint32_t time) {
+    if (!conn->status.f.write_tmr && lwgsm_timeout_add(time, conn_write_flush_timeout_cb, conn) == lwgsmOK) {
+        conn->status.f.write_tmr = 1;
+    }
+}
+
+#endif /* LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT > 0 || __DOXYGEN__ */
+
+/**
+ * \brief           Remove scheduled timeouts of connection
+ *
+ * Called before connection is closed or its structure is reset,
+ * so that timeout of old connection does not act on the new one
+ *
+ * \param[in]       conn: Connection handle
+ */
+void
+lwgsmi_conn_remove_timeouts(lwgsm_conn_p conn) {
+    if (conn->status.f.connect_tmr) {
+        lwgsmi_timeout_remove_arg(conn_connect_timeout_cb, conn);
+        conn->status.f.connect_tmr = 0;
+    }
+#if LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT > 0
+    if (conn->status.f.write_tmr) {
+        lwgsmi_timeout_remove_arg(conn_write_flush_timeout_cb, conn);
+        conn->status.f.write_tmr = 0;
+    }
+#endif /* LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT > 0 */
+}
+
+#if LWGSM_CFG_CONN_SCHED || __DOXYGEN__
+
+/**
+ * \brief           Connection transmit queue
+ */
+typedef struct {
+    lwgsm_msg_t* head;   /*!< First message to send */
+    lwgsm_msg_t* tail;   /*!< Last message to send */
+    size_t cnt;          /*!< Number of messages in queue */
+    size_t waiting;      /*!< Number of threads waiting for free slot in queue */
+    lwgsm_sys_sem_t sem; /*!< Semaphore to wake up threads waiting for free slot */
+} lwgsm_conn_sched_queue_t;
+
+static lwgsm_conn_sched_queue_t sched_queues[LWGSM_CFG_MAX_CONNS]; /*!< Transmit queue for each connection */
+static size_t sched_cnt;             /*!< Number of messages in all queues */
+static uint8_t sched_rr;             /*!< Connection number which had last turn */
+static uint8_t sched_mbox_turn;      /*!< Set to `1` when producer mailbox gets next turn */
+static uint8_t sched_wakeup_posted;  /*!< Set to `1` when wakeup message is in producer mailbox */
+static lwgsm_msg_t sched_wakeup_msg; /*!< Message to wake up producer thread, never processed */
+
+/**
+ * \brief           Add send message to its connection transmit queue
+ *
+ * When queue already holds \ref LWGSM_CFG_CONN_SCHED_QUEUE_LEN messages,
+ * blocking message waits for free slot and non-blocking message is rejected.
+ * Message put to the front is always accepted as it already had its slot.
+ *
+ * \param[in]       msg: Send message
+ * \param[in]       front: Set to `1` to put message in front of queue,
+ *                      used when message gave turn to other connections
+ * \return          `1` if message was added to queue, `0` otherwise
+ */
+uint8_t
+lwgsmi_conn_sched_put(lwgsm_msg_t* msg, uint8_t front) {
+    lwgsm_conn_sched_queue_t* q;
+
+    lwgsm_core_lock();
+    q = &sched_queues[msg->msg.conn_send.conn->num];
+    while (!front && q->cnt >= LWGSM_CFG_CONN_SCHED_QUEUE_LEN) {
+        /* Only blocking message may wait, semaphore is created on first use */
+        if (!msg->is_blocking
+            || (!lwgsm_sys_sem_isvalid(&q->sem) && !lwgsm_sys_sem_create(&q->sem, 0))) {
+            lwgsm_core_unlock();
+            return 0;
+        }
+        ++q->waiting;
+        lwgsm_core_unlock();
+        lwgsm_sys_sem_wait(&q->sem, 0);
+        lwgsm_core_lock();
+        --q->waiting;
+    }
+    if (front) {
+        msg->msg.conn_send.sched_next = q->head;
+        q->head = msg;
+        if (q->tail == NULL) {
+            q->tail = msg;
+        }
+    } else {
+        msg->msg.conn_send.sched_next = NULL;
+        if (q->tail != NULL) {
+            q->tail->msg.conn_send.sched_next = msg;
+        } else {
+            q->head = msg;
+        }
+        q->tail = msg;
+
+        /* Producer thread may wait for mailbox, wake it up */
+        if (!sched_wakeup_posted && lwgsm_sys_mbox_putnow(&lwgsm.mbox_producer, &sched_wakeup_msg)) {
+            sched_wakeup_posted = 1;
+        }
+    }
+    ++q->cnt;
+    ++sched_cnt;
+
+    /* Pass wakeup to next waiting thread if there is still free slot */
+    if (q->waiting > 0 && q->cnt < LWGSM_CFG_CONN_SCHED_QUEUE_LEN) {
+        lwgsm_sys_sem_release(&q->sem);
+    }
+    lwgsm_core_unlock();
+    return 1;
+}
+
+/**
+ * \brief           Check if message from producer mailbox is scheduler wakeup message
+ * \param[in]       msg: Message from producer mailbox
+ * \return          `1` if message shall be ignored, `0` otherwise
+ */
+uint8_t
+lwgsmi_conn_sched_is_wakeup(lwgsm_msg_t* msg) {
+    if (msg == &sched_wakeup_msg) {
+        sched_wakeup_posted = 0;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * \brief           Get next message for producer thread
+ *
+ * Scheduled send messages and other commands from producer mailbox take turns,
+ * connections with pending data are served in round-robin order.
+ *
+ * \return          Message to process or `NULL` if there is no scheduled data,
+ *                      producer thread shall wait for mailbox in this case
+ */
+lwgsm_msg_t*
+lwgsmi_conn_sched_get(void) {
+    lwgsm_msg_t* msg = NULL;
+    lwgsm_conn_sched_queue_t* q;
+
+    lwgsm_core_lock();
+    if (sched_cnt > 0) {
+        /* Give other commands a chance between scheduled sends */
+        if (sched_mbox_turn) {
+            sched_mbox_turn = 0;
+            if (lwgsm_sys_mbox_getnow(&lwgsm.mbox_producer, (void**)&msg) && msg != NULL
+                && !lwgsmi_conn_sched_is_wakeup(msg)) {
+                lwgsm_core_unlock();
+                return msg;
+            }
+            msg = NULL;
+        }
+
+        for (size_t i = 1; i <= LWGSM_CFG_MAX_CONNS; ++i) {
+            uint8_t num = LWGSM_U8((sched_rr + i) % LWGSM_CFG_MAX_CONNS);
+
+            q = &sched_queues[num];
+            if (q->head != NULL) {
+                msg = q->head;
+                q->head = msg->msg.conn_send.sched_next;
+                if (q->head == NULL) {
+                    q->tail = NULL;
+                }
+                msg->msg.conn_send.sched_next = NULL;
+                msg->msg.conn_send.sched_chunks = 0;
+                --q->cnt;
+                --sched_cnt;
+                if (q->waiting > 0) {
+                    lwgsm_sys_sem_release(&q->sem); /* Wake up thread waiting for free slot */
+                }
+                sched_rr = num;
+                sched_mbox_turn = 1;
+                break;
+            }
+        }
+    }
+    lwgsm_core_unlock();
+    return msg;
+}
+
+/**
+ * \brief           Check if send message shall give turn to other connections after sent chunk
+ * \note            Function is called from processing thread
+ * \param[in]       msg: Active send message
+ * \return          `1` if message shall yield, `0` otherwise
+ */
+uint8_t
+lwgsmi_conn_sched_yield(lwgsm_msg_t* msg) {
+    lwgsm_conn_p conn = msg->msg.conn_send.conn;
+    uint8_t weight = conn->sched_weight > 0 ? conn->sched_weight : LWGSM_CFG_CONN_SCHED_WEIGHT;
+
+    if (++msg->msg.conn_send.sched_chunks < weight) {
+        return 0;
+    }
+    for (size_t i = 0; i < LWGSM_ARRAYSIZE(sched_queues); ++i) {
+        if (i != conn->num && sched_queues[i].head != NULL) {
+            return 1; /* Other connection is waiting */
+        }
+    }
+    msg->msg.conn_send.sched_chunks = 0;
+    return 0;
+}
+
+#endif /* LWGSM_CFG_CONN_SCHED || __DOXYGEN__ */
+
+#if LWGSM_CFG_DNS || __DOXYGEN__
+
+/**
+ * \brief           Check if host is written as IP address
+ * \param[in]       host: Connection host
+ * \return          `1` if host is IP address, `0` if it is host name
+ */
+static uint8_t
+conn_host_is_ip(const char* host) {
+    for (; *host != '\0'; ++host) {
+        if (!LWGSM_CHARISNUM(*host) && *host != '.' && *host != ':') {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+#endif /* LWGSM_CFG_DNS || __DOXYGEN__ */
+
 /**
  * \brief           Initialize connection module
  */
@@ -176,6 +567,15 @@ lwgsmi_conn_init(void) {}
 
 /**
  * \brief           Start a new connection of specific type
+ *
+ * Command pipeline is released as soon as device accepts `AT+CIPSTART`,
+ * other commands are executed while device establishes connection.
+ * With \ref LWGSM_CFG_DNS enabled, host name of non-SSL connection is resolved
+ * with \ref LWGSM_DNS cache and cached IP address is used to connect.
+ * Result is reported with \ref LWGSM_EVT_CONN_ACTIVE or \ref LWGSM_EVT_CONN_ERROR event,
+ * blocking call returns when result is known.
+ *
+ * \note            `host` memory must stay valid until connection result is reported
  * \param[out]      conn: Pointer to connection handle to set new connection reference in case of successful connection
  * \param[in]       type: Connection type. This parameter can be a value of \ref lwgsm_conn_type_t enumeration
  * \param[in]       host: Connection host. In case of IP, write it as string, ex. "192.168.1.1"
@@ -204,6 +604,17 @@ lwgsm_conn_start(lwgsm_conn_p* conn, lwgsm_conn_type_t type, const char* const h
     LWGSM_MSG_VAR_REF(msg).msg.conn_start.port = port;
     LWGSM_MSG_VAR_REF(msg).msg.conn_start.evt_func = conn_evt_fn;
     LWGSM_MSG_VAR_REF(msg).msg.conn_start.arg = arg;
+#if LWGSM_CFG_DNS
+    /*
+     * Use cached IP address instead of host name, host is resolved and cached first on cache miss.
+     * SSL connection needs host name for server name indication and certificate check
+     */
+    if (type != LWGSM_CONN_TYPE_SSL && !conn_host_is_ip(host)) {
+        LWGSM_MSG_VAR_REF(msg).msg.conn_start.use_ip =
+            lwgsm_dns_cache_get(host, &LWGSM_MSG_VAR_REF(msg).msg.conn_start.ip);
+        LWGSM_MSG_VAR_REF(msg).msg.conn_start.resolve = !LWGSM_MSG_VAR_REF(msg).msg.conn_start.use_ip;
+    }
+#endif /* LWGSM_CFG_DNS */
 
     return lwgsmi_send_msg_to_producer_mbox(&LWGSM_MSG_VAR_REF(msg), lwgsmi_initiate_cmd, 60000);
 }
@@ -300,6 +711,56 @@ lwgsm_conn_send(lwgsm_conn_p conn, const void* data, size_t btw, size_t* const b
     return res;
 }
 
+/**
+ * \brief           Send packet buffer chain on already active connection
+ *
+ * Stack increases reference counter on `pbuf` and sends its payload directly from pbuf memory, without copy.
+ * Single `CIPSEND` command may cover several pbufs in the chain, as data are sent in chunks of
+ * up to \ref lwgsm_conn_get_max_send_len bytes, regardless of pbuf segment boundaries.
+ *
+ * Reference is released by stack when all data are sent or when command fails.
+ * Application may free its own reference with \ref lwgsm_pbuf_free immediately after function returns.
+ *
+ * \note            Application must not modify payload of pbuf chain until \ref LWGSM_EVT_CONN_SEND event
+ *
+ * \param[in]       conn: Connection handle to send data
+ * \param[in]       pbuf: Packet buffer chain to send. Total length of chain is sent
+ * \param[out]      bw: Pointer to output variable to save number of sent data when successfully sent
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_conn_send_pbuf(lwgsm_conn_p conn, lwgsm_pbuf_p pbuf, size_t* const bw, const uint32_t blocking) {
+    LWGSM_MSG_VAR_DEFINE(msg);
+
+    LWGSM_ASSERT(conn != NULL);
+    LWGSM_ASSERT(pbuf != NULL);
+    LWGSM_ASSERT(pbuf->tot_len > 0);
+
+    if (bw != NULL) {
+        *bw = 0;
+    }
+
+    flush_buff(conn);                   /* Flush currently written memory if exists */
+    CONN_CHECK_CLOSED_IN_CLOSING(conn); /* Check if we can continue */
+
+    LWGSM_MSG_VAR_ALLOC(msg, blocking);
+    LWGSM_MSG_VAR_REF(msg).cmd_def = LWGSM_CMD_CIPSEND;
+
+    LWGSM_MSG_VAR_REF(msg).msg.conn_send.conn = conn;
+    LWGSM_MSG_VAR_REF(msg).msg.conn_send.pbuf = pbuf;
+    LWGSM_MSG_VAR_REF(msg).msg.conn_send.btw = pbuf->tot_len;
+    LWGSM_MSG_VAR_REF(msg).msg.conn_send.bw = bw;
+    LWGSM_MSG_VAR_REF(msg).msg.conn_send.val_id = lwgsmi_conn_get_val_id(conn);
+
+    /* Hold reference until stack is done with the data. Released on "SEND OK" or on error */
+    lwgsm_core_lock();
+    lwgsm_pbuf_ref(pbuf);
+    lwgsm_core_unlock();
+
+    return lwgsmi_send_msg_to_producer_mbox(&LWGSM_MSG_VAR_REF(msg), lwgsmi_initiate_cmd, 60000);
+}
+
 /**
  * \brief           Notify connection about received data which means connection is ready to accept more data
  *
@@ -455,6 +916,9 @@ lwgsm_conn_get_from_evt(lwgsm_evt_t* evt) {
 /**
  * \brief           Write data to connection buffer and if it is full, send it non-blocking way
  * \note            This function may only be called from core (connection callbacks)
+ * \note            When \ref LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT is enabled, buffered data are sent automatically
+ *                  after write inactivity timeout or when \ref LWGSM_CFG_CONN_WRITE_FLUSH_THRESHOLD bytes are buffered.
+ *                  Both are configurable per connection with \ref lwgsm_conn_set_write_flush
  * \param[in]       conn: Connection to write
  * \param[in]       data: Data to copy to write buffer
  * \param[in]       btw: Number of bytes to write
@@ -501,7 +965,7 @@ lwgsm_conn_write(lwgsm_conn_p conn, const void* data, size_t btw, uint8_t flush,
             if (conn_send(conn, NULL, 0, conn->buff.buff, conn->buff.ptr, NULL, 1, 0) != lwgsmOK) {
                 LWGSM_DEBUGF(LWGSM_CFG_DBG_CONN | LWGSM_DBG_TYPE_TRACE, "[LWGSM CONN] Free write buffer: %p\r\n",
                              conn->buff.buff);
-                lwgsm_mem_free_s((void**)&conn->buff.buff);
+                LWGSMI_CONN_BUFF_FREE_S(conn->buff.buff);
             }
             conn->buff.buff = NULL;
         }
@@ -510,17 +974,17 @@ lwgsm_conn_write(lwgsm_conn_p conn, const void* data, size_t btw, uint8_t flush,
     /* Step 2 */
     while (btw >= LWGSM_CFG_CONN_MAX_DATA_LEN) {
         uint8_t* buff;
-        buff = lwgsm_mem_malloc(sizeof(*buff) * LWGSM_CFG_CONN_MAX_DATA_LEN);
+        buff = LWGSMI_CONN_BUFF_ALLOC();
         if (buff != NULL) {
             LWGSM_MEMCPY(buff, d, LWGSM_CFG_CONN_MAX_DATA_LEN); /* Copy data to buffer */
             if (conn_send(conn, NULL, 0, buff, LWGSM_CFG_CONN_MAX_DATA_LEN, NULL, 1, 0) != lwgsmOK) {
                 LWGSM_DEBUGF(LWGSM_CFG_DBG_CONN | LWGSM_DBG_TYPE_TRACE, "[LWGSM CONN] Free write buffer: %p\r\n",
                              (void*)buff);
-                lwgsm_mem_free_s((void**)&buff);
+                LWGSMI_CONN_BUFF_FREE_S(buff);
                 return lwgsmERRMEM;
             }
         } else {
-            return lwgsmERRMEM;
+            return LWGSMI_ERRMEM;
         }
 
         btw -= LWGSM_CFG_CONN_MAX_DATA_LEN; /* Decrease remaining length */
@@ -529,7 +993,7 @@ lwgsm_conn_write(lwgsm_conn_p conn, const void* data, size_t btw, uint8_t flush,
 
     /* Step 3 */
     if (conn->buff.buff == NULL) {
-        conn->buff.buff = lwgsm_mem_malloc(sizeof(*conn->buff.buff) * LWGSM_CFG_CONN_MAX_DATA_LEN);
+        conn->buff.buff = LWGSMI_CONN_BUFF_ALLOC();
         conn->buff.len = LWGSM_CFG_CONN_MAX_DATA_LEN;
         conn->buff.ptr = 0;
 
@@ -543,13 +1007,23 @@ lwgsm_conn_write(lwgsm_conn_p conn, const void* data, size_t btw, uint8_t flush,
             LWGSM_MEMCPY(conn->buff.buff, d, btw); /* Copy data to memory */
             conn->buff.ptr = btw;
         } else {
-            return lwgsmERRMEM;
+            return LWGSMI_ERRMEM;
         }
     }
 
     /* Step 4 */
     if (flush && conn->buff.buff != NULL) {
         flush_buff(conn);
+#if LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT > 0
+    } else if (conn->buff.buff != NULL && conn->buff.ptr > 0) {
+        /* Coalesce small writes, send them once threshold is reached or after inactivity */
+        if (conn->buff.ptr >= CONN_WRITE_FLUSH_THRESHOLD(conn)) {
+            flush_buff(conn);
+        } else {
+            conn->write_time = lwgsm_sys_now();
+            conn_write_start_flush_timeout(conn, CONN_WRITE_FLUSH_TIMEOUT(conn));
+        }
+#endif /* LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT > 0 */
     }
 
     /* Calculate number of available memory after write operation */
@@ -581,6 +1055,85 @@ lwgsm_conn_get_total_recved_count(lwgsm_conn_p conn) {
     return tot;
 }
 
+#if LWGSM_CFG_CONN_STATS || __DOXYGEN__
+
+/**
+ * \brief           Get connection statistics
+ * \note            Statistics are reset each time connection becomes active
+ * \param[in]       conn: Connection handle
+ * \param[out]      stats: Pointer to output statistics structure
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_conn_get_stats(lwgsm_conn_p conn, lwgsm_conn_stats_t* stats) {
+    LWGSM_ASSERT(conn != NULL);
+    LWGSM_ASSERT(stats != NULL);
+
+    lwgsm_core_lock();
+    LWGSM_MEMCPY(stats, &conn->stats, sizeof(*stats));
+    stats->rtt_avg = conn->stats.send_ok > 0 ? (conn->stats_rtt_sum / conn->stats.send_ok) : 0;
+    lwgsm_core_unlock();
+    return lwgsmOK;
+}
+
+#endif /* LWGSM_CFG_CONN_STATS || __DOXYGEN__ */
+
+#if LWGSM_CFG_CONN_SCHED || __DOXYGEN__
+
+/**
+ * \brief           Set send scheduling weight for connection
+ *
+ * Weight is number of `CIPSEND` chunks connection sends in a row,
+ * before it gives turn to other connections with pending data.
+ * Use higher value for bulk transfers and lower for interactive connections.
+ *
+ * \note            Weight is reset to \ref LWGSM_CFG_CONN_SCHED_WEIGHT each time connection becomes active
+ * \param[in]       conn: Connection handle
+ * \param[in]       weight: Number of chunks. Set to `0` to use \ref LWGSM_CFG_CONN_SCHED_WEIGHT
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_conn_set_sched_weight(lwgsm_conn_p conn, uint8_t weight) {
+    LWGSM_ASSERT(conn != NULL);
+
+    lwgsm_core_lock();
+    conn->sched_weight = weight;
+    lwgsm_core_unlock();
+    return lwgsmOK;
+}
+
+#endif /* LWGSM_CFG_CONN_SCHED || __DOXYGEN__ */
+
+#if LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT > 0 || __DOXYGEN__
+
+/**
+ * \brief           Set automatic write flush parameters for connection
+ *
+ * Use short timeout for interactive connections and longer timeout
+ * or higher threshold for bulk transfers written in small pieces.
+ *
+ * \note            Parameters are reset to global configuration each time connection becomes active.
+ *                  New timeout applies to writes made after this call
+ * \param[in]       conn: Connection handle
+ * \param[in]       timeout: Write inactivity time in units of milliseconds.
+ *                      Set to `0` to use \ref LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT
+ * \param[in]       threshold: Number of buffered bytes that triggers immediate send.
+ *                      Set to `0` to use \ref LWGSM_CFG_CONN_WRITE_FLUSH_THRESHOLD
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_conn_set_write_flush(lwgsm_conn_p conn, uint32_t timeout, size_t threshold) {
+    LWGSM_ASSERT(conn != NULL);
+
+    lwgsm_core_lock();
+    conn->write_flush_timeout = timeout;
+    conn->write_flush_threshold = threshold;
+    lwgsm_core_unlock();
+    return lwgsmOK;
+}
+
+#endif /* LWGSM_CFG_CONN_WRITE_FLUSH_TIMEOUT > 0 || __DOXYGEN__ */
+
 /**
  * \brief           Get connection remote IP address
  * \param[in]       conn: Connection handle
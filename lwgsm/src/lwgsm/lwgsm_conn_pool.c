@@ -0,0 +1,321 @@
+/**
+ * \file            lwgsm_conn_pool.c
+ * \brief           Connection pool with keep-alive reuse
+ */
+
+/*
+ * Copyright (c) 2022 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGSM - Lightweight GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include "lwgsm/lwgsm_conn_pool.h"
+#include "lwgsm/lwgsm_private.h"
+
+#if LWGSM_CFG_CONN_POOL || __DOXYGEN__
+
+/**
+ * \brief           Connection pool entry
+ */
+typedef struct {
+    lwgsm_conn_p conn;                             /*!< Connection handle. Entry is free when set to `NULL` */
+    uint8_t val_id;                                /*!< Connection validation ID when entry was created */
+    lwgsm_conn_type_t type;                        /*!< Connection type */
+    char host[LWGSM_CFG_CONN_POOL_HOST_MAX_LEN];   /*!< Remote host */
+    lwgsm_port_t port;                             /*!< Remote port */
+    uint8_t in_use;                                /*!< Set to `1` when connection is acquired by application */
+    uint32_t idle_time;                            /*!< Time when connection was released to the pool */
+} lwgsm_conn_pool_entry_t;
+
+static lwgsm_conn_pool_entry_t pool[LWGSM_CFG_CONN_POOL_SIZE]; /*!< List of pooled connections */
+static uint8_t pool_tmr;                                        /*!< Status if idle timeout is scheduled */
+
+static void pool_start_idle_timeout(uint32_t time);
+
+/**
+ * \brief           Check if entry still holds the same connection it was created for
+ * \note            Connection may be closed by remote side (`CLOSED` URC) or by application,
+ *                  or even opened again for different remote in the meantime
+ * \param[in]       e: Pool entry
+ * \return          `1` if valid, `0` otherwise
+ */
+static uint8_t
+pool_entry_is_valid(lwgsm_conn_pool_entry_t* e) {
+    return e->conn != NULL && e->conn->status.f.active && !e->conn->status.f.in_closing
+           && e->conn->val_id == e->val_id;
+}
+
+/**
+ * \brief           Find pool entry for connection
+ * \param[in]       conn: Connection handle
+ * \return          Pool entry on success, `NULL` otherwise
+ */
+static lwgsm_conn_pool_entry_t*
+pool_find_entry(lwgsm_conn_p conn) {
+    for (size_t i = 0; i < LWGSM_ARRAYSIZE(pool); ++i) {
+        if (pool[i].conn == conn) {
+            return &pool[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Connection event function used while connection is idle in the pool
+ * \param[in]       evt: Event information with data
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t otherwise
+ */
+static lwgsmr_t
+pool_conn_evt_fn(lwgsm_evt_t* evt) {
+    lwgsm_conn_p c = lwgsm_conn_get_from_evt(evt);
+    lwgsm_conn_pool_entry_t* e;
+
+    switch (lwgsm_evt_get_type(evt)) {
+        case LWGSM_EVT_CONN_CLOSE: {
+            /* Closed by remote side or on idle timeout, remove it from the pool */
+            if ((e = pool_find_entry(c)) != NULL) {
+                LWGSM_DEBUGF(LWGSM_CFG_DBG_CONN | LWGSM_DBG_TYPE_TRACE, "[LWGSM CONN POOL] Idle connection %d closed\r\n",
+                             (int)c->num);
+                e->conn = NULL;
+            }
+            break;
+        }
+        case LWGSM_EVT_CONN_RECV: {
+            /* Nobody is interested in data on idle connection */
+            LWGSM_DEBUGF(LWGSM_CFG_DBG_CONN | LWGSM_DBG_TYPE_TRACE,
+                         "[LWGSM CONN POOL] Dropped %d byte(s) on idle connection %d\r\n",
+                         (int)lwgsm_pbuf_length(lwgsm_evt_conn_recv_get_buff(evt), 1), (int)c->num);
+            break;
+        }
+        default:
+            break;
+    }
+    return lwgsmOK;
+}
+
+/**
+ * \brief           Idle timeout callback, closes connections idle for too long
+ * \param[in]       arg: Custom argument, not used
+ */
+static void
+pool_idle_timeout_cb(void* arg) {
+    uint32_t now = lwgsm_sys_now(), diff, next = 0;
+
+    LWGSM_UNUSED(arg);
+
+    pool_tmr = 0;
+    for (size_t i = 0; i < LWGSM_ARRAYSIZE(pool); ++i) {
+        lwgsm_conn_pool_entry_t* e = &pool[i];
+        if (e->conn == NULL || e->in_use) {
+            continue;
+        }
+        if (!pool_entry_is_valid(e)) {
+            e->conn = NULL;
+            continue;
+        }
+        diff = now - e->idle_time;
+        if (diff >= LWGSM_CFG_CONN_POOL_IDLE_TIMEOUT) {
+            LWGSM_DEBUGF(LWGSM_CFG_DBG_CONN | LWGSM_DBG_TYPE_TRACE,
+                         "[LWGSM CONN POOL] Closing idle connection %d\r\n", (int)e->conn->num);
+            lwgsm_conn_close(e->conn, 0); /* Entry is removed on close event */
+        } else if (next == 0 || (LWGSM_CFG_CONN_POOL_IDLE_TIMEOUT - diff) < next) {
+            next = LWGSM_CFG_CONN_POOL_IDLE_TIMEOUT - diff;
+        }
+    }
+    if (next > 0) {
+        pool_start_idle_timeout(next);
+    }
+}
+
+/**
+ * \brief           Schedule idle timeout check if not already scheduled
+ * \param[in]       time: Time in milliseconds until timeout expires
+ */
+static void
+pool_start_idle_timeout(uint32_t time) {
+    if (!pool_tmr && lwgsm_timeout_add(time, pool_idle_timeout_cb, NULL) == lwgsmOK) {
+        pool_tmr = 1;
+    }
+}
+
+/**
+ * \brief           Get connection for specific remote from the pool or start a new one
+ *
+ * Idle connection with the same type, host and port is reused when available,
+ * otherwise new connection is started and added to the pool.
+ *
+ * \note            Function is blocking when new connection must be started
+ *                  and may not be called from connection callback
+ *
+ * \param[out]      conn: Pointer to output connection handle
+ * \param[in]       type: Connection type. This parameter can be a value of \ref lwgsm_conn_type_t enumeration
+ * \param[in]       host: Connection host. Compared as string for reuse
+ * \param[in]       port: Connection port
+ * \param[in]       arg: Pointer to user argument, set to connection
+ * \param[in]       conn_evt_fn: Callback function for this connection
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_conn_pool_acquire(lwgsm_conn_p* conn, lwgsm_conn_type_t type, const char* const host, lwgsm_port_t port,
+                        void* const arg, lwgsm_evt_fn conn_evt_fn) {
+    lwgsm_conn_pool_entry_t* e = NULL;
+    lwgsm_conn_p c = NULL;
+    lwgsmr_t res;
+
+    LWGSM_ASSERT(conn != NULL);
+    LWGSM_ASSERT(host != NULL);
+    LWGSM_ASSERT(strlen(host) < LWGSM_CFG_CONN_POOL_HOST_MAX_LEN);
+    LWGSM_ASSERT(port > 0);
+    LWGSM_ASSERT(conn_evt_fn != NULL);
+
+    *conn = NULL;
+
+    /* Try with idle connection first */
+    lwgsm_core_lock();
+    for (size_t i = 0; i < LWGSM_ARRAYSIZE(pool); ++i) {
+        e = &pool[i];
+        if (e->conn == NULL || e->in_use) {
+            continue;
+        }
+        if (!pool_entry_is_valid(e)) {
+            e->conn = NULL; /* Stale entry, connection closed in the meantime */
+            continue;
+        }
+        if (e->type == type && e->port == port && !strcmp(e->host, host)) {
+            e->in_use = 1;
+            e->conn->evt_func = conn_evt_fn;
+            e->conn->arg = arg;
+            c = e->conn;
+            break;
+        }
+    }
+    lwgsm_core_unlock();
+    if (c != NULL) {
+        LWGSM_DEBUGF(LWGSM_CFG_DBG_CONN | LWGSM_DBG_TYPE_TRACE, "[LWGSM CONN POOL] Reusing connection %d\r\n",
+                     (int)c->num);
+        *conn = c;
+        return lwgsmOK;
+    }
+
+    /* Start new connection and add it to the pool */
+    if ((res = lwgsm_conn_start(&c, type, host, port, arg, conn_evt_fn, 1)) != lwgsmOK) {
+        return res;
+    }
+    lwgsm_core_lock();
+    for (size_t i = 0; i < LWGSM_ARRAYSIZE(pool); ++i) {
+        if (pool[i].conn != NULL && !pool_entry_is_valid(&pool[i])) {
+            pool[i].conn = NULL; /* Release stale entries, also those never given back by application */
+        }
+    }
+    e = pool_find_entry(NULL); /* Get free entry */
+    if (e != NULL) {
+        e->conn = c;
+        e->val_id = c->val_id;
+        e->type = type;
+        e->port = port;
+        e->in_use = 1;
+        strncpy(e->host, host, sizeof(e->host) - 1);
+        e->host[sizeof(e->host) - 1] = '\0';
+    }
+    lwgsm_core_unlock();
+    LWGSM_DEBUGW(LWGSM_CFG_DBG_CONN | LWGSM_DBG_TYPE_TRACE, e == NULL,
+                 "[LWGSM CONN POOL] Pool is full, connection %d not pooled\r\n", (int)c->num);
+    *conn = c;
+    return lwgsmOK;
+}
+
+/**
+ * \brief           Return connection acquired with \ref lwgsm_conn_pool_acquire back to the pool
+ *
+ * Connection callback is replaced with internal one. Application does not receive
+ * any more events for connection, unless it acquires it again.
+ *
+ * \note            Function may be called from connection callback
+ *
+ * Connection not kept in the pool, because pool was full when it was acquired,
+ * is always closed, regardless of `reuse` parameter.
+ *
+ * \param[in]       conn: Connection handle
+ * \param[in]       reuse: Set to `1` to keep connection open for reuse,
+ *                      `0` to close it and remove it from the pool
+ * \return          \ref lwgsmOK on success, \ref lwgsmCLOSED if connection is already closed,
+ *                      member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_conn_pool_release(lwgsm_conn_p conn, uint8_t reuse) {
+    lwgsm_conn_pool_entry_t* e;
+    lwgsmr_t res = lwgsmOK;
+
+    LWGSM_ASSERT(conn != NULL);
+
+    lwgsm_core_lock();
+    e = pool_find_entry(conn);
+    if (e != NULL && !pool_entry_is_valid(e)) {
+        /* Closed in the meantime, handle may already be used for other connection */
+        e->conn = NULL;
+        res = lwgsmCLOSED;
+    } else if (e == NULL) {
+        /* Not pooled, application is the only owner and connection cannot stay open */
+        if (conn->status.f.active && !conn->status.f.in_closing) {
+            reuse = 0;
+        } else {
+            res = lwgsmCLOSED;
+        }
+    } else if (reuse) {
+        e->in_use = 0;
+        e->idle_time = lwgsm_sys_now();
+        conn->evt_func = pool_conn_evt_fn;
+        conn->arg = NULL;
+        pool_start_idle_timeout(LWGSM_CFG_CONN_POOL_IDLE_TIMEOUT);
+    } else {
+        e->conn = NULL;
+    }
+    lwgsm_core_unlock();
+
+    if (res == lwgsmOK && !reuse) {
+        res = lwgsm_conn_close(conn, 0);
+    }
+    return res;
+}
+
+/**
+ * \brief           Get number of idle connections in the pool, ready for reuse
+ * \return          Number of idle connections
+ */
+size_t
+lwgsm_conn_pool_get_idle_count(void) {
+    size_t cnt = 0;
+
+    lwgsm_core_lock();
+    for (size_t i = 0; i < LWGSM_ARRAYSIZE(pool); ++i) {
+        if (pool[i].conn != NULL && !pool[i].in_use && pool_entry_is_valid(&pool[i])) {
+            ++cnt;
+        }
+    }
+    lwgsm_core_unlock();
+    return cnt;
+}
+
+#endif /* LWGSM_CFG_CONN_POOL || __DOXYGEN__ */
@@ -0,0 +1,247 @@
+/**
+ * \file            lwgsm_dns.c
+ * \brief           Domain name resolver with local cache
+ */
+
+/*
+ * Copyright (c) 2022 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGSM - Lightweight GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include "lwgsm/lwgsm_dns.h"
+#include "lwgsm/lwgsm_private.h"
+
+#if LWGSM_CFG_DNS || __DOXYGEN__
+
+/**
+ * \brief           DNS cache entry
+ */
+typedef struct {
+    char host[LWGSM_CFG_DNS_HOST_MAX_LEN]; /*!< Host name. Entry is free when string is empty */
+    lwgsm_ip_t ip;                         /*!< Resolved IP address */
+    uint32_t time;                         /*!< Time when entry was resolved, used for TTL */
+    uint32_t last_used;                    /*!< Time of last lookup, used for LRU replacement */
+    uint8_t refresh;                       /*!< Set to `1` when entry is being resolved again */
+} lwgsm_dns_cache_entry_t;
+
+static lwgsm_dns_cache_entry_t cache[LWGSM_CFG_DNS_CACHE_SIZE]; /*!< DNS cache entries */
+
+/**
+ * \brief           Send command to resolve host name on device, without cache lookup
+ * \param[in]       host: Pointer to host name to get IP for
+ * \param[out]      ip: Pointer to \ref lwgsm_ip_t variable to save IP. Can be set to `NULL`
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \param[in]       copy: Set to `1` to copy host name to message, when its memory may change before execution
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+static lwgsmr_t
+dns_resolve(const char* host, lwgsm_ip_t* const ip, const lwgsm_api_cmd_evt_fn evt_fn, void* const evt_arg,
+            const uint32_t blocking, uint8_t copy) {
+    LWGSM_MSG_VAR_DEFINE(msg);
+
+    LWGSM_MSG_VAR_ALLOC(msg, blocking);
+    LWGSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWGSM_MSG_VAR_REF(msg).cmd_def = LWGSM_CMD_CDNSGIP;
+    if (copy) {
+        strncpy(LWGSM_MSG_VAR_REF(msg).msg.dns_getbyhostname.host_copy, host,
+                sizeof(LWGSM_MSG_VAR_REF(msg).msg.dns_getbyhostname.host_copy) - 1);
+        host = LWGSM_MSG_VAR_REF(msg).msg.dns_getbyhostname.host_copy;
+    }
+    LWGSM_MSG_VAR_REF(msg).msg.dns_getbyhostname.host = host;
+    LWGSM_MSG_VAR_REF(msg).msg.dns_getbyhostname.ip = ip;
+
+    return lwgsmi_send_msg_to_producer_mbox(&LWGSM_MSG_VAR_REF(msg), lwgsmi_initiate_cmd, 20000);
+}
+
+/**
+ * \brief           Find valid cache entry for host
+ * \note            Expired entries are released on the way
+ * \param[in]       host: Host name to search for
+ * \param[in]       now: Current time in milliseconds
+ * \return          Cache entry on success, `NULL` otherwise
+ */
+static lwgsm_dns_cache_entry_t*
+dns_cache_find(const char* host, uint32_t now) {
+    for (size_t i = 0; i < LWGSM_ARRAYSIZE(cache); ++i) {
+        lwgsm_dns_cache_entry_t* e = &cache[i];
+        if (e->host[0] == '\0') {
+            continue;
+        }
+        if ((now - e->time) >= LWGSM_CFG_DNS_CACHE_TTL) {
+            e->host[0] = '\0'; /* Entry expired */
+            continue;
+        }
+        if (!strcmp(e->host, host)) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Add or update cache entry with resolved IP
+ * \note            Function is called from processing thread when `+CDNSGIP` response is received
+ * \param[in]       host: Resolved host name
+ * \param[in]       ip: Resolved IP address
+ */
+void
+lwgsmi_dns_cache_add(const char* host, const lwgsm_ip_t* ip) {
+    lwgsm_dns_cache_entry_t* e;
+    uint32_t now;
+
+    if (host == NULL || strlen(host) >= LWGSM_CFG_DNS_HOST_MAX_LEN) {
+        return; /* Not possible to cache it */
+    }
+
+    lwgsm_core_lock();
+    now = lwgsm_sys_now();
+    if ((e = dns_cache_find(host, now)) == NULL) {
+        /* Use free entry or the one least recently used */
+        e = &cache[0];
+        for (size_t i = 0; i < LWGSM_ARRAYSIZE(cache); ++i) {
+            if (cache[i].host[0] == '\0') {
+                e = &cache[i];
+                break;
+            }
+            if ((now - cache[i].last_used) > (now - e->last_used)) {
+                e = &cache[i];
+            }
+        }
+        strcpy(e->host, host);
+    }
+    LWGSM_MEMCPY(&e->ip, ip, sizeof(e->ip));
+    e->time = now;
+    e->last_used = now;
+    e->refresh = 0;
+    lwgsm_core_unlock();
+}
+
+/**
+ * \brief           Get IP address for host from local cache
+ *
+ * Entry which expires in less than \ref LWGSM_CFG_DNS_CACHE_REFRESH milliseconds
+ * is resolved again in background, cached IP is returned meanwhile.
+ *
+ * \param[in]       host: Host name to get IP for
+ * \param[out]      ip: Pointer to output IP address. Set to `NULL` to only check cache
+ * \return          `1` if valid entry exists in cache, `0` otherwise
+ */
+uint8_t
+lwgsm_dns_cache_get(const char* host, lwgsm_ip_t* const ip) {
+    lwgsm_dns_cache_entry_t* e;
+    uint8_t refresh = 0, found;
+    uint32_t now;
+
+    if (host == NULL) {
+        return 0;
+    }
+
+    lwgsm_core_lock();
+    now = lwgsm_sys_now();
+    if ((e = dns_cache_find(host, now)) != NULL) {
+        e->last_used = now;
+        if (ip != NULL) {
+            LWGSM_MEMCPY(ip, &e->ip, sizeof(*ip));
+        }
+        if (LWGSM_CFG_DNS_CACHE_REFRESH > 0 && !e->refresh
+            && (now - e->time) >= (LWGSM_CFG_DNS_CACHE_TTL - LWGSM_CFG_DNS_CACHE_REFRESH)) {
+            e->refresh = refresh = 1;
+        }
+    }
+    found = e != NULL;
+    lwgsm_core_unlock();
+
+    /*
+     * Entry may be evicted or flushed before command is executed,
+     * host name is copied to the message and result is added to cache as new
+     */
+    if (refresh && dns_resolve(host, NULL, NULL, NULL, 0, 1) != lwgsmOK) {
+        lwgsm_core_lock();
+        if ((e = dns_cache_find(host, lwgsm_sys_now())) != NULL) {
+            e->refresh = 0;
+        }
+        lwgsm_core_unlock();
+    }
+    return found;
+}
+
+/**
+ * \brief           Remove all entries from DNS cache
+ */
+void
+lwgsm_dns_cache_flush(void) {
+    lwgsm_core_lock();
+    LWGSM_MEMSET(cache, 0x00, sizeof(cache));
+    lwgsm_core_unlock();
+}
+
+/**
+ * \brief           Get IP address from host name
+ *
+ * Local cache is checked first. In case of cache hit, function returns immediately
+ * and calls `evt_fn` from caller context. Otherwise device is asked to resolve the name
+ * and result is added to the cache.
+ *
+ * \param[in]       host: Pointer to host name to get IP for
+ * \param[out]      ip: Pointer to \ref lwgsm_ip_t variable to save IP.
+ *                      Can be set to `NULL` when result is only needed in cache
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_dns_gethostbyname(const char* host, lwgsm_ip_t* const ip, const lwgsm_api_cmd_evt_fn evt_fn,
+                        void* const evt_arg, const uint32_t blocking) {
+    LWGSM_ASSERT(host != NULL && strlen(host) > 0);
+
+    if (lwgsm_dns_cache_get(host, ip)) {
+        if (evt_fn != NULL) {
+            evt_fn(lwgsmOK, evt_arg);
+        }
+        return lwgsmOK;
+    }
+    return dns_resolve(host, ip, evt_fn, evt_arg, blocking, 0);
+}
+
+/**
+ * \brief           Resolve host name in background and keep result in cache
+ *
+ * Use it during startup for hosts application connects to later,
+ * so that \ref lwgsm_conn_start does not wait for name resolution.
+ *
+ * \note            Host name memory must stay valid until command is executed
+ * \param[in]       host: Host name to resolve
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_dns_prewarm(const char* host) {
+    return lwgsm_dns_gethostbyname(host, NULL, NULL, NULL, 0);
+}
+
+#endif /* LWGSM_CFG_DNS || __DOXYGEN__ */
@@ -34,6 +34,16 @@
 #include "lwgsm/lwgsm_evt.h"
 #include "lwgsm/lwgsm_private.h"
 
+#if LWGSM_CFG_STATIC_ALLOC
+LWGSM_MEM_POOL_DEFINE(lwgsmi_evt_func_pool, LWGSM_MEM_POOL_EVT_FUNC, sizeof(lwgsm_evt_func_t),
+                      LWGSM_CFG_STATIC_EVT_FUNC_NUM);
+#define EVT_FUNC_ALLOC()    lwgsmi_mem_pool_alloc(&lwgsmi_evt_func_pool)
+#define EVT_FUNC_FREE_S(fn) lwgsmi_mem_pool_free_s(&lwgsmi_evt_func_pool, (void**)&(fn))
+#else /* LWGSM_CFG_STATIC_ALLOC */
+#define EVT_FUNC_ALLOC()    lwgsm_mem_malloc(sizeof(lwgsm_evt_func_t))
+#define EVT_FUNC_FREE_S(fn) lwgsm_mem_free_s((void**)&(fn))
+#endif /* !LWGSM_CFG_STATIC_ALLOC */
+
 /**
  * \brief           Register callback function for global (non-connection based) events
  * \param[in]       fn: Callback function to call on specific event
@@ -57,7 +67,7 @@ lwgsm_evt_register(lwgsm_evt_fn fn) {
     }
 
     if (res == lwgsmOK) {
-        new_func = lwgsm_mem_malloc(sizeof(*new_func));
+        new_func = EVT_FUNC_ALLOC();
         if (new_func != NULL) {
             LWGSM_MEMSET(new_func, 0x00, sizeof(*new_func));
             new_func->fn = fn; /* Set function pointer */
@@ -66,11 +76,11 @@ lwgsm_evt_register(lwgsm_evt_fn fn) {
                 func->next = new_func; /* Set new function as next */
                 res = lwgsmOK;
             } else {
-                lwgsm_mem_free_s((void**)&new_func);
+                EVT_FUNC_FREE_S(new_func);
                 res = lwgsmERRMEM;
             }
         } else {
-            res = lwgsmERRMEM;
+            res = LWGSMI_ERRMEM;
         }
     }
     lwgsm_core_unlock();
@@ -92,7 +102,7 @@ lwgsm_evt_unregister(lwgsm_evt_fn fn) {
     for (prev = lwgsm.evt_func, func = lwgsm.evt_func->next; func != NULL; prev = func, func = func->next) {
         if (func->fn == fn) {
             prev->next = func->next;
-            lwgsm_mem_free_s((void**)&func);
+            EVT_FUNC_FREE_S(func);
             break;
         }
     }
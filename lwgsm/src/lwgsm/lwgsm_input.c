@@ -59,6 +59,47 @@ lwgsm_input(const void* data, size_t len) {
     return lwgsmOK;
 }
 
+/**
+ * \brief           Reserve contiguous region in input buffer for in-place write
+ *
+ * Low-level driver (DMA) can receive data directly into returned memory,
+ * without intermediate buffer and copy with \ref lwgsm_input.
+ * Received data must be confirmed with \ref lwgsm_input_write_commit.
+ *
+ * \note            \ref LWGSM_CFG_INPUT_USE_PROCESS must be disabled to use this function
+ * \param[out]      len: Output variable to write length of reserved region in units of bytes
+ * \return          Address of reserved region or `NULL` if buffer is full or not initialized
+ */
+void*
+lwgsm_input_write_reserve(size_t* len) {
+    if (len == NULL) {
+        return NULL;
+    }
+    if (!lwgsm.status.f.initialized || lwgsm.buff.buff == NULL) {
+        *len = 0;
+        return NULL;
+    }
+    return lwgsm_buff_write_reserve(&lwgsm.buff, len);
+}
+
+/**
+ * \brief           Commit data written to region reserved with \ref lwgsm_input_write_reserve
+ * \note            \ref LWGSM_CFG_INPUT_USE_PROCESS must be disabled to use this function
+ * \param[in]       len: Number of bytes written to reserved region
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_input_write_commit(size_t len) {
+    if (!lwgsm.status.f.initialized || lwgsm.buff.buff == NULL) {
+        return lwgsmERR;
+    }
+    len = lwgsm_buff_write_commit(&lwgsm.buff, len);  /* Make data available for processing */
+    lwgsm_sys_mbox_putnow(&lwgsm.mbox_process, NULL); /* Write empty box, don't care if write fails */
+    lwgsm_recv_total_len += len;                      /* Update total number of received bytes */
+    ++lwgsm_recv_calls;                               /* Update number of calls */
+    return lwgsmOK;
+}
+
 #endif /* !LWGSM_CFG_INPUT_USE_PROCESS || __DOXYGEN__ */
 
 #if LWGSM_CFG_INPUT_USE_PROCESS || __DOXYGEN__
@@ -110,6 +110,11 @@ typedef struct {
 
 static lwgsm_recv_t recv_buff;
 
+#if LWGSM_CFG_STATIC_ALLOC
+/* Static pool for command messages */
+LWGSM_MEM_POOL_DEFINE(lwgsmi_msg_pool, LWGSM_MEM_POOL_MSG, sizeof(lwgsm_msg_t), LWGSM_CFG_STATIC_MSG_NUM);
+#endif /* LWGSM_CFG_STATIC_ALLOC */
+
 static lwgsmr_t lwgsmi_process_sub_cmd(lwgsm_msg_t *msg, uint8_t *is_ok, uint16_t *is_error);
 
 /**
@@ -130,7 +135,8 @@ const size_t lwgsm_dev_mem_map_size = LWGSM_ARRAYSIZE(lwgsm_dev_mem_map);
  * \brief           List of supported devices
  */
 const lwgsm_dev_model_map_t lwgsm_dev_model_map[] = {
-#define LWGSM_DEVICE_MODEL_ENTRY(name, str_id, is_2g, is_lte) {LWGSM_DEVICE_MODEL_##name, str_id, is_2g, is_lte},
+#define LWGSM_DEVICE_MODEL_ENTRY(name, str_id, is_2g, is_lte, max_data_len)                                            \
+    {LWGSM_DEVICE_MODEL_##name, str_id, is_2g, is_lte, max_data_len},
 
 #include "lwgsm/lwgsm_models.h"
 };
@@ -151,10 +157,41 @@ const size_t lwgsm_dev_model_map_size = LWGSM_ARRAYSIZE(lwgsm_dev_model_map);
             if ((m)->msg.conn_send.data != NULL) {                                                                     \
                 LWGSM_DEBUGF(LWGSM_CFG_DBG_CONN | LWGSM_DBG_TYPE_TRACE, "[LWGSM CONN] Free write buffer fau: %p\r\n",  \
                              (void*)(m)->msg.conn_send.data);                                                          \
-                lwgsm_mem_free_s((void**)&((m)->msg.conn_send.data));                                                  \
+                LWGSMI_CONN_BUFF_FREE_S((m)->msg.conn_send.data);                                                      \
             }                                                                                                          \
         }                                                                                                              \
+        if ((m) != NULL && (m)->msg.conn_send.pbuf != NULL) {                                                          \
+            LWGSM_DEBUGF(LWGSM_CFG_DBG_CONN | LWGSM_DBG_TYPE_TRACE, "[LWGSM CONN] Release write pbuf: %p\r\n",       \
+                         (void*)(m)->msg.conn_send.pbuf);                                                              \
+            lwgsm_pbuf_free((m)->msg.conn_send.pbuf);                                                                  \
+            (m)->msg.conn_send.pbuf = NULL;                                                                            \
+        }                                                                                                              \
+    } while (0)
+
+#if LWGSM_CFG_CONN_STATS
+/**
+ * \brief           Update connection statistics field
+ * \param[in]       c: Connection handle
+ * \param[in]       field: Member of \ref lwgsm_conn_stats_t to increase
+ * \param[in]       val: Value to add
+ */
+#define CONN_STATS_ADD(c, field, val)                                                                                  \
+    do {                                                                                                               \
+        (c)->stats.field += (val);                                                                                     \
     } while (0)
+#else /* LWGSM_CFG_CONN_STATS */
+#define CONN_STATS_ADD(c, field, val)
+#endif /* !LWGSM_CFG_CONN_STATS */
+
+#if LWGSM_CFG_CONN_SCHED
+/**
+ * \brief           Check if send message gave turn to other connections
+ * \param[in]       m: Send message
+ */
+#define CONN_SEND_YIELD(m) ((m)->msg.conn_send.yield)
+#else /* LWGSM_CFG_CONN_SCHED */
+#define CONN_SEND_YIELD(m) 0
+#endif /* !LWGSM_CFG_CONN_SCHED */
 
 /**
  * \brief           Send connection callback for "data send"
@@ -446,6 +483,13 @@ lwgsmi_send_sms_stat(lwgsm_sms_status_t status, uint8_t q, uint8_t c) {
  */
 static void
 reset_connections(uint8_t forced) {
+    /* Finish connections waiting for connection result */
+    for (size_t i = 0; i < LWGSM_CFG_MAX_CONNS; ++i) {
+        if (lwgsm.m.conns[i].status.f.connecting) {
+            lwgsmi_conn_connect_result(LWGSM_U8(i), LWGSM_CONN_CONNECT_ERROR, lwgsmERRCONNFAIL);
+        }
+    }
+
     lwgsm.evt.type = LWGSM_EVT_CONN_CLOSE;
     lwgsm.evt.evt.conn_active_close.forced = forced;
     lwgsm.evt.evt.conn_active_close.res = lwgsmOK;
@@ -453,6 +497,7 @@ reset_connections(uint8_t forced) {
     for (size_t i = 0; i < LWGSM_CFG_MAX_CONNS; ++i) { /* Check all connections */
         if (lwgsm.m.conns[i].status.f.active) {
             lwgsm.m.conns[i].status.f.active = 0;
+            lwgsmi_conn_remove_timeouts(&lwgsm.m.conns[i]);
 
             lwgsm.evt.evt.conn_active_close.conn = &lwgsm.m.conns[i];
             lwgsm.evt.evt.conn_active_close.client = lwgsm.m.conns[i].status.f.client;
@@ -574,7 +619,8 @@ lwgsmi_tcpip_process_send_data(void) {
         CONN_SEND_DATA_SEND_EVT(lwgsm.msg, lwgsmCLOSED);
         return lwgsmERR;
     }
-    lwgsm.msg->msg.conn_send.sent = LWGSM_MIN(lwgsm.msg->msg.conn_send.btw, LWGSM_CFG_CONN_MAX_DATA_LEN);
+    lwgsm.msg->msg.conn_send.sent =
+        LWGSM_MIN(lwgsm.msg->msg.conn_send.btw, c->max_send_len > 0 ? c->max_send_len : LWGSM_CFG_CONN_MAX_DATA_LEN);
 
     AT_PORT_SEND_BEGIN_AT();
     AT_PORT_SEND_CONST_STR("+CIPSEND=");
@@ -592,6 +638,26 @@ lwgsmi_tcpip_process_send_data(void) {
     return lwgsmOK;
 }
 
+/**
+ * \brief           Send current chunk of pbuf chain after device asked for data with "> "
+ *
+ * Chunk starts at `ptr` offset in the chain and is `sent` bytes long.
+ * It may span over several pbufs in the chain, each segment is sent as-is, without copy
+ */
+static void
+lwgsmi_tcpip_send_pbuf_data(void) {
+    lwgsm_pbuf_p p;
+    size_t off, len, btw = lwgsm.msg->msg.conn_send.sent;
+
+    p = lwgsm_pbuf_skip(lwgsm.msg->msg.conn_send.pbuf, lwgsm.msg->msg.conn_send.ptr, &off);
+    for (; p != NULL && btw > 0; p = p->next, off = 0) {
+        len = LWGSM_MIN(p->len - off, btw);
+        AT_PORT_SEND(&p->payload[off], len);
+        btw -= len;
+    }
+    AT_PORT_SEND_FLUSH();
+}
+
 /**
  * \brief           Process data sent and send remaining
  * \param[in]       sent: Status whether data were sent or not,
@@ -601,6 +667,20 @@ lwgsmi_tcpip_process_send_data(void) {
 static uint8_t
 lwgsmi_tcpip_process_data_sent(uint8_t sent) {
     if (sent) { /* Data were successfully sent */
+#if LWGSM_CFG_CONN_STATS
+        lwgsm_conn_t* c = lwgsm.msg->msg.conn_send.conn;
+        uint32_t rtt = lwgsm_sys_now() - lwgsm.msg->msg.conn_send.prompt_time;
+
+        CONN_STATS_ADD(c, send_ok, 1);
+        CONN_STATS_ADD(c, bytes_sent, lwgsm.msg->msg.conn_send.sent);
+        if (c->stats.send_ok == 1 || rtt < c->stats.rtt_min) {
+            c->stats.rtt_min = rtt;
+        }
+        if (rtt > c->stats.rtt_max) {
+            c->stats.rtt_max = rtt;
+        }
+        c->stats_rtt_sum += rtt;
+#endif /* LWGSM_CFG_CONN_STATS */
         lwgsm.msg->msg.conn_send.sent_all += lwgsm.msg->msg.conn_send.sent;
         lwgsm.msg->msg.conn_send.btw -= lwgsm.msg->msg.conn_send.sent;
         lwgsm.msg->msg.conn_send.ptr += lwgsm.msg->msg.conn_send.sent;
@@ -608,12 +688,20 @@ lwgsmi_tcpip_process_data_sent(uint8_t sent) {
             *lwgsm.msg->msg.conn_send.bw += lwgsm.msg->msg.conn_send.sent;
         }
         lwgsm.msg->msg.conn_send.tries = 0;
+#if LWGSM_CFG_CONN_SCHED
+        if (lwgsm.msg->msg.conn_send.btw > 0 && lwgsmi_conn_sched_yield(lwgsm.msg)) {
+            lwgsm.msg->msg.conn_send.yield = 1; /* Finish command here and continue when connection gets turn */
+            return 1;
+        }
+#endif /* LWGSM_CFG_CONN_SCHED */
     } else {                              /* We were not successful */
         ++lwgsm.msg->msg.conn_send.tries; /* Increase number of tries */
+        CONN_STATS_ADD(lwgsm.msg->msg.conn_send.conn, send_fail, 1);
         if (lwgsm.msg->msg.conn_send.tries
             == LWGSM_CFG_MAX_SEND_RETRIES) { /* In case we reached max number of retransmissions */
             return 1;                        /* Return 1 and indicate error */
         }
+        CONN_STATS_ADD(lwgsm.msg->msg.conn_send.conn, send_retries, 1);
     }
     if (lwgsm.msg->msg.conn_send.btw > 0) {                /* Do we still have data to send? */
         if (lwgsmi_tcpip_process_send_data() != lwgsmOK) { /* Check if we can continue */
@@ -638,7 +726,7 @@ lwgsmi_process_cipsend_response(lwgsm_recv_t* rcv, uint8_t* is_ok, uint16_t* is_
             if (!strncmp(&rcv->data[3], "SEND OK" CRLF, 7 + CRLF_LEN)) {
                 lwgsm.msg->msg.conn_send.wait_send_ok_err = 0;
                 *is_ok = lwgsmi_tcpip_process_data_sent(1); /* Process as data were sent */
-                if (*is_ok && lwgsm.msg->msg.conn_send.conn->status.f.active) {
+                if (*is_ok && lwgsm.msg->msg.conn_send.conn->status.f.active && !CONN_SEND_YIELD(lwgsm.msg)) {
                     CONN_SEND_DATA_SEND_EVT(lwgsm.msg, lwgsmOK);
                 }
             } else if (!strncmp(&rcv->data[3], "SEND FAIL" CRLF, 9 + CRLF_LEN)) {
@@ -665,15 +753,98 @@ lwgsmi_process_cipsend_response(lwgsm_recv_t* rcv, uint8_t* is_ok, uint16_t* is_
 static void
 lwgsmi_send_conn_error_cb(lwgsm_msg_t* msg, lwgsmr_t error) {
     lwgsm.evt.type = LWGSM_EVT_CONN_ERROR; /* Connection error */
-    lwgsm.evt.evt.conn_error.host = lwgsm.msg->msg.conn_start.host;
-    lwgsm.evt.evt.conn_error.port = lwgsm.msg->msg.conn_start.port;
-    lwgsm.evt.evt.conn_error.type = lwgsm.msg->msg.conn_start.type;
-    lwgsm.evt.evt.conn_error.arg = lwgsm.msg->msg.conn_start.arg;
+    lwgsm.evt.evt.conn_error.host = msg->msg.conn_start.host;
+    lwgsm.evt.evt.conn_error.port = msg->msg.conn_start.port;
+    lwgsm.evt.evt.conn_error.type = msg->msg.conn_start.type;
+    lwgsm.evt.evt.conn_error.arg = msg->msg.conn_start.arg;
     lwgsm.evt.evt.conn_error.err = error;
 
     /* Call callback specified by user on connection startup */
-    lwgsm.msg->msg.conn_start.evt_func(&lwgsm.evt);
-    LWGSM_UNUSED(msg);
+    msg->msg.conn_start.evt_func(&lwgsm.evt);
+}
+
+/**
+ * \brief           Process connection result reported by device with `n, CONNECT OK` or `n, CONNECT FAIL`
+ *
+ * `AT+CIPSTART` command finishes when device accepts it, result is received later.
+ * Start message is finished here, if producer thread is already done with it.
+ *
+ * \param[in]       num: Connection number
+ * \param[in]       res: Connection result
+ * \param[in]       err: Error code reported to application when connection failed
+ */
+void
+lwgsmi_conn_connect_result(uint8_t num, lwgsm_conn_connect_res_t res, lwgsmr_t err) {
+    lwgsm_conn_t* conn = &lwgsm.m.conns[num];
+    lwgsm_msg_t* msg = conn->start_msg;
+    uint8_t id;
+
+    if (!conn->status.f.connecting || msg == NULL) {
+        if (res == LWGSM_CONN_CONNECT_OK && !conn->status.f.active) {
+            /*
+             * Result after connection start timeout.
+             * Connection has no callback and gets closed by the stack on first event
+             */
+            id = conn->val_id;
+            lwgsmi_conn_remove_timeouts(conn);
+            LWGSM_MEMSET(conn, 0x00, sizeof(*conn));
+            conn->num = num;
+            conn->status.f.active = 1;
+            conn->status.f.client = 1;
+            conn->val_id = ++id;
+            lwgsm.evt.type = LWGSM_EVT_CONN_ACTIVE;
+            lwgsm.evt.evt.conn_active_close.client = 1;
+            lwgsm.evt.evt.conn_active_close.conn = conn;
+            lwgsm.evt.evt.conn_active_close.forced = 1;
+            lwgsmi_send_conn_cb(conn, NULL);
+        }
+        return;
+    }
+    conn->status.f.connecting = 0;
+    conn->start_msg = NULL;
+    lwgsmi_conn_remove_timeouts(conn);
+    msg->msg.conn_start.conn_res = res;
+    msg->msg.conn_start.pending = 0;
+
+    if (res == LWGSM_CONN_CONNECT_OK) {
+        id = conn->val_id;
+        LWGSM_MEMSET(conn, 0x00, sizeof(*conn)); /* Reset connection parameters */
+        conn->num = num;
+        conn->status.f.active = 1;
+        conn->val_id = ++id; /* Set new validation ID */
+
+        /* Set connection parameters */
+        conn->status.f.client = 1;
+        conn->evt_func = msg->msg.conn_start.evt_func;
+        conn->arg = msg->msg.conn_start.arg;
+        lwgsmi_conn_set_default_data_len(conn); /* Until device reports its values */
+        msg->res = lwgsmOK;
+
+        lwgsm.evt.type = LWGSM_EVT_CONN_ACTIVE; /* Connection just active */
+        lwgsm.evt.evt.conn_active_close.client = 1;
+        lwgsm.evt.evt.conn_active_close.conn = conn;
+        lwgsm.evt.evt.conn_active_close.forced = 1;
+        lwgsmi_send_conn_cb(conn, NULL);
+        lwgsmi_conn_start_timeout(conn); /* Start connection timeout timer */
+        lwgsmi_conn_query_max_send_len(); /* Query max send length for new connection */
+    } else {
+        lwgsmi_send_conn_error_cb(msg, err);
+        msg->res = err;
+    }
+
+    /* Finish message in place of producer thread */
+    if (msg->msg.conn_start.detached) {
+#if LWGSM_CFG_USE_API_FUNC_EVT
+        if (msg->evt_fn != NULL) {
+            msg->evt_fn(msg->res, msg->evt_arg);
+        }
+#endif /* LWGSM_CFG_USE_API_FUNC_EVT */
+        if (msg->is_blocking) {
+            lwgsm_sys_sem_release(&msg->sem);
+        } else {
+            LWGSM_MSG_VAR_FREE(msg);
+        }
+    }
 }
 
 /**
@@ -703,12 +874,13 @@ lwgsmi_conn_closed_process(uint8_t conn_num, uint8_t forced) {
     lwgsm_conn_t* conn = &lwgsm.m.conns[conn_num];
 
     conn->status.f.active = 0;
+    lwgsmi_conn_remove_timeouts(conn);
 
     /* Check if write buffer is set */
     if (conn->buff.buff != NULL) {
         LWGSM_DEBUGF(LWGSM_CFG_DBG_CONN | LWGSM_DBG_TYPE_TRACE, "[LWGSM CONN] Free write buffer: %p\r\n",
                      conn->buff.buff);
-        lwgsm_mem_free_s((void**)&conn->buff.buff);
+        LWGSMI_CONN_BUFF_FREE_S(conn->buff.buff);
     }
 
     /* Send event */
@@ -768,6 +940,8 @@ lwgsmi_parse_received(lwgsm_recv_t *rcv) {
 #if LWGSM_CFG_CONN
             } else if (!strncmp(rcv->data, "+RECEIVE", 8)) {
                 lwgsmi_parse_ipd(rcv->data);                                            /* Parse IPD */
+            } else if (CMD_IS_CUR(LWGSM_CMD_CIPSEND_GET) && !strncmp(rcv->data, "+CIPSEND", 8)) {
+                lwgsmi_parse_cipsend_get(rcv->data); /* Parse max send length for connection */
 #endif                                                                              /* LWGSM_CFG_CONN */
         } else if (!strncmp(rcv->data, "+CREG", 5)) {                               /* Check for +CREG indication */
             lwgsmi_parse_creg(rcv->data, LWGSM_U8(CMD_IS_CUR(LWGSM_CMD_CREG_GET))); /* Parse +CREG response */
@@ -843,6 +1017,13 @@ lwgsmi_parse_received(lwgsm_recv_t *rcv) {
                     lwgsmi_process_cipsend_response(rcv, &is_ok, &is_error);
                 }
                 lwgsmi_conn_closed_process(num, forced); /* Connection closed, process */
+            } else if (LWGSM_CHARISNUM(rcv->data[0]) && rcv->data[1] == ',' && rcv->data[2] == ' '
+                       && LWGSM_CHARTONUM(rcv->data[0]) < LWGSM_CFG_MAX_CONNS
+                       && (!strncmp(&rcv->data[3], "CONNECT OK" CRLF, 10 + CRLF_LEN)
+                           || !strncmp(&rcv->data[3], "CONNECT FAIL" CRLF, 12 + CRLF_LEN))) {
+                lwgsmi_conn_connect_result(LWGSM_CHARTONUM(rcv->data[0]),
+                                           rcv->data[11] == 'O' ? LWGSM_CONN_CONNECT_OK : LWGSM_CONN_CONNECT_ERROR,
+                                           lwgsmERRCONNFAIL);
 #endif                                               /* LWGSM_CFG_CONN */
 #if LWGSM_CFG_CALL
             } else if (rcv->data[0] == 'C' && !strncmp(rcv->data, "Call Ready" CRLF, 10 + CRLF_LEN)) {
@@ -964,41 +1145,14 @@ lwgsmi_parse_received(lwgsm_recv_t *rcv) {
                     }
                 }
             } else if (CMD_IS_CUR(LWGSM_CMD_CIPSTART)) {
-                /* For CIPSTART, OK is returned before important data */
-                if (is_ok) {
-                    is_ok = 0;
-                }
-
-                /* Wait here for CONNECT status before we cancel connection */
-                if (LWGSM_CHARISNUM(rcv->data[0]) && rcv->data[1] == ',' && rcv->data[2] == ' ') {
-                    uint8_t num = LWGSM_CHARTONUM(rcv->data[0]);
-                    if (num < LWGSM_CFG_MAX_CONNS) {
-                        uint8_t id;
-                        lwgsm_conn_t* conn = &lwgsm.m.conns[num]; /* Get connection handle */
-
-                        if (!strncmp(&rcv->data[3], "CONNECT OK" CRLF, 10 + CRLF_LEN)) {
-                            id = conn->val_id;
-                            LWGSM_MEMSET(conn, 0x00, sizeof(*conn)); /* Reset connection parameters */
-                            conn->num = num;
-                            conn->status.f.active = 1;
-                            conn->val_id = ++id; /* Set new validation ID */
-
-                            /* Set connection parameters */
-                            conn->status.f.client = 1;
-                            conn->evt_func = lwgsm.msg->msg.conn_start.evt_func;
-                            conn->arg = lwgsm.msg->msg.conn_start.arg;
-
-                            /* Set status */
-                            lwgsm.msg->msg.conn_start.conn_res = LWGSM_CONN_CONNECT_OK;
-                            is_ok = 1;
-                        } else if (!strncmp(&rcv->data[3], "CONNECT FAIL" CRLF, 12 + CRLF_LEN)) {
-                            lwgsm.msg->msg.conn_start.conn_res = LWGSM_CONN_CONNECT_ERROR;
-                            is_error = 1;
-                        } else if (!strncmp(&rcv->data[3], "ALREADY CONNECT" CRLF, 15 + CRLF_LEN)) {
-                            lwgsm.msg->msg.conn_start.conn_res = LWGSM_CONN_CONNECT_ALREADY;
-                            is_error = 1;
-                        }
-                    }
+                /*
+                 * Command finishes on first OK,
+                 * connection result is processed as URC in \ref lwgsmi_conn_connect_result
+                 */
+                if (LWGSM_CHARISNUM(rcv->data[0]) && rcv->data[1] == ',' && rcv->data[2] == ' '
+                    && !strncmp(&rcv->data[3], "ALREADY CONNECT" CRLF, 15 + CRLF_LEN)) {
+                    lwgsm.msg->msg.conn_start.conn_res = LWGSM_CONN_CONNECT_ALREADY;
+                    is_error = 1;
                 }
             } else if (CMD_IS_CUR(LWGSM_CMD_CIPSEND)) {
                 if (is_ok) {
@@ -1019,6 +1173,20 @@ lwgsmi_parse_received(lwgsm_recv_t *rcv) {
                     is_ok = 1;
                 }
 #endif /* LWGSM_CFG_USSD */
+#if LWGSM_CFG_DNS
+            } else if (CMD_IS_CUR(LWGSM_CMD_CDNSGIP)) {
+                /* OK is returned before +CDNSGIP with actual result */
+                if (is_ok) {
+                    is_ok = 0;
+                }
+                if (!strncmp(rcv->data, "+CDNSGIP", 8)) {
+                    if (lwgsmi_parse_cdnsgip(rcv->data)) {
+                        is_ok = 1;
+                    } else {
+                        is_error = 1;
+                    }
+                }
+#endif /* LWGSM_CFG_DNS */
         }
     }
 
@@ -1059,30 +1227,23 @@ lwgsmi_parse_received(lwgsm_recv_t *rcv) {
  */
 lwgsmr_t
 lwgsmi_process_buffer(void) {
-    void* data;
+    const void* data;
     size_t len;
 
     do {
         /*
-         * Get length of linear memory in buffer
+         * Get address and length of linear memory in buffer
          * we can process directly as memory
          */
-        len = lwgsm_buff_get_linear_block_read_length(&lwgsm.buff);
-        if (len > 0) {
-            /*
-             * Get memory address of first element
-             * in linear block of data to process
-             */
-            data = lwgsm_buff_get_linear_block_read_address(&lwgsm.buff);
-
+        if ((data = lwgsm_buff_read_peek(&lwgsm.buff, 0, &len)) != NULL) {
             /* Process actual received data */
             lwgsmi_process(data, len);
 
             /*
-             * Once data is processed, simply skip
+             * Once data is processed, simply release
              * the buffer memory and start over
              */
-            lwgsm_buff_skip(&lwgsm.buff, len);
+            lwgsm_buff_read_advance(&lwgsm.buff, len);
         }
     } while (len);
     return lwgsmOK;
@@ -1120,6 +1281,8 @@ lwgsmi_process(const void *data, size_t data_len) {
 
                 if (lwgsm.m.ipd.buff != NULL) {                           /* Do we have active buffer? */
                     lwgsm.m.ipd.buff->payload[lwgsm.m.ipd.buff_ptr] = ch; /* Save data character */
+                } else {
+                    CONN_STATS_ADD(lwgsm.m.ipd.conn, recv_dropped, 1);
                 }
                 ++lwgsm.m.ipd.buff_ptr;
                 --lwgsm.m.ipd.rem_len;
@@ -1137,6 +1300,7 @@ lwgsmi_process(const void *data, size_t data_len) {
                     } else { /* Simply skip the data in buffer */
                         LWGSM_DEBUGF(LWGSM_CFG_DBG_IPD | LWGSM_DBG_TYPE_TRACE, "[LWGSM IPD] Bytes skipped: %d\r\n",
                                      (int)len);
+                        CONN_STATS_ADD(lwgsm.m.ipd.conn, recv_dropped, len);
                     }
                     d_len -= len;                /* Decrease effective length */
                     d += len;                    /* Skip remaining length */
@@ -1152,6 +1316,7 @@ lwgsmi_process(const void *data, size_t data_len) {
                     /* Call user callback function with received data */
                     if (lwgsm.m.ipd.buff != NULL) {                                  /* Do we have valid buffer? */
                         lwgsm.m.ipd.conn->total_recved += lwgsm.m.ipd.buff->tot_len; /* Increase number of bytes received */
+                        CONN_STATS_ADD(lwgsm.m.ipd.conn, recv_pbufs, 1);
 
                         /*
                          * Send data buffer to upper layer
@@ -1184,7 +1349,7 @@ lwgsmi_process(const void *data, size_t data_len) {
 
                             LWGSM_DEBUGF(LWGSM_CFG_DBG_IPD | LWGSM_DBG_TYPE_TRACE,
                                          "[LWGSM IPD] Allocating new packet buffer of size: %d bytes\r\n", (int)new_len);
-                            lwgsm.m.ipd.buff = lwgsm_pbuf_new(new_len); /* Allocate new packet buffer */
+                            lwgsm.m.ipd.buff = lwgsmi_pbuf_new_ipd(new_len); /* Allocate new packet buffer */
 
                             LWGSM_DEBUGW(LWGSM_CFG_DBG_IPD | LWGSM_DBG_TYPE_TRACE | LWGSM_DBG_LVL_WARNING,
                                          lwgsm.m.ipd.buff == NULL, "[LWGSM IPD] Buffer allocation failed for %d bytes\r\n",
@@ -1303,7 +1468,7 @@ lwgsmi_process(const void *data, size_t data_len) {
                          *  - Connection is not in closing mode
                          */
                         if (lwgsm.m.ipd.conn->status.f.active && !lwgsm.m.ipd.conn->status.f.in_closing) {
-                            lwgsm.m.ipd.buff = lwgsm_pbuf_new(len); /* Allocate new packet buffer */
+                            lwgsm.m.ipd.buff = lwgsmi_pbuf_new_ipd(len); /* Allocate new packet buffer */
                             LWGSM_DEBUGW(LWGSM_CFG_DBG_IPD | LWGSM_DBG_TYPE_TRACE | LWGSM_DBG_LVL_WARNING,
                                          lwgsm.m.ipd.buff == NULL,
                                          "[LWGSM IPD] Buffer allocation failed for %d byte(s)\r\n", (int)len);
@@ -1331,10 +1496,19 @@ lwgsmi_process(const void *data, size_t data_len) {
                                 RECV_RESET(); /* Reset received object */
 
                                 /* Now actually send the data prepared before */
-                                AT_PORT_SEND_WITH_FLUSH(&lwgsm.msg->msg.conn_send.data[lwgsm.msg->msg.conn_send.ptr],
-                                                        lwgsm.msg->msg.conn_send.sent);
+                                if (lwgsm.msg->msg.conn_send.pbuf != NULL) {
+                                    lwgsmi_tcpip_send_pbuf_data();
+                                } else {
+                                    AT_PORT_SEND_WITH_FLUSH(
+                                        &lwgsm.msg->msg.conn_send.data[lwgsm.msg->msg.conn_send.ptr],
+                                        lwgsm.msg->msg.conn_send.sent);
+                                }
                                 lwgsm.msg->msg.conn_send.wait_send_ok_err =
                                     1; /* Now we are waiting for "SEND OK" or "SEND ERROR" */
+#if LWGSM_CFG_CONN_STATS
+                                lwgsm.msg->msg.conn_send.prompt_time = lwgsm_sys_now();
+                                CONN_STATS_ADD(lwgsm.msg->msg.conn_send.conn, segments_sent, 1);
+#endif /* LWGSM_CFG_CONN_STATS */
 #endif                             /* LWGSM_CFG_CONN */
 #if LWGSM_CFG_SMS
                             } else if (CMD_IS_CUR(LWGSM_CMD_CMGS)) { /* Send SMS? */
@@ -1804,27 +1978,45 @@ lwgsmi_process_sub_cmd(lwgsm_msg_t *msg, uint8_t *is_ok, uint16_t *is_error) {
                 if (*is_ok) {
                     SET_NEW_CMD(LWGSM_CMD_CIPSSL); /* Set SSL */
                 }
-            } else if (msg->i == 1 && CMD_IS_CUR(LWGSM_CMD_CIPSSL)) {
-                SET_NEW_CMD(LWGSM_CMD_CIPSTART); /* Now actually start connection */
-            } else if (msg->i == 2 && CMD_IS_CUR(LWGSM_CMD_CIPSTART)) {
-                SET_NEW_CMD(LWGSM_CMD_CIPSTATUS); /* Go to status mode */
+            } else if (CMD_IS_CUR(LWGSM_CMD_CIPSSL)) {
+#if LWGSM_CFG_DNS
+                if (msg->msg.conn_start.resolve) {
+                    SET_NEW_CMD(LWGSM_CMD_CDNSGIP); /* Resolve host name and cache it */
+                } else
+#endif /* LWGSM_CFG_DNS */
+                {
+                    SET_NEW_CMD(LWGSM_CMD_CIPSTART); /* Now actually start connection */
+                }
+#if LWGSM_CFG_DNS
+            } else if (CMD_IS_CUR(LWGSM_CMD_CDNSGIP)) {
+                SET_NEW_CMD(LWGSM_CMD_CIPSTART); /* On failure, device resolves host name itself */
+#endif /* LWGSM_CFG_DNS */
+            } else if (CMD_IS_CUR(LWGSM_CMD_CIPSTART)) {
+                lwgsm_conn_t* conn = &lwgsm.m.conns[msg->msg.conn_start.num];
+
                 if (*is_error) {
-                    msg->msg.conn_start.conn_res = LWGSM_CONN_CONNECT_ERROR;
+                    if (conn->start_msg == msg) {
+                        conn->status.f.connecting = 0;
+                        conn->start_msg = NULL;
+                        lwgsmi_conn_remove_timeouts(conn);
+                    }
+                    if (msg->msg.conn_start.conn_res != LWGSM_CONN_CONNECT_ALREADY) {
+                        msg->msg.conn_start.conn_res = LWGSM_CONN_CONNECT_ERROR;
+                    }
+                    SET_NEW_CMD(LWGSM_CMD_CIPSTATUS); /* Go to status mode */
+                } else if (conn->start_msg == msg) {
+                    /* Release command pipeline, message is finished on connection result */
+                    msg->msg.conn_start.pending = 1;
+                    conn->connect_time = lwgsm_sys_now();
+                    lwgsmi_conn_start_connect_timeout(conn);
+                } else if (msg->msg.conn_start.conn_res != LWGSM_CONN_CONNECT_OK) {
+                    /* Connection failed before OK has been received */
+                    *is_ok = 0;
+                    *is_error = 1;
                 }
-            } else if (msg->i == 3 && CMD_IS_CUR(LWGSM_CMD_CIPSTATUS)) {
-                /* After second CIP status, define what to do next */
+            } else if (msg->i > 0 && CMD_IS_CUR(LWGSM_CMD_CIPSTATUS)) {
+                /* After second CIP status, report start error */
                 switch (msg->msg.conn_start.conn_res) {
-                    case LWGSM_CONN_CONNECT_OK: {                                     /* Successfully connected */
-                        lwgsm_conn_t* conn = &lwgsm.m.conns[msg->msg.conn_start.num]; /* Get connection number */
-
-                        lwgsm.evt.type = LWGSM_EVT_CONN_ACTIVE; /* Connection just active */
-                        lwgsm.evt.evt.conn_active_close.client = 1;
-                        lwgsm.evt.evt.conn_active_close.conn = conn;
-                        lwgsm.evt.evt.conn_active_close.forced = 1;
-                        lwgsmi_send_conn_cb(conn, NULL);
-                        lwgsmi_conn_start_timeout(conn); /* Start connection timeout timer */
-                        break;
-                    }
                     case LWGSM_CONN_CONNECT_ERROR: { /* Connection error */
                         lwgsmi_send_conn_error_cb(msg, lwgsmERRCONNFAIL);
                         *is_error = 1; /* Manually set error */
@@ -2149,7 +2341,7 @@ lwgsmi_initiate_cmd(lwgsm_msg_t *msg) {
 
                 msg->msg.conn_start.num = 0;                             /* Start with max value = invalidated */
                 for (int16_t i = LWGSM_CFG_MAX_CONNS - 1; i >= 0; --i) { /* Find available connection */
-                    if (!lwgsm.m.conns[i].status.f.active) {
+                    if (!lwgsm.m.conns[i].status.f.active && !lwgsm.m.conns[i].status.f.connecting) {
                         c = &lwgsm.m.conns[i];
                         c->num = LWGSM_U8(i);
                         msg->msg.conn_start.num = LWGSM_U8(i); /* Set connection number for message structure */
@@ -2164,6 +2356,8 @@ lwgsmi_initiate_cmd(lwgsm_msg_t *msg) {
                 if (msg->msg.conn_start.conn != NULL) { /* Is user interested about connection info? */
                     *msg->msg.conn_start.conn = c;      /* Save connection for user */
                 }
+                c->status.f.connecting = 1;
+                c->start_msg = msg;
 
                 AT_PORT_SEND_BEGIN_AT();
                 AT_PORT_SEND_CONST_STR("+CIPSTART=");
@@ -2173,7 +2367,14 @@ lwgsmi_initiate_cmd(lwgsm_msg_t *msg) {
                 } else {
                     lwgsmi_send_string("TCP", 0, 1, 1);
                 }
-                lwgsmi_send_string(msg->msg.conn_start.host, 0, 1, 1);
+#if LWGSM_CFG_DNS
+                if (msg->msg.conn_start.use_ip) {
+                    lwgsmi_send_ip_mac(&msg->msg.conn_start.ip, 1, 1, 1); /* Use IP from DNS cache */
+                } else
+#endif /* LWGSM_CFG_DNS */
+                {
+                    lwgsmi_send_string(msg->msg.conn_start.host, 0, 1, 1);
+                }
                 lwgsmi_send_port(msg->msg.conn_start.port, 0, 1);
                 AT_PORT_SEND_END_AT();
                 break;
@@ -2195,6 +2396,12 @@ lwgsmi_initiate_cmd(lwgsm_msg_t *msg) {
             case LWGSM_CMD_CIPSEND: {                    /* Send data to connection */
                 return lwgsmi_tcpip_process_send_data(); /* Process send data */
             }
+            case LWGSM_CMD_CIPSEND_GET: { /* Get max send length for connections */
+                AT_PORT_SEND_BEGIN_AT();
+                AT_PORT_SEND_CONST_STR("+CIPSEND?");
+                AT_PORT_SEND_END_AT();
+                break;
+            }
             case LWGSM_CMD_CIPSTATUS: { /* Get status of device and all connections */
                 AT_PORT_SEND_BEGIN_AT();
                 AT_PORT_SEND_CONST_STR("+CIPSTATUS");
@@ -2615,6 +2822,22 @@ lwgsmi_initiate_cmd(lwgsm_msg_t *msg) {
             break;
         }
 #endif /* LWGSM_CFG_NETWORK || LWGSM_CFG_NETWORK_CENTERION  */
+#if LWGSM_CFG_DNS
+            case LWGSM_CMD_CDNSGIP: {
+                const char* host = msg->msg.dns_getbyhostname.host;
+
+#if LWGSM_CFG_CONN
+                if (msg->cmd_def == LWGSM_CMD_CIPSTART) { /* Resolve before connection start */
+                    host = msg->msg.conn_start.host;
+                }
+#endif /* LWGSM_CFG_CONN */
+                AT_PORT_SEND_BEGIN_AT();
+                AT_PORT_SEND_CONST_STR("+CDNSGIP=");
+                lwgsmi_send_string(host, 0, 1, 0);
+                AT_PORT_SEND_END_AT();
+                break;
+            }
+#endif /* LWGSM_CFG_DNS */
 #if LWGSM_CFG_USSD
             case LWGSM_CMD_CUSD_GET: {
                 AT_PORT_SEND_BEGIN_AT();
@@ -2674,6 +2897,14 @@ lwgsmi_send_msg_to_producer_mbox(lwgsm_msg_t *msg, lwgsmr_t (*process_fn)(lwgsm_
     }
     msg->block_time = max_block_time; /* Set blocking status if necessary */
     msg->fn = process_fn;             /* Save processing function to be called as callback */
+#if LWGSM_CFG_CONN_SCHED
+    if (msg->cmd_def == LWGSM_CMD_CIPSEND) {
+        if (!lwgsmi_conn_sched_put(msg, 0)) { /* Send data in turn with other connections */
+            LWGSM_MSG_VAR_FREE(msg);          /* Queue is full, release message */
+            return lwgsmERRMEM;
+        }
+    } else
+#endif /* LWGSM_CFG_CONN_SCHED */
     if (msg->is_blocking) {
         lwgsm_sys_mbox_put(&lwgsm.mbox_producer, msg); /* Write message to producer queue and wait forever */
     } else {
@@ -2730,6 +2961,11 @@ lwgsmi_process_events_for_timeout_or_error(lwgsm_msg_t *msg, lwgsmr_t err) {
 #if LWGSM_CFG_CONN
             case LWGSM_CMD_CIPSTART: {
                 /* Start connection error */
+                if (msg->msg.conn_start.num < LWGSM_CFG_MAX_CONNS
+                    && lwgsm.m.conns[msg->msg.conn_start.num].start_msg == msg) {
+                    lwgsm.m.conns[msg->msg.conn_start.num].status.f.connecting = 0;
+                    lwgsm.m.conns[msg->msg.conn_start.num].start_msg = NULL;
+                }
                 lwgsmi_send_conn_error_cb(msg, err);
                 break;
             }
@@ -32,11 +32,362 @@
  * Version:         v0.1.1
  */
 #include <limits.h>
+#include <stddef.h>
 #include "lwgsm/lwgsm_mem.h"
 #include "lwgsm/lwgsm_private.h"
 
 #if !LWGSM_CFG_MEM_CUSTOM || __DOXYGEN__
 
+/**
+ * \brief           Memory alignment bits and absolute number
+ */
+#define MEM_ALIGN_BITS LWGSM_SZ(LWGSM_CFG_MEM_ALIGNMENT - 1)
+#define MEM_ALIGN_NUM  LWGSM_SZ(LWGSM_CFG_MEM_ALIGNMENT)
+#define MEM_ALIGN(x)   LWGSM_MEM_ALIGN(x)
+
+#define MEM_ALLOC_BIT  ((size_t)((size_t)1 << (sizeof(size_t) * CHAR_BIT - 1)))
+
+static size_t mem_available_bytes;     /*!< Number of available bytes for allocations */
+static size_t mem_min_available_bytes; /*!< Minimum number of available bytes since memory was assigned */
+static size_t mem_failed_allocs;       /*!< Number of failed allocations */
+
+#if LWGSM_CFG_MEM_TLSF
+
+#if !__DOXYGEN__
+typedef struct tlsf_block {
+    struct tlsf_block* prev_phys; /*!< Previous physical block in region, `NULL` for first block */
+    size_t size;                  /*!< Size of block including header, \ref MEM_ALLOC_BIT is set when allocated */
+    struct tlsf_block* next_free; /*!< Next block in the same free list, valid for free block only */
+    struct tlsf_block* prev_free; /*!< Previous block in the same free list, valid for free block only */
+} tlsf_block_t;
+#endif /* !__DOXYGEN__ */
+
+/**
+ * \brief           Segregated free lists configuration
+ *
+ * Every first level list covers power-of-two range of block sizes,
+ * split linearly to \ref TLSF_SL_COUNT second level lists.
+ * Blocks smaller than \ref TLSF_SMALL_BLOCK are all in first level list `0`.
+ */
+#define TLSF_SL_LOG2             4
+#define TLSF_SL_COUNT            (1U << TLSF_SL_LOG2)
+#define TLSF_FL_SHIFT            (TLSF_SL_LOG2 + 3)
+#define TLSF_FL_INDEX_MAX        30
+#define TLSF_FL_COUNT            (TLSF_FL_INDEX_MAX - TLSF_FL_SHIFT + 1)
+#define TLSF_SMALL_BLOCK         (LWGSM_SZ(1) << TLSF_FL_SHIFT)
+
+#define TLSF_HDR_SIZE            MEM_ALIGN(offsetof(tlsf_block_t, next_free))
+#define TLSF_BLOCK_MIN           MEM_ALIGN(sizeof(tlsf_block_t))
+#define TLSF_BLOCK_MAX           ((LWGSM_SZ(1) << TLSF_FL_INDEX_MAX) - MEM_ALIGN_NUM)
+#define TLSF_BLOCK_SIZE(b)       ((b)->size & ~MEM_ALLOC_BIT)
+#define TLSF_BLOCK_NEXT(b)       ((tlsf_block_t*)((uint8_t*)(b) + TLSF_BLOCK_SIZE(b)))
+
+#define MEM_BLOCK_FROM_PTR(ptr)  ((tlsf_block_t*)(((uint8_t*)(ptr)) - TLSF_HDR_SIZE))
+#define MEM_BLOCK_USER_SIZE(ptr) (TLSF_BLOCK_SIZE(MEM_BLOCK_FROM_PTR(ptr)) - TLSF_HDR_SIZE)
+
+static tlsf_block_t* tlsf_lists[TLSF_FL_COUNT][TLSF_SL_COUNT]; /*!< Heads of free lists */
+static uint32_t tlsf_fl_bitmap;                                /*!< Bitmap of non-empty first level lists */
+static uint32_t tlsf_sl_bitmap[TLSF_FL_COUNT];                 /*!< Bitmaps of non-empty second level lists */
+static uint8_t tlsf_initialized;                               /*!< Set to `1` when memory regions are assigned */
+
+/**
+ * \brief           Get index of most significant set bit
+ * \param[in]       x: Input value, must not be `0`
+ * \return          Bit index
+ */
+static uint32_t
+tlsf_fls(uint32_t x) {
+#if defined(__GNUC__)
+    return 31U - (uint32_t)__builtin_clz(x);
+#else  /* defined(__GNUC__) */
+    uint32_t r = 0;
+
+    if (x & 0xFFFF0000UL) {
+        x >>= 16;
+        r += 16;
+    }
+    if (x & 0xFF00UL) {
+        x >>= 8;
+        r += 8;
+    }
+    if (x & 0xF0UL) {
+        x >>= 4;
+        r += 4;
+    }
+    if (x & 0x0CUL) {
+        x >>= 2;
+        r += 2;
+    }
+    if (x & 0x02UL) {
+        r += 1;
+    }
+    return r;
+#endif /* !defined(__GNUC__) */
+}
+
+/**
+ * \brief           Get index of least significant set bit
+ * \param[in]       x: Input value, must not be `0`
+ * \return          Bit index
+ */
+static uint32_t
+tlsf_ffs(uint32_t x) {
+    return tlsf_fls(x & (~x + 1U));
+}
+
+/**
+ * \brief           Get first and second level list index for block size
+ * \param[in]       size: Block size in units of bytes
+ * \param[out]      fl: First level index
+ * \param[out]      sl: Second level index
+ */
+static void
+tlsf_mapping(size_t size, uint32_t* fl, uint32_t* sl) {
+    uint32_t f;
+
+    if (size < TLSF_SMALL_BLOCK) {
+        *fl = 0;
+        *sl = (uint32_t)(size / (TLSF_SMALL_BLOCK / TLSF_SL_COUNT));
+    } else {
+        f = tlsf_fls((uint32_t)size);
+        *sl = (uint32_t)(size >> (f - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+        *fl = f - TLSF_FL_SHIFT + 1;
+    }
+}
+
+/**
+ * \brief           Insert free block to its segregated list
+ * \param[in]       b: Free block to insert
+ */
+static void
+tlsf_insert(tlsf_block_t* b) {
+    uint32_t fl, sl;
+
+    tlsf_mapping(TLSF_BLOCK_SIZE(b), &fl, &sl);
+    b->prev_free = NULL;
+    b->next_free = tlsf_lists[fl][sl];
+    if (b->next_free != NULL) {
+        b->next_free->prev_free = b;
+    }
+    tlsf_lists[fl][sl] = b;
+    tlsf_fl_bitmap |= 1UL << fl;
+    tlsf_sl_bitmap[fl] |= 1UL << sl;
+}
+
+/**
+ * \brief           Remove free block from its segregated list
+ * \param[in]       b: Free block to remove
+ */
+static void
+tlsf_remove(tlsf_block_t* b) {
+    uint32_t fl, sl;
+
+    tlsf_mapping(TLSF_BLOCK_SIZE(b), &fl, &sl);
+    if (b->next_free != NULL) {
+        b->next_free->prev_free = b->prev_free;
+    }
+    if (b->prev_free != NULL) {
+        b->prev_free->next_free = b->next_free;
+    } else {
+        tlsf_lists[fl][sl] = b->next_free;
+        if (tlsf_lists[fl][sl] == NULL) { /* List is now empty */
+            tlsf_sl_bitmap[fl] &= ~(1UL << sl);
+            if (tlsf_sl_bitmap[fl] == 0) {
+                tlsf_fl_bitmap &= ~(1UL << fl);
+            }
+        }
+    }
+}
+
+/**
+ * \brief           Assign memory for HEAP allocations
+ * \param[in]       regions: Pointer to list of regions.
+ *                  Set regions in ascending order by address
+ * \param[in]       len: Number of regions to assign
+ */
+static uint8_t
+mem_assignmem(const lwgsm_mem_region_t* regions, size_t len) {
+    uint8_t* mem_start_addr;
+    size_t mem_size;
+    tlsf_block_t *first_block, *last_block;
+
+    if (tlsf_initialized) { /* Regions already defined */
+        return 0;
+    }
+
+    /* Check if region address are linear and rising */
+    mem_start_addr = (uint8_t*)0;
+    for (size_t i = 0; i < len; ++i) {
+        if (mem_start_addr >= (uint8_t*)regions[i].start_addr) { /* Check if previous greater than current */
+            return 0;                                            /* Return as invalid and failed */
+        }
+        mem_start_addr = (uint8_t*)regions[i].start_addr; /* Save as previous address */
+    }
+
+    for (; len > 0; --len, ++regions) {
+        /* Check minimum region size */
+        mem_size = regions->size;
+        if (mem_size < (MEM_ALIGN_NUM + TLSF_BLOCK_MIN + TLSF_HDR_SIZE)) {
+            continue;
+        }
+
+        /* Align start address and size of region */
+        mem_start_addr = (uint8_t*)regions->start_addr;
+        if (LWGSM_SZ(mem_start_addr) & MEM_ALIGN_BITS) {
+            mem_start_addr += MEM_ALIGN_NUM - (LWGSM_SZ(mem_start_addr) & MEM_ALIGN_BITS);
+            mem_size -= mem_start_addr - (uint8_t*)regions->start_addr;
+        }
+        mem_size &= ~MEM_ALIGN_BITS;
+
+        /* Largest block must fit to first level lists */
+        mem_size = LWGSM_MIN(mem_size, TLSF_BLOCK_MAX + TLSF_HDR_SIZE);
+
+        /* Whole region is one free block, followed by zero-size allocated block to stop coalescing */
+        first_block = (tlsf_block_t*)mem_start_addr;
+        first_block->prev_phys = NULL;
+        first_block->size = mem_size - TLSF_HDR_SIZE;
+        last_block = TLSF_BLOCK_NEXT(first_block);
+        last_block->prev_phys = first_block;
+        last_block->size = MEM_ALLOC_BIT;
+        tlsf_insert(first_block);
+
+        /* Set number of free bytes available to allocate in region */
+        mem_available_bytes += first_block->size;
+        tlsf_initialized = 1;
+    }
+
+    return 1; /* Regions set as expected */
+}
+
+/**
+ * \brief           Allocate memory of specific size
+ * \param[in]       size: Number of bytes to allocate
+ * \return          Memory address on success, `NULL` otherwise
+ */
+static void*
+mem_alloc(size_t size) {
+    tlsf_block_t *b, *n;
+    uint32_t fl, sl, map;
+    size_t search;
+
+    if (!tlsf_initialized || size == 0 || size > TLSF_BLOCK_MAX) {
+        return NULL;
+    }
+
+    /* Increase size for metadata, block larger than maximal one would map past the last first level list */
+    size = LWGSM_MAX(MEM_ALIGN(size) + TLSF_HDR_SIZE, TLSF_BLOCK_MIN);
+    if (size > TLSF_BLOCK_MAX || size > mem_available_bytes) { /* Check if we have enough memory available */
+        return NULL;
+    }
+
+    /* Round size up to next list start, so that any block in found list is large enough */
+    if (size < TLSF_SMALL_BLOCK) {
+        search = size + (TLSF_SMALL_BLOCK / TLSF_SL_COUNT) - 1;
+    } else {
+        search = size + (LWGSM_SZ(1) << (tlsf_fls((uint32_t)size) - TLSF_SL_LOG2)) - 1;
+    }
+    tlsf_mapping(search, &fl, &sl);
+
+    /* Find first non-empty list in the same first level, or in any larger one */
+    b = NULL;
+    if (fl < TLSF_FL_COUNT) {
+        map = tlsf_sl_bitmap[fl] & (0xFFFFFFFFUL << sl);
+        if (map == 0) {
+            map = tlsf_fl_bitmap & (0xFFFFFFFFUL << (fl + 1));
+            if (map != 0) {
+                fl = tlsf_ffs(map);
+                map = tlsf_sl_bitmap[fl];
+            }
+        }
+        if (map != 0) {
+            b = tlsf_lists[fl][tlsf_ffs(map)];
+        }
+    }
+    if (b == NULL) {
+        /* No larger list, list of requested size may still hold large enough block */
+        tlsf_mapping(size, &fl, &sl);
+        for (b = tlsf_lists[fl][sl]; b != NULL && b->size < size; b = b->next_free) {}
+        if (b == NULL) { /* Allocation failed, no free blocks of required size */
+            return NULL;
+        }
+    }
+    tlsf_remove(b);
+
+    /* Split remaining memory to new free block if large enough */
+    if ((b->size - size) >= TLSF_BLOCK_MIN) {
+        n = (tlsf_block_t*)((uint8_t*)b + size);
+        n->size = b->size - size;
+        n->prev_phys = b;
+        TLSF_BLOCK_NEXT(n)->prev_phys = n;
+        b->size = size;
+        tlsf_insert(n);
+    }
+    mem_available_bytes -= b->size; /* Decrease available memory */
+    b->size |= MEM_ALLOC_BIT;       /* Set allocated bit = memory is allocated */
+    return (void*)((uint8_t*)b + TLSF_HDR_SIZE);
+}
+
+/**
+ * \brief           Free memory
+ * \param[in]       ptr: Pointer to memory previously returned using \ref lwgsm_mem_malloc,
+ *                      \ref lwgsm_mem_calloc or \ref lwgsm_mem_realloc functions
+ */
+static void
+mem_free(void* ptr) {
+    tlsf_block_t *b, *n;
+
+    if (ptr == NULL) { /* To be in compliance with C free function */
+        return;
+    }
+
+    b = MEM_BLOCK_FROM_PTR(ptr); /* Get block data pointer from input pointer */
+    if (!(b->size & MEM_ALLOC_BIT)) {
+        return; /* Block is not allocated */
+    }
+    b->size &= ~MEM_ALLOC_BIT;      /* Clear allocated bit */
+    mem_available_bytes += b->size; /* Increase available bytes back */
+
+    /* Merge with previous physical block if free */
+    if (b->prev_phys != NULL && !(b->prev_phys->size & MEM_ALLOC_BIT)) {
+        tlsf_remove(b->prev_phys);
+        b->prev_phys->size += b->size;
+        b = b->prev_phys;
+        TLSF_BLOCK_NEXT(b)->prev_phys = b;
+    }
+
+    /* Merge with next physical block if free. Last block in region is always allocated */
+    n = TLSF_BLOCK_NEXT(b);
+    if (!(n->size & MEM_ALLOC_BIT)) {
+        tlsf_remove(n);
+        b->size += n->size;
+        TLSF_BLOCK_NEXT(b)->prev_phys = b;
+    }
+    tlsf_insert(b);
+}
+
+/**
+ * \brief           Get largest free block and number of free blocks
+ * \param[out]      largest: Output variable to save usable size of largest free block
+ * \param[out]      count: Output variable to save number of free blocks
+ */
+static void
+mem_get_free_blocks(size_t* largest, size_t* count) {
+    tlsf_block_t* b;
+
+    *largest = 0;
+    *count = 0;
+    for (size_t fl = 0; fl < TLSF_FL_COUNT; ++fl) {
+        for (size_t sl = 0; sl < TLSF_SL_COUNT; ++sl) {
+            for (b = tlsf_lists[fl][sl]; b != NULL; b = b->next_free) {
+                *largest = LWGSM_MAX(*largest, b->size - TLSF_HDR_SIZE);
+                ++(*count);
+            }
+        }
+    }
+}
+
+#else /* LWGSM_CFG_MEM_TLSF */
+
 #if !__DOXYGEN__
 typedef struct mem_block {
     struct mem_block* next; /*!< Pointer to next free block */
@@ -44,22 +395,13 @@ typedef struct mem_block {
 } mem_block_t;
 #endif /* !__DOXYGEN__ */
 
-/**
- * \brief           Memory alignment bits and absolute number
- */
-#define MEM_ALIGN_BITS           LWGSM_SZ(LWGSM_CFG_MEM_ALIGNMENT - 1)
-#define MEM_ALIGN_NUM            LWGSM_SZ(LWGSM_CFG_MEM_ALIGNMENT)
-#define MEM_ALIGN(x)             LWGSM_MEM_ALIGN(x)
-
 #define MEMBLOCK_METASIZE        MEM_ALIGN(sizeof(mem_block_t))
 
-#define MEM_ALLOC_BIT            ((size_t)((size_t)1 << (sizeof(size_t) * CHAR_BIT - 1)))
 #define MEM_BLOCK_FROM_PTR(ptr)  ((mem_block_t*)(((uint8_t*)(ptr)) - MEMBLOCK_METASIZE))
 #define MEM_BLOCK_USER_SIZE(ptr) ((MEM_BLOCK_FROM_PTR(ptr)->size & ~MEM_ALLOC_BIT) - MEMBLOCK_METASIZE)
 
-static mem_block_t start_block;    /*!< First block data for allocations */
-static mem_block_t* end_block;     /*!< Pointer to last block in linked list */
-static size_t mem_available_bytes; /*!< Number of available bytes for allocations */
+static mem_block_t start_block; /*!< First block data for allocations */
+static mem_block_t* end_block;  /*!< Pointer to last block in linked list */
 
 /**
  * \brief           Insert a new block to linked list of free blocks
@@ -270,10 +612,9 @@ mem_alloc(size_t size) {
              */
             mem_insertfreeblock(next); /* Insert free memory block to list of free memory blocks (linked list chain) */
         }
-        curr->size |= MEM_ALLOC_BIT; /* Set allocated bit = memory is allocated */
-        curr->next = NULL;           /* Clear next free block pointer as there is no one */
-
-        mem_available_bytes -= size; /* Decrease available memory */
+        mem_available_bytes -= curr->size; /* Decrease available memory by full block size, split or not */
+        curr->size |= MEM_ALLOC_BIT;       /* Set allocated bit = memory is allocated */
+        curr->next = NULL;                 /* Clear next free block pointer as there is no one */
     } else {
         /* Allocation failed, no free blocks of required size */
     }
@@ -310,6 +651,43 @@ mem_free(void* ptr) {
     }
 }
 
+/**
+ * \brief           Get largest free block and number of free blocks
+ * \param[out]      largest: Output variable to save usable size of largest free block
+ * \param[out]      count: Output variable to save number of free blocks
+ */
+static void
+mem_get_free_blocks(size_t* largest, size_t* count) {
+    mem_block_t* b;
+
+    *largest = 0;
+    *count = 0;
+    if (end_block == NULL) {
+        return;
+    }
+    for (b = start_block.next; b != NULL; b = b->next) {
+        if (b->size > 0) { /* Skip end blocks of regions */
+            *largest = LWGSM_MAX(*largest, b->size - MEMBLOCK_METASIZE);
+            ++(*count);
+        }
+    }
+}
+
+#endif /* !LWGSM_CFG_MEM_TLSF */
+
+/**
+ * \brief           Update allocation statistics after allocation attempt
+ * \param[in]       ptr: Allocated memory or `NULL` on failure
+ */
+static void
+mem_update_stats(void* ptr) {
+    if (ptr == NULL) {
+        ++mem_failed_allocs;
+    } else if (mem_available_bytes < mem_min_available_bytes) {
+        mem_min_available_bytes = mem_available_bytes;
+    }
+}
+
 /**
  * \brief           Allocate memory of specific size
  * \param[in]       num: Number of elements to allocate
@@ -324,6 +702,7 @@ mem_calloc(size_t num, size_t size) {
     if ((ptr = mem_alloc(tot_len)) != NULL) { /* Try to allocate memory */
         LWGSM_MEMSET(ptr, 0x00, tot_len);     /* Reset entire memory */
     }
+    mem_update_stats(ptr);
     return ptr;
 }
 
@@ -341,11 +720,14 @@ mem_realloc(void* ptr, size_t size) {
     size_t old_size;
 
     if (ptr == NULL) {          /* If pointer is not valid */
-        return mem_alloc(size); /* Only allocate memory */
+        new_ptr = mem_alloc(size); /* Only allocate memory */
+        mem_update_stats(new_ptr);
+        return new_ptr;
     }
 
     old_size = MEM_BLOCK_USER_SIZE(ptr); /* Get size of old pointer */
     new_ptr = mem_alloc(size);           /* Try to allocate new memory block */
+    mem_update_stats(new_ptr);
     if (new_ptr != NULL) {
         LWGSM_MEMCPY(new_ptr, ptr, LWGSM_MIN(size, old_size)); /* Copy old data to new array */
         mem_free(ptr);                                         /* Free old pointer */
@@ -443,11 +825,298 @@ uint8_t
 lwgsm_mem_assignmemory(const lwgsm_mem_region_t* regions, size_t len) {
     uint8_t ret;
     ret = mem_assignmem(regions, len); /* Assign memory */
+    if (ret) {
+        mem_min_available_bytes = mem_available_bytes;
+    }
     return ret;
 }
 
+/**
+ * \brief           Get dynamic memory statistics
+ * \param[out]      stats: Pointer to output statistics structure
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ * \note            Function is not available when \ref LWGSM_CFG_MEM_CUSTOM is `1`
+ */
+lwgsmr_t
+lwgsm_mem_get_stats(lwgsm_mem_stats_t* stats) {
+    LWGSM_ASSERT(stats != NULL);
+
+    lwgsm_core_lock();
+    stats->free_bytes = mem_available_bytes;
+    stats->min_ever_free_bytes = mem_min_available_bytes;
+    stats->failed_allocs = mem_failed_allocs;
+    mem_get_free_blocks(&stats->largest_free_block, &stats->free_blocks);
+    lwgsm_core_unlock();
+    return lwgsmOK;
+}
+
 #endif /* !LWGSM_CFG_MEM_CUSTOM || __DOXYGEN__ */
 
+#if LWGSM_CFG_MEM_BUDGET || __DOXYGEN__
+
+#if !__DOXYGEN__
+typedef struct {
+    lwgsm_mem_tag_t tag; /*!< Allocation tag */
+    size_t size;         /*!< Accounted size, including header */
+} mem_tag_hdr_t;
+#endif /* !__DOXYGEN__ */
+
+#define MEM_TAG_HDR_SIZE LWGSM_MEM_ALIGN(sizeof(mem_tag_hdr_t))
+
+/**
+ * \brief           Budgets and accounting per allocation tag
+ */
+static lwgsm_mem_budget_stats_t mem_budgets[LWGSM_MEM_TAG_END] = {
+    [LWGSM_MEM_TAG_IPD] = {.limit = LWGSM_CFG_MEM_BUDGET_IPD},
+    [LWGSM_MEM_TAG_MSG] = {.limit = LWGSM_CFG_MEM_BUDGET_MSG},
+    [LWGSM_MEM_TAG_TIMEOUT] = {.limit = LWGSM_CFG_MEM_BUDGET_TIMEOUT},
+    [LWGSM_MEM_TAG_CONN] = {.limit = LWGSM_CFG_MEM_BUDGET_CONN},
+    [LWGSM_MEM_TAG_MQTT] = {.limit = LWGSM_CFG_MEM_BUDGET_MQTT},
+    [LWGSM_MEM_TAG_NETCONN] = {.limit = LWGSM_CFG_MEM_BUDGET_NETCONN},
+};
+
+/**
+ * \brief           Allocate memory accounted to subsystem budget
+ * \note            Memory must be freed with \ref lwgsm_mem_free_tag or \ref lwgsm_mem_free_tag_s
+ * \param[in]       tag: Subsystem allocation tag
+ * \param[in]       size: Number of bytes to allocate
+ * \return          Memory address on success, `NULL` when budget is exceeded or memory is not available
+ */
+void*
+lwgsm_mem_malloc_tag(lwgsm_mem_tag_t tag, size_t size) {
+    lwgsm_mem_budget_stats_t* b;
+    mem_tag_hdr_t* hdr = NULL;
+    size_t tot_len;
+
+    if (tag >= LWGSM_MEM_TAG_END || size == 0) {
+        return NULL;
+    }
+    b = &mem_budgets[tag];
+    tot_len = size + MEM_TAG_HDR_SIZE;
+
+    lwgsm_core_lock();
+    if (b->limit == 0 || (b->used + tot_len) <= b->limit) {
+        hdr = lwgsm_mem_malloc(tot_len);
+    }
+    if (hdr != NULL) {
+        hdr->tag = tag;
+        hdr->size = tot_len;
+        b->used += tot_len;
+        b->max_used = LWGSM_MAX(b->max_used, b->used);
+    } else {
+        ++b->failed;
+    }
+    lwgsm_core_unlock();
+    LWGSM_DEBUGW(LWGSM_CFG_DBG_MEM | LWGSM_DBG_TYPE_TRACE, hdr == NULL,
+                 "[LWGSM MEM] Tagged allocation failed: tag %d, %d bytes, used %d/%d bytes\r\n", (int)tag, (int)size,
+                 (int)b->used, (int)b->limit);
+    return hdr != NULL ? (void*)((uint8_t*)hdr + MEM_TAG_HDR_SIZE) : NULL;
+}
+
+/**
+ * \brief           Allocate memory accounted to subsystem budget and set it to zero
+ * \note            Memory must be freed with \ref lwgsm_mem_free_tag or \ref lwgsm_mem_free_tag_s
+ * \param[in]       tag: Subsystem allocation tag
+ * \param[in]       num: Number of elements to allocate
+ * \param[in]       size: Size of each element
+ * \return          Memory address on success, `NULL` when budget is exceeded or memory is not available
+ */
+void*
+lwgsm_mem_calloc_tag(lwgsm_mem_tag_t tag, size_t num, size_t size) {
+    void* ptr;
+
+    if ((ptr = lwgsm_mem_malloc_tag(tag, num * size)) != NULL) {
+        LWGSM_MEMSET(ptr, 0x00, num * size);
+    }
+    return ptr;
+}
+
+/**
+ * \brief           Free memory allocated with tagged allocation functions
+ * \param[in]       ptr: Pointer to memory returned by \ref lwgsm_mem_malloc_tag or \ref lwgsm_mem_calloc_tag
+ */
+void
+lwgsm_mem_free_tag(void* ptr) {
+    mem_tag_hdr_t* hdr;
+
+    if (ptr == NULL) {
+        return;
+    }
+    hdr = (void*)((uint8_t*)ptr - MEM_TAG_HDR_SIZE);
+    lwgsm_core_lock();
+    mem_budgets[hdr->tag].used -= hdr->size;
+    lwgsm_core_unlock();
+    lwgsm_mem_free(hdr);
+}
+
+/**
+ * \brief           Free tagged memory in safe way by invalidating pointer after freeing
+ * \param[in]       ptr: Pointer to pointer to allocated memory to free
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwgsm_mem_free_tag_s(void** ptr) {
+    if (ptr != NULL && *ptr != NULL) {
+        lwgsm_mem_free_tag(*ptr);
+        *ptr = NULL;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * \brief           Set memory budget for subsystem
+ * \note            Lowering budget below currently used memory does not free anything,
+ *                  new allocations are refused until usage drops below limit
+ * \param[in]       tag: Subsystem allocation tag
+ * \param[in]       limit: Budget in units of bytes. Set to `0` for unlimited budget
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_mem_set_budget(lwgsm_mem_tag_t tag, size_t limit) {
+    LWGSM_ASSERT(tag < LWGSM_MEM_TAG_END);
+
+    lwgsm_core_lock();
+    mem_budgets[tag].limit = limit;
+    lwgsm_core_unlock();
+    return lwgsmOK;
+}
+
+/**
+ * \brief           Get memory budget statistics for subsystem
+ * \param[in]       tag: Subsystem allocation tag
+ * \param[out]      stats: Pointer to output statistics structure
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_mem_get_budget_stats(lwgsm_mem_tag_t tag, lwgsm_mem_budget_stats_t* stats) {
+    LWGSM_ASSERT(tag < LWGSM_MEM_TAG_END);
+    LWGSM_ASSERT(stats != NULL);
+
+    lwgsm_core_lock();
+    *stats = mem_budgets[tag];
+    lwgsm_core_unlock();
+    return lwgsmOK;
+}
+
+#endif /* LWGSM_CFG_MEM_BUDGET || __DOXYGEN__ */
+
+#if LWGSM_CFG_STATIC_ALLOC || __DOXYGEN__
+
+static lwgsm_mem_pool_t* mem_pools[LWGSM_MEM_POOL_END]; /*!< Pools by identifier, registered on first use */
+
+/**
+ * \brief           Prepare free list of pool and register it for statistics
+ * \note            Core must be locked when calling this function
+ * \param[in]       pool: Memory pool
+ */
+static void
+mem_pool_init(lwgsm_mem_pool_t* pool) {
+    pool->free_blk = NULL;
+    for (size_t i = pool->num; i > 0; --i) {
+        void** blk = (void**)(pool->mem + (i - 1) * pool->size);
+        *blk = pool->free_blk;
+        pool->free_blk = blk;
+    }
+    pool->free_cnt = pool->num;
+    pool->initialized = 1;
+    mem_pools[pool->id] = pool;
+}
+
+/**
+ * \brief           Allocate block from static pool
+ * \param[in]       pool: Memory pool
+ * \return          Pointer to block set to zero on success, `NULL` if pool is empty
+ */
+void*
+lwgsmi_mem_pool_alloc(lwgsm_mem_pool_t* pool) {
+    void** blk;
+
+    lwgsm_core_lock();
+    if (!pool->initialized) {
+        mem_pool_init(pool);
+    }
+    if ((blk = pool->free_blk) != NULL) {
+        pool->free_blk = *blk;
+        --pool->free_cnt;
+        if (pool->num - pool->free_cnt > pool->max_used) {
+            pool->max_used = pool->num - pool->free_cnt;
+        }
+    } else {
+        ++pool->failed;
+    }
+    lwgsm_core_unlock();
+    LWGSM_DEBUGW(LWGSM_CFG_DBG_MEM | LWGSM_DBG_TYPE_TRACE | LWGSM_DBG_LVL_WARNING, blk == NULL,
+                 "[LWGSM MEM] Static pool %d is exhausted\r\n", (int)pool->id);
+    if (blk != NULL) {
+        LWGSM_MEMSET(blk, 0x00, pool->size);
+    }
+    return blk;
+}
+
+/**
+ * \brief           Return block to static pool
+ * \param[in]       pool: Memory pool block was allocated from
+ * \param[in]       ptr: Block to free
+ */
+void
+lwgsmi_mem_pool_free(lwgsm_mem_pool_t* pool, void* ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+    lwgsm_core_lock();
+    *(void**)ptr = pool->free_blk;
+    pool->free_blk = ptr;
+    ++pool->free_cnt;
+    lwgsm_core_unlock();
+}
+
+/**
+ * \brief           Return block to static pool in safe way by invalidating pointer after freeing
+ * \param[in]       pool: Memory pool block was allocated from
+ * \param[in]       ptr: Pointer to pointer to block to free
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwgsmi_mem_pool_free_s(lwgsm_mem_pool_t* pool, void** ptr) {
+    if (ptr != NULL && *ptr != NULL) {
+        lwgsmi_mem_pool_free(pool, *ptr);
+        *ptr = NULL;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * \brief           Get statistics of static memory pool
+ * \note            Pool is registered on its first allocation. Until then, or when pool
+ *                  is not part of the build, all statistics members are set to `0`
+ * \param[in]       id: Pool identifier
+ * \param[out]      stats: Pointer to output statistics structure
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_mem_pool_get_stats(lwgsm_mem_pool_id_t id, lwgsm_mem_pool_stats_t* stats) {
+    lwgsm_mem_pool_t* pool;
+
+    LWGSM_ASSERT(id < LWGSM_MEM_POOL_END);
+    LWGSM_ASSERT(stats != NULL);
+
+    LWGSM_MEMSET(stats, 0x00, sizeof(*stats));
+    lwgsm_core_lock();
+    if ((pool = mem_pools[id]) != NULL) {
+        stats->size = pool->size;
+        stats->total = pool->num;
+        stats->used = pool->num - pool->free_cnt;
+        stats->max_used = pool->max_used;
+        stats->failed = pool->failed;
+    }
+    lwgsm_core_unlock();
+    return lwgsmOK;
+}
+
+#endif /* LWGSM_CFG_STATIC_ALLOC || __DOXYGEN__ */
+
 /**
  * \brief           Free memory in safe way by invalidating pointer after freeing
  * \param[in]       ptr: Pointer to pointer to allocated memory to free
@@ -994,6 +994,36 @@ lwgsmi_parse_cipstatus_conn(const char* str, uint8_t is_conn_line, uint8_t* cont
     return 1;
 }
 
+/**
+ * \brief           Parse `+CIPSEND: <n>,<size>` response with maximal send length for connection
+ * \param[in]       str: Input string
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwgsmi_parse_cipsend_get(const char* str) {
+    uint8_t num;
+    int32_t len;
+
+    if (*str == '+') {
+        str += 10;
+    }
+
+    num = LWGSM_U8(lwgsmi_parse_number(&str));
+    len = lwgsmi_parse_number(&str);
+    if (num >= LWGSM_CFG_MAX_CONNS || len <= 0) {
+        return 0;
+    }
+
+    /* Update only active connections, others get new value when connection becomes active */
+    if (lwgsm.m.conns[num].status.f.active) {
+        lwgsmi_conn_set_max_send_len(&lwgsm.m.conns[num], (size_t)len);
+        LWGSM_DEBUGF(LWGSM_CFG_DBG_CONN | LWGSM_DBG_TYPE_TRACE,
+                     "[LWGSM CONN] Connection %d max send length: %d byte(s)\r\n", (int)num,
+                     (int)lwgsm.m.conns[num].max_send_len);
+    }
+    return 1;
+}
+
 /**
  * \brief           Parse IPD or RECEIVE statements
  * \param[in]       str: Input string
@@ -1031,3 +1061,42 @@ lwgsmi_parse_ipd(const char* str) {
 }
 
 #endif /* LWGSM_CFG_CONN */
+
+#if LWGSM_CFG_DNS || __DOXYGEN__
+
+/**
+ * \brief           Parse +CDNSGIP statement
+ * \param[in]       str: Input string
+ * \return          `1` if host name has been resolved, `0` otherwise
+ */
+uint8_t
+lwgsmi_parse_cdnsgip(const char* str) {
+    lwgsm_ip_t ip;
+
+    if (*str == '+') {
+        str += 10;
+    }
+
+    if (lwgsmi_parse_number(&str) != 1) { /* Resolve failed, error code follows */
+        return 0;
+    }
+    lwgsmi_parse_string(&str, NULL, 0, 1); /* Skip host name, we have it in message */
+    LWGSM_MEMSET(&ip, 0x00, sizeof(ip));
+    lwgsmi_parse_ip(&str, &ip); /* Use first IP address only */
+
+#if LWGSM_CFG_CONN
+    if (CMD_IS_DEF(LWGSM_CMD_CIPSTART)) { /* Host resolved before connection start */
+        LWGSM_MEMCPY(&lwgsm.msg->msg.conn_start.ip, &ip, sizeof(ip));
+        lwgsm.msg->msg.conn_start.use_ip = 1;
+        lwgsmi_dns_cache_add(lwgsm.msg->msg.conn_start.host, &ip);
+        return 1;
+    }
+#endif /* LWGSM_CFG_CONN */
+    if (lwgsm.msg->msg.dns_getbyhostname.ip != NULL) {
+        LWGSM_MEMCPY(lwgsm.msg->msg.dns_getbyhostname.ip, &ip, sizeof(ip));
+    }
+    lwgsmi_dns_cache_add(lwgsm.msg->msg.dns_getbyhostname.host, &ip);
+    return 1;
+}
+
+#endif /* LWGSM_CFG_DNS || __DOXYGEN__ */
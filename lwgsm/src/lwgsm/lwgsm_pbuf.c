@@ -36,6 +36,16 @@
 
 /* Set size of pbuf structure */
 #define SIZEOF_PBUF_STRUCT LWGSM_MEM_ALIGN(sizeof(lwgsm_pbuf_t))
+
+#if LWGSM_CFG_STATIC_ALLOC
+/* Static pool for slice headers, which have no payload memory */
+LWGSM_MEM_POOL_DEFINE(lwgsmi_pbuf_slice_pool, LWGSM_MEM_POOL_PBUF_SLICE, SIZEOF_PBUF_STRUCT,
+                      LWGSM_CFG_STATIC_PBUF_SLICE_NUM);
+#define PBUF_SLICE_ALLOC() lwgsmi_mem_pool_alloc(&lwgsmi_pbuf_slice_pool)
+#else /* LWGSM_CFG_STATIC_ALLOC */
+#define PBUF_SLICE_ALLOC() lwgsm_mem_malloc_tag(LWGSM_MEM_TAG_GENERAL, SIZEOF_PBUF_STRUCT)
+#endif /* !LWGSM_CFG_STATIC_ALLOC */
+
 #define SET_NEW_LEN(v, len)                                                                                            \
     do {                                                                                                               \
         if ((v) != NULL) {                                                                                             \
@@ -66,16 +76,208 @@ pbuf_skip(lwgsm_pbuf_p p, size_t off, size_t* new_off) {
     return p;
 }
 
+#if LWGSM_CFG_PBUF_POOL || __DOXYGEN__
+
+/* Pool index for buffers allocated from heap, or slices from static pool when static allocation is used */
+#define PBUF_POOL_HEAP 0xFF
+
+/* Size of single pool block, including pbuf structure */
+#define PBUF_POOL_BLOCK_SIZE(size) (SIZEOF_PBUF_STRUCT + LWGSM_MEM_ALIGN(size))
+
+/* Size of pool memory in units of words, to keep it aligned */
+#define PBUF_POOL_MEM_WORDS(size, num) ((PBUF_POOL_BLOCK_SIZE(size) * (num) + sizeof(size_t) - 1) / sizeof(size_t))
+
 /**
- * \brief           Allocate packet buffer for network data of specific size
+ * \brief           Packet buffer pool class
+ */
+typedef struct {
+    uint8_t* mem;          /*!< Pool memory */
+    size_t size;           /*!< Payload size of single buffer */
+    size_t num;            /*!< Number of buffers in pool */
+    lwgsm_pbuf_p free_buf; /*!< List of free buffers, linked with `next` member */
+    size_t free_cnt;       /*!< Number of free buffers */
+    size_t max_used;       /*!< Maximal number of used buffers at the same time */
+    size_t failed;         /*!< Number of failed allocations */
+} lwgsm_pbuf_pool_t;
+
+static size_t pool_mem_small[PBUF_POOL_MEM_WORDS(LWGSM_CFG_PBUF_POOL_SMALL_SIZE, LWGSM_CFG_PBUF_POOL_SMALL_NUM)];
+static size_t pool_mem_medium[PBUF_POOL_MEM_WORDS(LWGSM_CFG_PBUF_POOL_MEDIUM_SIZE, LWGSM_CFG_PBUF_POOL_MEDIUM_NUM)];
+static size_t pool_mem_large[PBUF_POOL_MEM_WORDS(LWGSM_CFG_PBUF_POOL_LARGE_SIZE, LWGSM_CFG_PBUF_POOL_LARGE_NUM)];
+
+/* Pool classes, sorted by payload size */
+static lwgsm_pbuf_pool_t pools[LWGSM_PBUF_POOL_CLASSES] = {
+    {.mem = (uint8_t*)pool_mem_small, .size = LWGSM_CFG_PBUF_POOL_SMALL_SIZE, .num = LWGSM_CFG_PBUF_POOL_SMALL_NUM},
+    {.mem = (uint8_t*)pool_mem_medium, .size = LWGSM_CFG_PBUF_POOL_MEDIUM_SIZE, .num = LWGSM_CFG_PBUF_POOL_MEDIUM_NUM},
+    {.mem = (uint8_t*)pool_mem_large, .size = LWGSM_CFG_PBUF_POOL_LARGE_SIZE, .num = LWGSM_CFG_PBUF_POOL_LARGE_NUM},
+};
+static uint8_t pools_initialized; /*!< Set to `1` when free lists are prepared */
+
+/**
+ * \brief           Prepare free lists of all pool classes
+ * \note            Core must be locked when calling this function
+ */
+static void
+pbuf_pool_init(void) {
+    for (size_t i = 0; i < LWGSM_ARRAYSIZE(pools); ++i) {
+        lwgsm_pbuf_pool_t* pool = &pools[i];
+
+        pool->free_buf = NULL;
+        for (size_t j = pool->num; j > 0; --j) {
+            lwgsm_pbuf_p p = (lwgsm_pbuf_p)(pool->mem + (j - 1) * PBUF_POOL_BLOCK_SIZE(pool->size));
+            p->next = pool->free_buf;
+            pool->free_buf = p;
+        }
+        pool->free_cnt = pool->num;
+    }
+    pools_initialized = 1;
+}
+
+/**
+ * \brief           Allocate buffer from smallest pool class which fits payload
+ * \param[in]       len: Payload length
+ * \param[in]       ipd: Set to `1` to allow use of buffers reserved for network receive data
+ * \return          Pointer to buffer or `NULL` if all fitting classes are empty
+ */
+static lwgsm_pbuf_p
+pbuf_pool_alloc(size_t len, uint8_t ipd) {
+    lwgsm_pbuf_p p = NULL;
+    lwgsm_pbuf_pool_t* first = NULL;
+
+    lwgsm_core_lock();
+    if (!pools_initialized) {
+        pbuf_pool_init();
+    }
+    for (size_t i = 0; i < LWGSM_ARRAYSIZE(pools); ++i) {
+        lwgsm_pbuf_pool_t* pool = &pools[i];
+        size_t reserved = (i == LWGSM_ARRAYSIZE(pools) - 1 && !ipd) ? LWGSM_CFG_PBUF_POOL_RESERVE : 0;
+
+        if (pool->size < len) {
+            continue;
+        }
+        if (first == NULL) {
+            first = pool;
+        }
+        if (pool->free_cnt > reserved) {
+            p = pool->free_buf;
+            pool->free_buf = p->next;
+            --pool->free_cnt;
+            if (pool->num - pool->free_cnt > pool->max_used) {
+                pool->max_used = pool->num - pool->free_cnt;
+            }
+            p->pool = LWGSM_U8(i);
+            break;
+        }
+    }
+    if (p == NULL && first != NULL) {
+        ++first->failed;
+    }
+    lwgsm_core_unlock();
+    return p;
+}
+
+/**
+ * \brief           Return buffer to its pool class or to heap memory
+ * \param[in]       p: Packet buffer to release
+ */
+static void
+pbuf_pool_free(lwgsm_pbuf_p p) {
+    if (p->pool == PBUF_POOL_HEAP) {
+#if LWGSM_CFG_STATIC_ALLOC
+        lwgsmi_mem_pool_free(&lwgsmi_pbuf_slice_pool, p);
+#else  /* LWGSM_CFG_STATIC_ALLOC */
+        lwgsm_mem_free_tag(p);
+#endif /* !LWGSM_CFG_STATIC_ALLOC */
+        return;
+    }
+    lwgsm_core_lock();
+    p->next = pools[p->pool].free_buf;
+    pools[p->pool].free_buf = p;
+    ++pools[p->pool].free_cnt;
+    lwgsm_core_unlock();
+}
+
+/**
+ * \brief           Get statistics of packet buffer pool class
+ * \param[in]       index: Pool class index, from `0` (smallest) to \ref LWGSM_PBUF_POOL_CLASSES - 1
+ * \param[out]      stats: Pointer to output statistics structure
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_pbuf_pool_get_stats(size_t index, lwgsm_pbuf_pool_stats_t* stats) {
+    LWGSM_ASSERT(index < LWGSM_ARRAYSIZE(pools));
+    LWGSM_ASSERT(stats != NULL);
+
+    lwgsm_core_lock();
+    if (!pools_initialized) {
+        pbuf_pool_init();
+    }
+    stats->size = pools[index].size;
+    stats->total = pools[index].num;
+    stats->used = pools[index].num - pools[index].free_cnt;
+    stats->max_used = pools[index].max_used;
+    stats->failed = pools[index].failed;
+    lwgsm_core_unlock();
+    return lwgsmOK;
+}
+
+#endif /* LWGSM_CFG_PBUF_POOL || __DOXYGEN__ */
+
+/**
+ * \brief           Compare memory with pbuf chain, starting at offset in first pbuf
+ *
+ * Comparison is done segment by segment and continues into next pbufs in chain
+ *
+ * \param[in]       p: Pbuf where comparison starts
+ * \param[in]       off: Offset in `p`, must be smaller than its length
+ * \param[in]       d: Data to compare
+ * \param[in]       len: Length of data to compare
+ * \return          `1` if memory is equal, `0` otherwise or if chain is too short
+ */
+static uint8_t
+pbuf_memcmp_at(lwgsm_pbuf_p p, size_t off, const uint8_t* d, size_t len) {
+    size_t n;
+
+    for (; p != NULL && len > 0; p = p->next, off = 0) {
+        n = LWGSM_MIN(p->len - off, len);
+        if (memcmp(&p->payload[off], d, n) != 0) {
+            return 0;
+        }
+        d += n;
+        len -= n;
+    }
+    return len == 0;
+}
+
+/**
+ * \brief           Allocate packet buffer from pool or heap memory
  * \param[in]       len: Length of payload memory to allocate
+ * \param[in]       ipd: Set to `1` when buffer is used for network receive data
  * \return          Pointer to allocated memory, `NULL` otherwise
  */
-lwgsm_pbuf_p
-lwgsm_pbuf_new(size_t len) {
+static lwgsm_pbuf_p
+pbuf_new(size_t len, uint8_t ipd) {
     lwgsm_pbuf_p p;
 
-    p = lwgsm_mem_malloc(SIZEOF_PBUF_STRUCT + sizeof(*p->payload) * len);
+#if LWGSM_CFG_PBUF_POOL
+    /* Pools are for receive path, other buffers use heap memory when available */
+    if (len <= pools[LWGSM_ARRAYSIZE(pools) - 1].size && (ipd || LWGSM_CFG_STATIC_ALLOC)) {
+        p = pbuf_pool_alloc(len, ipd);
+    } else {
+#if LWGSM_CFG_STATIC_ALLOC
+        p = NULL; /* No heap fallback in static allocation mode */
+#else             /* LWGSM_CFG_STATIC_ALLOC */
+        p = lwgsm_mem_malloc_tag(ipd ? LWGSM_MEM_TAG_IPD : LWGSM_MEM_TAG_GENERAL,
+                                 SIZEOF_PBUF_STRUCT + sizeof(*p->payload) * len);
+        if (p != NULL) {
+            p->pool = PBUF_POOL_HEAP;
+        }
+#endif /* !LWGSM_CFG_STATIC_ALLOC */
+    }
+#else  /* LWGSM_CFG_PBUF_POOL */
+    p = lwgsm_mem_malloc_tag(ipd ? LWGSM_MEM_TAG_IPD : LWGSM_MEM_TAG_GENERAL,
+                             SIZEOF_PBUF_STRUCT + sizeof(*p->payload) * len);
+    LWGSM_UNUSED(ipd);
+#endif /* !LWGSM_CFG_PBUF_POOL */
     LWGSM_DEBUGW(LWGSM_CFG_DBG_PBUF | LWGSM_DBG_TYPE_TRACE, p == NULL, "[LWGSM PBUF] Failed to allocate %d bytes\r\n",
                  (int)len);
     LWGSM_DEBUGW(LWGSM_CFG_DBG_PBUF | LWGSM_DBG_TYPE_TRACE, p != NULL, "[LWGSM PBUF] Allocated %d bytes on %p\r\n",
@@ -86,10 +288,34 @@ lwgsm_pbuf_new(size_t len) {
         p->len = len;                                          /* Set payload length */
         p->payload = (void*)(((char*)p) + SIZEOF_PBUF_STRUCT); /* Set pointer to payload data */
         p->ref = 1;                                            /* Single reference is used on this pbuf */
+        p->parent = NULL;                                      /* Payload memory is owned by this pbuf */
     }
     return p;
 }
 
+/**
+ * \brief           Allocate packet buffer for network data of specific size
+ * \note            Buffer is allocated from heap memory, also when \ref LWGSM_CFG_PBUF_POOL is enabled.
+ *                  Pools are used only when \ref LWGSM_CFG_STATIC_ALLOC is enabled
+ * \param[in]       len: Length of payload memory to allocate
+ * \return          Pointer to allocated memory, `NULL` otherwise
+ */
+lwgsm_pbuf_p
+lwgsm_pbuf_new(size_t len) {
+    return pbuf_new(len, 0);
+}
+
+/**
+ * \brief           Allocate packet buffer for network receive data
+ * \note            When pools are enabled, buffer is taken from pools only, including reserved buffers
+ * \param[in]       len: Length of payload memory to allocate
+ * \return          Pointer to allocated memory, `NULL` otherwise
+ */
+lwgsm_pbuf_p
+lwgsmi_pbuf_new_ipd(size_t len) {
+    return pbuf_new(len, 1);
+}
+
 /**
  * \brief           Free previously allocated packet buffer
  * \param[in]       pbuf: Packet buffer to free
@@ -115,9 +341,16 @@ lwgsm_pbuf_free(lwgsm_pbuf_p pbuf) {
             LWGSM_DEBUGF(LWGSM_CFG_DBG_PBUF | LWGSM_DBG_TYPE_TRACE,
                          "[LWGSM PBUF] Deallocating %p with len/tot_len: %d/%d\r\n", (void*)p, (int)p->len,
                          (int)p->tot_len);
-            pn = p->next;                 /* Save next entry */
-            lwgsm_mem_free_s((void**)&p); /* Free memory for pbuf */
-            p = pn;                       /* Restore with next entry */
+            pn = p->next; /* Save next entry */
+            if (p->parent != NULL) {
+                lwgsm_pbuf_free(p->parent); /* Slice releases reference on parent payload */
+            }
+#if LWGSM_CFG_PBUF_POOL
+            pbuf_pool_free(p); /* Return pbuf to its pool */
+#else  /* LWGSM_CFG_PBUF_POOL */
+            lwgsm_mem_free_tag_s((void**)&p); /* Free memory for pbuf */
+#endif /* !LWGSM_CFG_PBUF_POOL */
+            p = pn; /* Restore with next entry */
             ++cnt;                        /* Increase number of freed pbufs */
         } else {
             break;
@@ -339,16 +572,40 @@ lwgsm_pbuf_get_at(const lwgsm_pbuf_p pbuf, size_t pos, uint8_t* el) {
  */
 size_t
 lwgsm_pbuf_memfind(const lwgsm_pbuf_p pbuf, const void* needle, size_t len, size_t off) {
-    if (pbuf != NULL && needle != NULL && pbuf->tot_len >= (len + off)) { /* Check if valid entries */
-        /*
-         * Try entire buffer element by element
-         * and in case we have a match, report it
-         */
-        for (size_t i = off; i <= pbuf->tot_len - len; ++i) {
-            if (!lwgsm_pbuf_memcmp(pbuf, needle, len, i)) { /* Check if identical */
-                return i;                                   /* We have a match! */
+    const uint8_t* d = needle;
+    const uint8_t* found;
+    lwgsm_pbuf_p p;
+    size_t pos, last;
+
+    if (pbuf == NULL || needle == NULL || len == 0 || pbuf->tot_len < (len + off)) { /* Check if valid entries */
+        return LWGSM_SIZET_MAX;
+    }
+    last = pbuf->tot_len - len; /* Last possible position of a match */
+
+    /*
+     * Walk the chain once. First byte of needle is found with memchr in current segment,
+     * then rest of needle is compared from there on, continuing into next segments when
+     * candidate crosses segment boundary.
+     */
+    pos = off;
+    for (p = pbuf_skip(pbuf, off, &off); p != NULL; p = p->next, off = 0) {
+        while (off < p->len) {
+            found = memchr(&p->payload[off], d[0], p->len - off);
+            if (found == NULL) {
+                break; /* No candidate in this segment */
             }
+            pos += (size_t)(found - &p->payload[off]);
+            off = (size_t)(found - p->payload);
+            if (pos > last) {
+                return LWGSM_SIZET_MAX; /* Not enough data for a match anymore */
+            }
+            if (pbuf_memcmp_at(p, off, d, len)) {
+                return pos; /* We have a match! */
+            }
+            ++off;
+            ++pos;
         }
+        pos += p->len - off; /* Move position to the beginning of next segment */
     }
     return LWGSM_SIZET_MAX; /* Return maximal value of size_t variable to indicate error */
 }
@@ -379,7 +636,6 @@ lwgsm_pbuf_strfind(const lwgsm_pbuf_p pbuf, const char* str, size_t off) {
 size_t
 lwgsm_pbuf_memcmp(const lwgsm_pbuf_p pbuf, const void* data, size_t len, size_t offset) {
     lwgsm_pbuf_p p;
-    uint8_t el;
     const uint8_t* d = data;
 
     if (pbuf == NULL || data == NULL || len == 0 /* Input parameters check */
@@ -395,16 +651,9 @@ lwgsm_pbuf_memcmp(const lwgsm_pbuf_p pbuf, const void* data, size_t len, size_t
         offset -= p->len; /* Decrease offset by length of pbuf */
     }
 
-    /*
-     * We have known starting pbuf.
-     * Now it is time to check byte by byte from pbuf and memory
-     *
-     * Use byte by byte read function to inspect bytes separatelly
-     */
-    for (size_t i = 0; i < len; ++i) {
-        if (!lwgsm_pbuf_get_at(p, offset + i, &el) || el != d[i]) { /* Get value from pbuf at specific offset */
-            return offset + 1;                                      /* Return value from offset where it failed */
-        }
+    /* Compare memory segment by segment */
+    if (!pbuf_memcmp_at(p, offset, d, len)) {
+        return offset + 1; /* Return value from offset where it failed */
     }
     return 0; /* Memory matches at this point */
 }
@@ -509,7 +758,7 @@ lwgsm_pbuf_advance(lwgsm_pbuf_p pbuf, int len) {
         if ((size_t)len <= pbuf->len) { /* Is there space to decrease? */
             process = 1;
         }
-    } else {
+    } else if (pbuf->parent == NULL) { /* Slices cannot grow outside referenced range */
         /* Is current payload + new len still higher than pbuf structure? */
         if (((uint8_t*)pbuf + SIZEOF_PBUF_STRUCT) < (pbuf->payload + len)) {
             process = 1;
@@ -536,6 +785,67 @@ lwgsm_pbuf_skip(lwgsm_pbuf_p pbuf, size_t offset, size_t* new_offset) {
     return pbuf_skip(pbuf, offset, new_offset); /* Skip pbufs with internal function */
 }
 
+/**
+ * \brief           Create zero-copy slice of pbuf chain
+ *
+ * Slice is a new pbuf chain without own payload memory. Every slice pbuf points
+ * to payload of the parent pbuf it covers and holds a reference on it,
+ * so parent memory stays valid until slice is freed with \ref lwgsm_pbuf_free.
+ *
+ * \note            Slice shares memory with parent. Modifying data in one is visible in the other
+ * \param[in]       pbuf: Parent pbuf chain
+ * \param[in]       offset: Offset in units of bytes in parent chain where slice starts
+ * \param[in]       len: Length of slice in units of bytes. Must not exceed parent chain length from `offset`
+ * \return          New slice pbuf chain on success, `NULL` otherwise
+ */
+lwgsm_pbuf_p
+lwgsm_pbuf_slice(const lwgsm_pbuf_p pbuf, size_t offset, size_t len) {
+    lwgsm_pbuf_p p, s, head = NULL, last = NULL;
+    size_t n;
+
+    if (pbuf == NULL || len == 0 || offset > pbuf->tot_len || len > (pbuf->tot_len - offset)) {
+        return NULL;
+    }
+    p = pbuf_skip(pbuf, offset, &offset); /* Find first parent pbuf in range */
+    for (; p != NULL && len > 0; p = p->next, offset = 0) {
+        n = LWGSM_MIN(p->len - offset, len);
+        if (n == 0) {
+            continue;
+        }
+        if ((s = PBUF_SLICE_ALLOC()) == NULL) {
+            if (head != NULL) {
+                lwgsm_pbuf_free(head);
+            }
+            return NULL;
+        }
+#if LWGSM_CFG_PBUF_POOL
+        s->pool = PBUF_POOL_HEAP;
+#endif /* LWGSM_CFG_PBUF_POOL */
+        s->next = NULL;
+        s->tot_len = len; /* Remaining slice length from this pbuf on */
+        s->len = n;
+        s->ref = 1;
+        s->payload = &p->payload[offset];
+        s->ip = pbuf->ip;
+        s->port = pbuf->port;
+
+        /* Reference memory owner directly, parent is never a slice itself */
+        s->parent = p->parent != NULL ? p->parent : p;
+        lwgsm_pbuf_ref(s->parent);
+
+        if (head == NULL) {
+            head = s;
+        } else {
+            last->next = s;
+        }
+        last = s;
+        len -= n;
+    }
+    LWGSM_DEBUGW(LWGSM_CFG_DBG_PBUF | LWGSM_DBG_TYPE_TRACE, head != NULL, "[LWGSM PBUF] Created slice %p of %p\r\n",
+                 (void*)head, (void*)pbuf);
+    return head;
+}
+
 /**
  * \brief           Dump and debug pbuf chain
  * \param[in]       p: Head pbuf to dump
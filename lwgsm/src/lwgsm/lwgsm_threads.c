@@ -58,11 +58,22 @@ lwgsm_thread_produce(void* const arg) {
     lwgsm_core_lock();
     while (1) {
         lwgsm_core_unlock();
-        do {
-            time = lwgsm_sys_mbox_get(&e->mbox_producer, (void**)&msg, 0); /* Get message from queue */
-        } while (time == LWGSM_SYS_TIMEOUT || msg == NULL);
+#if LWGSM_CFG_CONN_SCHED
+        msg = lwgsmi_conn_sched_get(); /* Get scheduled send message first */
+        if (msg == NULL)
+#endif /* LWGSM_CFG_CONN_SCHED */
+        {
+            do {
+                time = lwgsm_sys_mbox_get(&e->mbox_producer, (void**)&msg, 0); /* Get message from queue */
+            } while (time == LWGSM_SYS_TIMEOUT || msg == NULL);
+        }
         LWGSM_THREAD_PRODUCER_HOOK(); /* Execute producer thread hook */
         lwgsm_core_lock();
+#if LWGSM_CFG_CONN_SCHED
+        if (lwgsmi_conn_sched_is_wakeup(msg)) {
+            continue; /* Scheduled messages are taken at the beginning of loop */
+        }
+#endif /* LWGSM_CFG_CONN_SCHED */
 
         res = lwgsmOK; /* Start with OK */
         e->msg = msg;  /* Set message handle */
@@ -152,6 +163,24 @@ lwgsm_thread_produce(void* const arg) {
             msg->res = res; /* Save response */
         }
 
+#if LWGSM_CFG_CONN
+        /* Connection start is finished when device reports connection result */
+        if (res == lwgsmOK && msg->cmd_def == LWGSM_CMD_CIPSTART && msg->msg.conn_start.pending) {
+            msg->msg.conn_start.detached = 1;
+            e->msg = NULL;
+            continue;
+        }
+#endif /* LWGSM_CFG_CONN */
+#if LWGSM_CFG_CONN_SCHED
+        /* Send gave turn to other connections, put it back to the front of its queue */
+        if (res == lwgsmOK && msg->cmd_def == LWGSM_CMD_CIPSEND && msg->msg.conn_send.yield) {
+            msg->msg.conn_send.yield = 0;
+            lwgsmi_conn_sched_put(msg, 1);
+            e->msg = NULL;
+            continue;
+        }
+#endif /* LWGSM_CFG_CONN_SCHED */
+
 #if LWGSM_CFG_USE_API_FUNC_EVT
         /* Send event function to user */
         if (msg->evt_fn != NULL) {
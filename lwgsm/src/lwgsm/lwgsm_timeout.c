@@ -37,6 +37,16 @@
 static lwgsm_timeout_t* first_timeout;
 static uint32_t last_timeout_time;
 
+#if LWGSM_CFG_STATIC_ALLOC
+LWGSM_MEM_POOL_DEFINE(lwgsmi_timeout_pool, LWGSM_MEM_POOL_TIMEOUT, sizeof(lwgsm_timeout_t),
+                      LWGSM_CFG_STATIC_TIMEOUT_NUM);
+#define TIMEOUT_ALLOC()    lwgsmi_mem_pool_alloc(&lwgsmi_timeout_pool)
+#define TIMEOUT_FREE_S(to) lwgsmi_mem_pool_free_s(&lwgsmi_timeout_pool, (void**)&(to))
+#else /* LWGSM_CFG_STATIC_ALLOC */
+#define TIMEOUT_ALLOC()    lwgsm_mem_calloc_tag(LWGSM_MEM_TAG_TIMEOUT, 1, sizeof(lwgsm_timeout_t))
+#define TIMEOUT_FREE_S(to) lwgsm_mem_free_tag_s((void**)&(to))
+#endif /* !LWGSM_CFG_STATIC_ALLOC */
+
 /**
  * \brief           Get time we have to wait before we can process next timeout
  * \return          Time in units of milliseconds to wait
@@ -80,7 +90,7 @@ process_next_timeout(void) {
          */
         first_timeout = first_timeout->next; /* Set next timeout on a list as first timeout */
         to->fn(to->arg);                     /* Call user callback function */
-        lwgsm_mem_free_s((void**)&to);
+        TIMEOUT_FREE_S(to);
     }
 }
 
@@ -124,8 +134,8 @@ lwgsm_timeout_add(uint32_t time, lwgsm_timeout_fn fn, void* arg) {
     LWGSM_ASSERT(fn != NULL);
 
     /* Allocate memory for timeout structure */
-    if ((to = lwgsm_mem_calloc(1, sizeof(*to))) == NULL) {
-        return lwgsmERRMEM;
+    if ((to = TIMEOUT_ALLOC()) == NULL) {
+        return LWGSMI_ERRMEM;
     }
 
     lwgsm_core_lock();
@@ -186,18 +196,20 @@ lwgsm_timeout_add(uint32_t time, lwgsm_timeout_fn fn, void* arg) {
 }
 
 /**
- * \brief           Remove callback from timeout list
+ * \brief           Remove first timeout with matching callback and optionally argument
  * \param[in]       fn: Callback function to identify timeout to remove
+ * \param[in]       arg: Callback argument to identify timeout to remove
+ * \param[in]       check_arg: Set to `1` to compare argument too, `0` to ignore it
  * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
  */
-lwgsmr_t
-lwgsm_timeout_remove(lwgsm_timeout_fn fn) {
+static lwgsmr_t
+timeout_remove(lwgsm_timeout_fn fn, void* arg, uint8_t check_arg) {
     uint8_t success = 0;
 
     lwgsm_core_lock();
     for (lwgsm_timeout_t *t = first_timeout, *t_prev = NULL; t != NULL;
-         t_prev = t, t = t->next) { /* Check all entries */
-        if (t->fn == fn) {          /* Do we have a match from callback point of view? */
+         t_prev = t, t = t->next) {                          /* Check all entries */
+        if (t->fn == fn && (!check_arg || t->arg == arg)) { /* Do we have a match from callback point of view? */
 
             /*
              * We have to first increase
@@ -219,7 +231,7 @@ lwgsm_timeout_remove(lwgsm_timeout_fn fn) {
             } else {
                 first_timeout = t->next;
             }
-            lwgsm_mem_free_s((void**)&t);
+            TIMEOUT_FREE_S(t);
             success = 1;
             break;
         }
@@ -227,3 +239,27 @@ lwgsm_timeout_remove(lwgsm_timeout_fn fn) {
     lwgsm_core_unlock();
     return success ? lwgsmOK : lwgsmERR;
 }
+
+/**
+ * \brief           Remove callback from timeout list
+ * \param[in]       fn: Callback function to identify timeout to remove
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_timeout_remove(lwgsm_timeout_fn fn) {
+    return timeout_remove(fn, NULL, 0);
+}
+
+/**
+ * \brief           Remove timeout with specific callback and argument from timeout list
+ *
+ * Used when the same callback is scheduled for multiple objects, such as connections
+ *
+ * \param[in]       fn: Callback function to identify timeout to remove
+ * \param[in]       arg: Callback argument to identify timeout to remove
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsmi_timeout_remove_arg(lwgsm_timeout_fn fn, void* arg) {
+    return timeout_remove(fn, arg, 1);
+}
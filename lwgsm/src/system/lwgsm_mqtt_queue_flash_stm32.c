@@ -0,0 +1,129 @@
+/**
+ * \file            lwgsm_mqtt_queue_flash_stm32.c
+ * \brief           MQTT queue storage in internal flash of STM32 with page erase
+ */
+
+/*
+ * Copyright (c) 2022 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGSM - Lightweight GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+
+/*
+ * Driver uses STM32 HAL flash functions, for families with uniform pages
+ * and double-word programming, such as STM32L4, STM32G0, STM32G4 or STM32WB.
+ *
+ * Flash area is accessed directly from memory for read operation.
+ * Area must be reserved in linker script and aligned to page size.
+ */
+#include <string.h>
+#include "lwgsm/apps/lwgsm_mqtt_client_queue.h"
+
+#if LWGSM_CFG_MQTT_QUEUE && !__DOXYGEN__
+
+#if !defined(LWGSM_MQTT_QUEUE_FLASH_HAL_HDR)
+#define LWGSM_MQTT_QUEUE_FLASH_HAL_HDR "stm32l4xx_hal.h"
+#endif /* !defined(LWGSM_MQTT_QUEUE_FLASH_HAL_HDR) */
+
+#include LWGSM_MQTT_QUEUE_FLASH_HAL_HDR
+
+static lwgsmr_t
+prv_flash_read(void* ctx, uint32_t addr, void* data, size_t len) {
+    memcpy(data, (const void*)((uintptr_t)ctx + addr), len);
+    return lwgsmOK;
+}
+
+static lwgsmr_t
+prv_flash_prog(void* ctx, uint32_t addr, const void* data, size_t len) {
+    const uint8_t* d = data;
+    uint32_t a = (uint32_t)(uintptr_t)ctx + addr;
+    lwgsmr_t res = lwgsmOK;
+
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+    for (size_t i = 0; i < len; i += 8) {
+        uint64_t dw;
+
+        memcpy(&dw, &d[i], sizeof(dw));
+        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, a + i, dw) != HAL_OK) {
+            res = lwgsmERR;
+            break;
+        }
+    }
+    HAL_FLASH_Lock();
+    return res;
+}
+
+static lwgsmr_t
+prv_flash_erase(void* ctx, uint32_t addr) {
+    FLASH_EraseInitTypeDef erase = {0};
+    uint32_t a = (uint32_t)(uintptr_t)ctx + addr - FLASH_BASE, page_err;
+    lwgsmr_t res = lwgsmOK;
+
+    erase.TypeErase = FLASH_TYPEERASE_PAGES;
+#if defined(FLASH_BANK_2)
+    erase.Banks = a < FLASH_BANK_SIZE ? FLASH_BANK_1 : FLASH_BANK_2;
+    erase.Page = (a % FLASH_BANK_SIZE) / FLASH_PAGE_SIZE;
+#else  /* defined(FLASH_BANK_2) */
+    erase.Banks = FLASH_BANK_1;
+    erase.Page = a / FLASH_PAGE_SIZE;
+#endif /* !defined(FLASH_BANK_2) */
+    erase.NbPages = 1;
+
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+    if (HAL_FLASHEx_Erase(&erase, &page_err) != HAL_OK) {
+        res = lwgsmERR;
+    }
+    HAL_FLASH_Lock();
+    return res;
+}
+
+/**
+ * \brief           Use internal flash area as queue storage
+ * \param[out]      storage: Storage structure to fill
+ * \param[in]       addr: Absolute start address of flash area, aligned to `FLASH_PAGE_SIZE`
+ * \param[in]       size: Area size in units of bytes, multiple of `FLASH_PAGE_SIZE`
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_mqtt_queue_storage_flash_init(lwgsm_mqtt_queue_storage_t* storage, uint32_t addr, uint32_t size) {
+    LWGSM_ASSERT(storage != NULL);
+    LWGSM_ASSERT(addr >= FLASH_BASE && (addr - FLASH_BASE) % FLASH_PAGE_SIZE == 0);
+    LWGSM_ASSERT(size > 0 && size % FLASH_PAGE_SIZE == 0);
+
+    memset(storage, 0x00, sizeof(*storage));
+    storage->read = prv_flash_read;
+    storage->prog = prv_flash_prog;
+    storage->erase = prv_flash_erase;
+    storage->size = size;
+    storage->sector_size = FLASH_PAGE_SIZE;
+    storage->prog_size = 8;
+    storage->ctx = (void*)(uintptr_t)addr;
+    return lwgsmOK;
+}
+
+#endif /* LWGSM_CFG_MQTT_QUEUE && !__DOXYGEN__ */
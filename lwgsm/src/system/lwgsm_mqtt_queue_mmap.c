@@ -0,0 +1,165 @@
+/**
+ * \file            lwgsm_mqtt_queue_mmap.c
+ * \brief           MQTT queue storage in memory-mapped file for POSIX systems
+ */
+
+/*
+ * Copyright (c) 2022 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGSM - Lightweight GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "lwgsm/apps/lwgsm_mqtt_client_queue.h"
+
+#if LWGSM_CFG_MQTT_QUEUE && !__DOXYGEN__
+
+/*
+ * File is mapped to memory with shared mapping and changes are written back with `msync`.
+ * Programming clears bits only, same as NOR flash, to keep identical behavior on all storages.
+ */
+
+/**
+ * \brief           Memory-mapped file context
+ */
+typedef struct {
+    uint8_t* mem;         /*!< Start of mapping */
+    uint32_t size;        /*!< Size of mapping */
+    uint32_t sector_size; /*!< Erase unit */
+} prv_mmap_t;
+
+static lwgsmr_t
+prv_mmap_read(void* ctx, uint32_t addr, void* data, size_t len) {
+    prv_mmap_t* m = ctx;
+
+    memcpy(data, m->mem + addr, len);
+    return lwgsmOK;
+}
+
+static lwgsmr_t
+prv_mmap_prog(void* ctx, uint32_t addr, const void* data, size_t len) {
+    prv_mmap_t* m = ctx;
+    const uint8_t* d = data;
+
+    for (size_t i = 0; i < len; ++i) {
+        m->mem[addr + i] &= d[i];
+    }
+    return lwgsmOK;
+}
+
+static lwgsmr_t
+prv_mmap_erase(void* ctx, uint32_t addr) {
+    prv_mmap_t* m = ctx;
+
+    memset(m->mem + addr, 0xFF, m->sector_size);
+    return lwgsmOK;
+}
+
+static lwgsmr_t
+prv_mmap_sync(void* ctx) {
+    prv_mmap_t* m = ctx;
+
+    return msync(m->mem, m->size, MS_SYNC) == 0 ? lwgsmOK : lwgsmERR;
+}
+
+/**
+ * \brief           Open file as queue storage
+ *
+ * File is created when it does not exist. File with different size is formatted.
+ *
+ * \param[out]      storage: Storage structure to fill
+ * \param[in]       path: File path
+ * \param[in]       size: Storage size in units of bytes, multiple of `sector_size`
+ * \param[in]       sector_size: Sector size in units of bytes
+ * \return          \ref lwgsmOK on success, member of \ref lwgsmr_t enumeration otherwise
+ */
+lwgsmr_t
+lwgsm_mqtt_queue_storage_mmap_open(lwgsm_mqtt_queue_storage_t* storage, const char* path, uint32_t size,
+                                   uint32_t sector_size) {
+    struct stat st;
+    prv_mmap_t* m;
+    void* mem;
+    int fd;
+
+    LWGSM_ASSERT(storage != NULL && path != NULL);
+    LWGSM_ASSERT(sector_size > 0 && size > 0 && size % sector_size == 0);
+
+    if ((m = malloc(sizeof(*m))) == NULL) {
+        return lwgsmERRMEM;
+    }
+    if ((fd = open(path, O_RDWR | O_CREAT, 0644)) < 0) {
+        free(m);
+        return lwgsmERR;
+    }
+    if (fstat(fd, &st) != 0 || (st.st_size != (off_t)size && ftruncate(fd, (off_t)size) != 0)
+        || (mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+        close(fd);
+        free(m);
+        return lwgsmERR;
+    }
+    close(fd); /* Mapping stays valid */
+
+    m->mem = mem;
+    m->size = size;
+    m->sector_size = sector_size;
+    if (st.st_size != (off_t)size) {
+        memset(m->mem, 0xFF, size); /* New file, start erased */
+        msync(m->mem, size, MS_SYNC);
+    }
+
+    memset(storage, 0x00, sizeof(*storage));
+    storage->read = prv_mmap_read;
+    storage->prog = prv_mmap_prog;
+    storage->erase = prv_mmap_erase;
+    storage->sync = prv_mmap_sync;
+    storage->size = size;
+    storage->sector_size = sector_size;
+    storage->prog_size = 1;
+    storage->ctx = m;
+    return lwgsmOK;
+}
+
+/**
+ * \brief           Close storage opened with \ref lwgsm_mqtt_queue_storage_mmap_open
+ * \param[in]       storage: Storage structure
+ */
+void
+lwgsm_mqtt_queue_storage_mmap_close(lwgsm_mqtt_queue_storage_t* storage) {
+    prv_mmap_t* m;
+
+    if (storage != NULL && (m = storage->ctx) != NULL) {
+        msync(m->mem, m->size, MS_SYNC);
+        munmap(m->mem, m->size);
+        free(m);
+        storage->ctx = NULL;
+    }
+}
+
+#endif /* LWGSM_CFG_MQTT_QUEUE && !__DOXYGEN__ */
@@ -98,7 +98,8 @@ mqtt_client_api_thread(void const* arg) {
             if ((res = lwgsm_mqtt_client_api_receive(client, &buf, 5000)) == lwgsmOK) {
                 if (buf != NULL) {
                     printf("Publish received!\r\n");
-                    printf("Topic: %s, payload: %s\r\n", buf->topic, buf->payload);
+                    printf("Topic: %.*s, payload: %.*s\r\n", (int)buf->topic_len, buf->topic, (int)buf->payload_len,
+                           (const char*)buf->payload);
                     lwgsm_mqtt_client_api_buf_free(buf);
                     buf = NULL;
                 }
@@ -0,0 +1,48 @@
+/**
+ * \file            lwgsm_opts.h
+ * \brief           Options for host unit tests
+ */
+
+/*
+ * Copyright (c) 2022 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGSM - Lightweight GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#ifndef LWGSM_HDR_OPTS_H
+#define LWGSM_HDR_OPTS_H
+
+#if !__DOXYGEN__
+#define LWGSM_CFG_DBG           LWGSM_DBG_OFF
+#define LWGSM_CFG_MEM_ALIGNMENT 8 /* Block headers hold pointers on 64-bit host */
+
+#define LWGSM_CFG_NETWORK       1
+#define LWGSM_CFG_CONN          1
+
+#define LWGSM_CFG_MQTT_ROUTER   1
+#define LWGSM_CFG_MQTT_QUEUE    1
+#endif /* !__DOXYGEN__ */
+
+#endif /* LWGSM_HDR_OPTS_H */
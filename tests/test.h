@@ -0,0 +1,68 @@
+/**
+ * \file            test.h
+ * \brief           Minimal check macros for host unit tests
+ */
+
+/*
+ * Copyright (c) 2022 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGSM - Lightweight GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#ifndef LWGSM_HDR_TEST_H
+#define LWGSM_HDR_TEST_H
+
+#include <stdio.h>
+
+extern int test_failed;
+
+/**
+ * \brief           Check condition and report failure with location, test continues
+ * \param[in]       c: Condition to check
+ */
+#define TEST_CHECK(c)                                                                                                  \
+    do {                                                                                                               \
+        if (!(c)) {                                                                                                    \
+            printf("%s:%d: check failed: %s\r\n", __FILE__, (int)__LINE__, #c);                                        \
+            ++test_failed;                                                                                             \
+        }                                                                                                              \
+    } while (0)
+
+/**
+ * \brief           Run test function and print its name
+ * \param[in]       fn: Test function without parameters
+ */
+#define TEST_RUN(fn)                                                                                                   \
+    do {                                                                                                               \
+        printf("Running %s\r\n", #fn);                                                                                 \
+        fn();                                                                                                          \
+    } while (0)
+
+/* Result of the test program */
+#define TEST_RESULT() (test_failed > 0 ? 1 : 0)
+
+void test_sys_set_now(uint32_t now);
+
+#endif /* LWGSM_HDR_TEST_H */
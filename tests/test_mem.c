@@ -0,0 +1,208 @@
+/**
+ * \file            test_mem.c
+ * \brief           Unit tests for memory allocator
+ */
+
+/*
+ * Copyright (c) 2022 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGSM - Lightweight GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include <string.h>
+#include "lwgsm/lwgsm_mem.h"
+#include "lwgsm/lwgsm_utils.h"
+#include "test.h"
+
+#define ALLOC_NUM 64
+
+static uint8_t mem_a[0x3000], mem_b[0x1000];
+static void* ptrs[ALLOC_NUM];
+static size_t sizes[ALLOC_NUM];
+static lwgsm_mem_stats_t stats_init;
+static uint32_t rand_state = 1;
+
+/**
+ * \brief           Get pseudo random number, sequence is the same on every run
+ * \param[in]       max: Upper limit, exclusive
+ * \return          Random number
+ */
+static uint32_t
+prv_rand(uint32_t max) {
+    rand_state = rand_state * 1103515245U + 12345U;
+    return (rand_state >> 16) % max;
+}
+
+/**
+ * \brief           Fill memory with pattern, specific to allocation index
+ */
+static void
+prv_fill(size_t idx) {
+    for (size_t i = 0; i < sizes[idx]; ++i) {
+        ((uint8_t*)ptrs[idx])[i] = (uint8_t)(idx * 31 + i);
+    }
+}
+
+/**
+ * \brief           Check pattern of allocation, for first `len` bytes
+ * \return          `1` if data are intact, `0` otherwise
+ */
+static uint8_t
+prv_check(size_t idx, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        if (((uint8_t*)ptrs[idx])[i] != (uint8_t)(idx * 31 + i)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * \brief           Free all allocations and check memory is back in initial state
+ */
+static void
+prv_free_all(void) {
+    lwgsm_mem_stats_t stats;
+
+    for (size_t i = 0; i < ALLOC_NUM; ++i) {
+        TEST_CHECK(ptrs[i] == NULL || prv_check(i, sizes[i]));
+        lwgsm_mem_free_s(&ptrs[i]);
+        sizes[i] = 0;
+    }
+    TEST_CHECK(lwgsm_mem_get_stats(&stats) == lwgsmOK);
+    TEST_CHECK(stats.free_bytes == stats_init.free_bytes);
+    TEST_CHECK(stats.free_blocks == stats_init.free_blocks);
+    TEST_CHECK(stats.largest_free_block == stats_init.largest_free_block);
+}
+
+static void
+test_alloc_free(void) {
+    /* Allocate and free in random order, allocations never overlap */
+    for (size_t n = 0; n < 5000; ++n) {
+        size_t idx = prv_rand(ALLOC_NUM);
+
+        if (ptrs[idx] == NULL) {
+            sizes[idx] = 1 + prv_rand(prv_rand(8) == 0 ? 1024 : 64);
+            if ((ptrs[idx] = lwgsm_mem_malloc(sizes[idx])) != NULL) {
+                TEST_CHECK(((uintptr_t)ptrs[idx] % LWGSM_CFG_MEM_ALIGNMENT) == 0);
+                prv_fill(idx);
+            }
+        } else {
+            TEST_CHECK(prv_check(idx, sizes[idx]));
+            lwgsm_mem_free_s(&ptrs[idx]);
+        }
+    }
+    prv_free_all();
+}
+
+static void
+test_realloc(void) {
+    /* Data are kept on shrink and on grow, up to smaller size */
+    for (size_t n = 0; n < 2000; ++n) {
+        size_t idx = prv_rand(ALLOC_NUM / 4), size = 1 + prv_rand(512);
+        void* ptr;
+
+        if ((ptr = lwgsm_mem_realloc(ptrs[idx], size)) != NULL) {
+            ptrs[idx] = ptr;
+            TEST_CHECK(prv_check(idx, LWGSM_MIN(size, sizes[idx])));
+            sizes[idx] = size;
+            prv_fill(idx);
+        } else {
+            TEST_CHECK(ptrs[idx] == NULL || prv_check(idx, sizes[idx])); /* Old memory is kept on failure */
+        }
+    }
+    prv_free_all();
+}
+
+static void
+test_calloc(void) {
+    uint8_t* ptr;
+
+    /* Dirty memory first, as used before */
+    TEST_CHECK((ptr = lwgsm_mem_malloc(250)) != NULL);
+    if (ptr != NULL) {
+        memset(ptr, 0xA5, 250);
+    }
+    lwgsm_mem_free(ptr);
+    TEST_CHECK((ptr = lwgsm_mem_calloc(10, 25)) != NULL);
+    for (size_t i = 0; ptr != NULL && i < 250; ++i) {
+        TEST_CHECK(ptr[i] == 0);
+    }
+    lwgsm_mem_free(ptr);
+}
+
+static void
+test_exhaust(void) {
+    lwgsm_mem_stats_t stats;
+    size_t cnt;
+
+    /* Allocate until memory is full */
+    for (cnt = 0; cnt < ALLOC_NUM; ++cnt) {
+        sizes[cnt] = 512;
+        if ((ptrs[cnt] = lwgsm_mem_malloc(sizes[cnt])) == NULL) {
+            break;
+        }
+        prv_fill(cnt);
+    }
+    TEST_CHECK(cnt > 0 && cnt < ALLOC_NUM);
+    TEST_CHECK(lwgsm_mem_get_stats(&stats) == lwgsmOK);
+    TEST_CHECK(stats.failed_allocs > 0);
+    TEST_CHECK(stats.min_ever_free_bytes <= stats.free_bytes);
+    TEST_CHECK(stats.largest_free_block < 512);
+    prv_free_all();
+
+    /* Sizes larger than any block are refused */
+    TEST_CHECK(lwgsm_mem_malloc(SIZE_MAX) == NULL);
+    TEST_CHECK(lwgsm_mem_malloc((LWGSM_SZ(1) << 30) - 1) == NULL);
+
+    /* Largest reported block can be allocated */
+    TEST_CHECK((ptrs[0] = lwgsm_mem_malloc(stats_init.largest_free_block)) != NULL);
+    sizes[0] = 0;
+    prv_free_all();
+}
+
+int
+main(void) {
+    lwgsm_mem_region_t regions[] = {
+        {mem_a, sizeof(mem_a)},
+        {mem_b, sizeof(mem_b)},
+    };
+
+    /* Regions must be in ascending order by address */
+    if ((uintptr_t)mem_b < (uintptr_t)mem_a) {
+        regions[0] = (lwgsm_mem_region_t){mem_b, sizeof(mem_b)};
+        regions[1] = (lwgsm_mem_region_t){mem_a, sizeof(mem_a)};
+    }
+    TEST_CHECK(lwgsm_mem_assignmemory(regions, LWGSM_ARRAYSIZE(regions)));
+    TEST_CHECK(!lwgsm_mem_assignmemory(regions, LWGSM_ARRAYSIZE(regions))); /* Regions are set only once */
+    TEST_CHECK(lwgsm_mem_get_stats(&stats_init) == lwgsmOK);
+    TEST_CHECK(stats_init.free_blocks == 2 && stats_init.failed_allocs == 0);
+
+    TEST_RUN(test_alloc_free);
+    TEST_RUN(test_realloc);
+    TEST_RUN(test_calloc);
+    TEST_RUN(test_exhaust);
+    return TEST_RESULT();
+}
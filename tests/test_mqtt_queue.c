@@ -0,0 +1,417 @@
+/**
+ * \file            test_mqtt_queue.c
+ * \brief           Unit tests for MQTT store-and-forward queue
+ */
+
+/*
+ * Copyright (c) 2022 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGSM - Lightweight GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "lwgsm/apps/lwgsm_mqtt_client_queue.h"
+#include "test.h"
+
+#define STORAGE_SECTOR_SIZE 256
+#define STORAGE_SIZE        (4 * STORAGE_SECTOR_SIZE)
+#define STORAGE_NO_LIMIT    ((size_t)-1)
+#define MSG_MAX             64
+
+/**
+ * \brief           RAM storage with NOR flash behavior and power loss simulation
+ */
+typedef struct {
+    uint8_t mem[STORAGE_SIZE]; /*!< Storage memory */
+    size_t prog_budget;        /*!< Number of bytes programmed before power is lost */
+} test_storage_t;
+
+static test_storage_t storage_mem;
+static lwgsm_mqtt_queue_storage_t storage;
+static lwgsm_mqtt_queue_t queue;
+
+static lwgsmr_t
+prv_storage_read(void* ctx, uint32_t addr, void* data, size_t len) {
+    test_storage_t* s = ctx;
+
+    memcpy(data, &s->mem[addr], len);
+    return lwgsmOK;
+}
+
+static lwgsmr_t
+prv_storage_prog(void* ctx, uint32_t addr, const void* data, size_t len) {
+    test_storage_t* s = ctx;
+    const uint8_t* d = data;
+
+    /* Power is lost in the middle of programming, rest of data is not written */
+    for (size_t i = 0; i < len; ++i) {
+        if (s->prog_budget == 0) {
+            return lwgsmERR;
+        }
+        if (s->prog_budget != STORAGE_NO_LIMIT) {
+            --s->prog_budget;
+        }
+        s->mem[addr + i] &= d[i];
+    }
+    return lwgsmOK;
+}
+
+static lwgsmr_t
+prv_storage_erase(void* ctx, uint32_t addr) {
+    test_storage_t* s = ctx;
+
+    if (s->prog_budget == 0) {
+        return lwgsmERR;
+    }
+    memset(&s->mem[addr], 0xFF, STORAGE_SECTOR_SIZE);
+    return lwgsmOK;
+}
+
+/**
+ * \brief           Erase storage and prepare interface
+ */
+static void
+prv_storage_format(void) {
+    memset(&storage_mem, 0xFF, sizeof(storage_mem));
+    storage_mem.prog_budget = STORAGE_NO_LIMIT;
+    storage.read = prv_storage_read;
+    storage.prog = prv_storage_prog;
+    storage.erase = prv_storage_erase;
+    storage.sync = NULL;
+    storage.size = STORAGE_SIZE;
+    storage.sector_size = STORAGE_SECTOR_SIZE;
+    storage.prog_size = 8;
+    storage.ctx = &storage_mem;
+}
+
+/**
+ * \brief           Initialize queue from storage, as after reset
+ */
+static void
+prv_reboot(void) {
+    storage_mem.prog_budget = STORAGE_NO_LIMIT;
+    TEST_CHECK(lwgsm_mqtt_queue_init(&queue, &storage) == lwgsmOK);
+    TEST_CHECK(lwgsm_mqtt_queue_set_drain_rate(&queue, 0) == lwgsmOK);
+}
+
+/**
+ * \brief           Append message with payload holding its identifier
+ * \param[in]       id: Message identifier
+ * \return          Result of append
+ */
+static lwgsmr_t
+prv_append(uint32_t id) {
+    char payload[24];
+
+    sprintf(payload, "message-%08u", (unsigned)id);
+    return lwgsm_mqtt_queue_append(&queue, "test/queue", payload, LWGSM_U16(strlen(payload)),
+                                   LWGSM_MQTT_QOS_AT_LEAST_ONCE, 0);
+}
+
+/**
+ * \brief           Get pending messages in order, as client would send them
+ * \param[out]      ids: Output array of message identifiers
+ * \param[in]       ack_num: Number of first messages to acknowledge, others are reported as failed
+ * \return          Number of messages
+ */
+static size_t
+prv_drain(uint32_t* ids, size_t ack_num) {
+    lwgsmi_mqtt_queue_msg_t msg;
+    uint8_t data[64];
+    size_t cnt = 0;
+
+    while (cnt < MSG_MAX && lwgsmi_mqtt_queue_next(&queue, &msg)) {
+        TEST_CHECK(msg.len <= sizeof(data) && msg.topic_len == 10);
+        if (msg.len > sizeof(data) || lwgsmi_mqtt_queue_read(&queue, msg.addr, data, msg.len) != lwgsmOK) {
+            break;
+        }
+        TEST_CHECK(!memcmp(&data[2], "test/queue", 10));
+        data[msg.len < sizeof(data) ? msg.len : sizeof(data) - 1] = 0;
+        ids[cnt] = (uint32_t)strtoul((const char*)&data[2 + 10 + 8], NULL, 10);
+        lwgsmi_mqtt_queue_sent(&queue, &msg);
+        lwgsmi_mqtt_queue_ack(&queue, msg.seq, cnt < ack_num ? lwgsmOK : lwgsmERR);
+        if (cnt++ >= ack_num) {
+            break; /* Failed message is sent again, stop here */
+        }
+    }
+    return cnt;
+}
+
+/**
+ * \brief           Check that drained messages are consecutive identifiers
+ * \param[in]       first: Expected identifier of first message
+ * \param[in]       last: Expected identifier of last message
+ */
+static void
+prv_check_pending(uint32_t first, uint32_t last) {
+    lwgsm_mqtt_queue_stats_t stats;
+    uint32_t ids[MSG_MAX];
+    size_t cnt;
+
+    TEST_CHECK(lwgsm_mqtt_queue_get_stats(&queue, &stats) == lwgsmOK);
+    TEST_CHECK(stats.pending == last + 1 - first);
+
+    /* Read without acknowledge, messages stay in the queue */
+    cnt = prv_drain(ids, 0);
+    TEST_CHECK(cnt == (last >= first ? 1 : 0));
+    TEST_CHECK(cnt == 0 || ids[0] == first);
+}
+
+static void
+test_append_ack(void) {
+    uint32_t ids[MSG_MAX];
+
+    prv_storage_format();
+    prv_reboot();
+    for (uint32_t i = 1; i <= 6; ++i) {
+        TEST_CHECK(prv_append(i) == lwgsmOK);
+    }
+    TEST_CHECK(prv_drain(ids, 3) == 4);
+    TEST_CHECK(ids[0] == 1 && ids[1] == 2 && ids[2] == 3 && ids[3] == 4);
+    TEST_CHECK(lwgsm_mqtt_queue_flush(&queue) == lwgsmOK);
+
+    /* Acknowledged messages are not sent again after reset */
+    prv_reboot();
+    prv_check_pending(4, 6);
+    TEST_CHECK(prv_drain(ids, 3) == 3);
+    TEST_CHECK(ids[0] == 4 && ids[1] == 5 && ids[2] == 6);
+}
+
+static void
+test_ack_not_flushed(void) {
+    uint32_t ids[MSG_MAX];
+
+    prv_storage_format();
+    prv_reboot();
+    for (uint32_t i = 1; i <= 3; ++i) {
+        TEST_CHECK(prv_append(i) == lwgsmOK);
+    }
+    TEST_CHECK(prv_drain(ids, 2) == 3);
+
+    /* Acknowledge kept in memory only, messages are delivered at least once */
+    prv_reboot();
+    prv_check_pending(1, 3);
+}
+
+static void
+test_wrap(void) {
+    uint32_t ids[MSG_MAX], next = 1;
+
+    prv_storage_format();
+    prv_reboot();
+
+    /* Log wraps storage several times, while messages are acknowledged */
+    for (uint32_t i = 1; i <= 100; ++i) {
+        TEST_CHECK(prv_append(i) == lwgsmOK);
+        if (i % 3 == 0) {
+            size_t cnt = prv_drain(ids, 3);
+            for (size_t k = 0; k < cnt && k < 3; ++k, ++next) {
+                TEST_CHECK(ids[k] == next);
+            }
+            TEST_CHECK(lwgsm_mqtt_queue_flush(&queue) == lwgsmOK);
+        }
+    }
+    prv_reboot();
+    prv_check_pending(next, 100);
+}
+
+static void
+test_full(void) {
+    lwgsm_mqtt_queue_stats_t stats;
+    uint32_t i;
+    lwgsmr_t res = lwgsmOK;
+
+    prv_storage_format();
+    prv_reboot();
+    for (i = 1; i <= 200 && (res = prv_append(i)) == lwgsmOK; ++i) {}
+    TEST_CHECK(res == lwgsmERRMEM);
+    TEST_CHECK(lwgsm_mqtt_queue_get_stats(&queue, &stats) == lwgsmOK);
+    TEST_CHECK(stats.dropped == 1 && stats.pending == i - 1);
+
+    /* Full queue keeps all accepted messages */
+    prv_reboot();
+    prv_check_pending(1, i - 1);
+}
+
+static void
+test_crc(void) {
+    uint32_t ids[MSG_MAX];
+    size_t pos;
+
+    prv_storage_format();
+    prv_reboot();
+    for (uint32_t i = 1; i <= 3; ++i) {
+        TEST_CHECK(prv_append(i) == lwgsmOK);
+    }
+
+    /* Clear single bit in payload of second message, '0' becomes ' ' */
+    for (pos = 0; pos < sizeof(storage_mem.mem) - 8 && memcmp(&storage_mem.mem[pos], "00000002", 8) != 0; ++pos) {}
+    TEST_CHECK(pos < sizeof(storage_mem.mem) - 8);
+    storage_mem.mem[pos] &= 0xEF;
+
+    /* Damaged record and records after it in the same sector are not sent */
+    prv_reboot();
+    prv_check_pending(1, 1);
+
+    /* Queue continues in next sector */
+    TEST_CHECK(prv_append(4) == lwgsmOK);
+    TEST_CHECK(prv_drain(ids, 2) == 2);
+    TEST_CHECK(ids[0] == 1 && ids[1] == 4);
+}
+
+static void
+test_drop(void) {
+    lwgsm_mqtt_queue_stats_t stats;
+    lwgsmi_mqtt_queue_msg_t msg;
+    char payload[40] = {0};
+
+    prv_storage_format();
+    prv_reboot();
+
+    /* Message longer than client can send is refused */
+    lwgsmi_mqtt_queue_set_max_len(&queue, 2 + 10 + 16);
+    memset(payload, 'a', sizeof(payload) - 1);
+    TEST_CHECK(lwgsm_mqtt_queue_append(&queue, "test/queue", payload, 17, LWGSM_MQTT_QOS_AT_LEAST_ONCE, 0)
+               == lwgsmERRPAR);
+    for (uint32_t i = 1; i <= 3; ++i) {
+        TEST_CHECK(prv_append(i) == lwgsmOK);
+    }
+
+    /* Message not accepted by server is removed and counted as dropped, not acknowledged */
+    TEST_CHECK(lwgsmi_mqtt_queue_next(&queue, &msg));
+    lwgsmi_mqtt_queue_sent(&queue, &msg);
+    TEST_CHECK(lwgsmi_mqtt_queue_next(&queue, &msg));
+    lwgsmi_mqtt_queue_drop(&queue, &msg);
+    TEST_CHECK(lwgsmi_mqtt_queue_next(&queue, &msg));
+    lwgsmi_mqtt_queue_sent(&queue, &msg);
+    lwgsmi_mqtt_queue_ack(&queue, msg.seq, lwgsmOK);
+    TEST_CHECK(lwgsm_mqtt_queue_get_stats(&queue, &stats) == lwgsmOK);
+    TEST_CHECK(stats.pending == 3 && stats.acked == 0 && stats.dropped == 0);
+    lwgsmi_mqtt_queue_ack(&queue, msg.seq - 2, lwgsmOK);
+    TEST_CHECK(lwgsm_mqtt_queue_get_stats(&queue, &stats) == lwgsmOK);
+    TEST_CHECK(stats.pending == 0 && stats.acked == 2 && stats.dropped == 1);
+}
+
+static void
+test_write_error(void) {
+    lwgsm_mqtt_queue_stats_t stats;
+    uint32_t ids[MSG_MAX];
+
+    /* Storage fails once at every position of first record, then works again */
+    for (size_t budget = 0; budget <= 48; ++budget) {
+        size_t cnt, k = 0;
+        lwgsmr_t res;
+
+        prv_storage_format();
+        prv_reboot();
+        storage_mem.prog_budget = budget;
+        res = prv_append(1);
+        storage_mem.prog_budget = STORAGE_NO_LIMIT;
+        TEST_CHECK(prv_append(2) == lwgsmOK);
+        TEST_CHECK(prv_append(3) == lwgsmOK);
+
+        /* Failed message may be sent, others are sent once and in order */
+        cnt = prv_drain(ids, MSG_MAX);
+        if (cnt > 0 && ids[0] == 1) {
+            ++k;
+        }
+        TEST_CHECK(res == lwgsmOK || res == lwgsmERR);
+        TEST_CHECK(res != lwgsmOK || k == 1);
+        TEST_CHECK(cnt == k + 2 && ids[k] == 2 && ids[k + 1] == 3);
+        TEST_CHECK(lwgsm_mqtt_queue_get_stats(&queue, &stats) == lwgsmOK && stats.pending == 0);
+        TEST_CHECK(lwgsm_mqtt_queue_flush(&queue) == lwgsmOK);
+
+        prv_reboot();
+        prv_check_pending(1, 0);
+    }
+}
+
+static void
+test_power_loss(void) {
+    uint32_t ids[MSG_MAX];
+    int failed = test_failed;
+
+    /* Power is lost after every possible number of programmed bytes */
+    for (size_t budget = 0; budget < 2 * STORAGE_SIZE; budget += 3) {
+        uint32_t last_ok = 0, id;
+        uint8_t flushed, ok[11] = {0};
+        size_t cnt;
+
+        prv_storage_format();
+        prv_reboot();
+        storage_mem.prog_budget = budget;
+
+        for (id = 1; id <= 3; ++id) {
+            ok[id] = prv_append(id) == lwgsmOK;
+        }
+        prv_drain(ids, 2);
+        flushed = lwgsm_mqtt_queue_flush(&queue) == lwgsmOK;
+        for (; id <= 10; ++id) {
+            ok[id] = prv_append(id) == lwgsmOK;
+        }
+
+        /*
+         * Every accepted message not acknowledged yet survives, in order.
+         * Message which failed to append may be sent, partially written records are never sent
+         */
+        prv_reboot();
+        cnt = prv_drain(ids, MSG_MAX);
+        for (size_t k = 0; k < cnt; ++k) {
+            TEST_CHECK(ids[k] >= 1 && ids[k] <= 10);
+            TEST_CHECK(k == 0 || ids[k] > ids[k - 1]);
+            TEST_CHECK(!flushed || !ok[1] || !ok[2] || ids[k] > 2);
+        }
+        for (id = 3; id <= 10; ++id) {
+            size_t k;
+
+            for (k = 0; k < cnt && ids[k] != id; ++k) {}
+            TEST_CHECK(!ok[id] || k < cnt);
+            last_ok = ok[id] ? id : last_ok;
+        }
+        TEST_CHECK(cnt == 0 || ids[cnt - 1] >= last_ok);
+
+        /* Queue is usable after recovery */
+        TEST_CHECK(prv_append(100) == lwgsmOK);
+        TEST_CHECK(prv_drain(ids, MSG_MAX) == 1 && ids[0] == 100);
+        if (test_failed != failed) {
+            printf("power lost after %u bytes\r\n", (unsigned)budget);
+            break;
+        }
+    }
+}
+
+int
+main(void) {
+    TEST_RUN(test_append_ack);
+    TEST_RUN(test_ack_not_flushed);
+    TEST_RUN(test_wrap);
+    TEST_RUN(test_full);
+    TEST_RUN(test_crc);
+    TEST_RUN(test_drop);
+    TEST_RUN(test_write_error);
+    TEST_RUN(test_power_loss);
+    return TEST_RESULT();
+}
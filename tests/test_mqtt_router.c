@@ -0,0 +1,207 @@
+/**
+ * \file            test_mqtt_router.c
+ * \brief           Unit tests for MQTT topic filter router
+ */
+
+/*
+ * Copyright (c) 2022 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGSM - Lightweight GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include <string.h>
+#include "lwgsm/apps/lwgsm_mqtt_client_router.h"
+#include "lwgsm/lwgsm_mem.h"
+#include "test.h"
+
+static lwgsmi_mqtt_router_t router;
+static char called[256]; /*!< Filters of called handlers, separated with `,` */
+static uint8_t mem[0x4000];
+
+/**
+ * \brief           Route handler, appends its filter to list of called handlers
+ */
+static void
+prv_route_fn(lwgsm_mqtt_client_p client, lwgsm_mqtt_evt_t* evt, void* arg) {
+    (void)client;
+    (void)evt;
+    strcat(called, (const char*)arg);
+    strcat(called, ",");
+}
+
+/**
+ * \brief           Register filter, with filter string as handler argument
+ * \param[in]       filter: Topic filter
+ * \return          Result of router add
+ */
+static lwgsmr_t
+prv_add(const char* filter) {
+    return lwgsmi_mqtt_router_add(&router, filter, prv_route_fn, (void*)filter);
+}
+
+/**
+ * \brief           Dispatch topic and get list of called handlers
+ * \param[in]       topic: Received topic
+ * \return          Filters of called handlers, in order of calls
+ */
+static const char*
+prv_dispatch(const char* topic) {
+    lwgsm_mqtt_evt_t evt;
+
+    memset(&evt, 0x00, sizeof(evt));
+    evt.type = LWGSM_MQTT_EVT_PUBLISH_RECV;
+    evt.evt.publish_recv.topic = (const void*)topic;
+    evt.evt.publish_recv.topic_len = strlen(topic);
+    called[0] = '\0';
+    lwgsmi_mqtt_router_dispatch(&router, NULL, &evt);
+    return called;
+}
+
+/**
+ * \brief           Check that topic calls exactly expected handlers
+ * \param[in]       topic: Received topic
+ * \param[in]       exp: Expected filters of called handlers
+ */
+#define CHECK_DISPATCH(topic, exp)                                                                                     \
+    do {                                                                                                               \
+        const char* res = prv_dispatch(topic);                                                                         \
+        if (strcmp(res, (exp)) != 0) {                                                                                 \
+            printf("topic \"%s\": called \"%s\", expected \"%s\"\r\n", (topic), res, (exp));                           \
+        }                                                                                                              \
+        TEST_CHECK(strcmp(res, (exp)) == 0);                                                                           \
+    } while (0)
+
+static void
+test_literal(void) {
+    TEST_CHECK(prv_add("a/b") == lwgsmOK);
+    TEST_CHECK(prv_add("a") == lwgsmOK);
+    CHECK_DISPATCH("a/b", "a/b,");
+    CHECK_DISPATCH("a", "a,");
+    CHECK_DISPATCH("a/b/c", "");
+    CHECK_DISPATCH("b", "");
+    CHECK_DISPATCH("A/b", "");
+    lwgsmi_mqtt_router_free(&router);
+    TEST_CHECK(router.root == NULL);
+}
+
+static void
+test_plus(void) {
+    TEST_CHECK(prv_add("a/+") == lwgsmOK);
+    TEST_CHECK(prv_add("+/b") == lwgsmOK);
+    TEST_CHECK(prv_add("+") == lwgsmOK);
+    TEST_CHECK(prv_add("a/+/c") == lwgsmOK);
+    CHECK_DISPATCH("a/b", "a/+,+/b,");
+    CHECK_DISPATCH("x/b", "+/b,");
+    CHECK_DISPATCH("a", "+,");
+    CHECK_DISPATCH("a/x/c", "a/+/c,");
+    CHECK_DISPATCH("a/b/c/d", "");
+    lwgsmi_mqtt_router_free(&router);
+}
+
+static void
+test_hash(void) {
+    TEST_CHECK(prv_add("a/#") == lwgsmOK);
+    TEST_CHECK(prv_add("#") == lwgsmOK);
+    TEST_CHECK(prv_add("a/+/#") == lwgsmOK);
+
+    /* `#` also matches parent level */
+    CHECK_DISPATCH("a", "#,a/#,");
+    CHECK_DISPATCH("a/b", "#,a/#,a/+/#,");
+    CHECK_DISPATCH("a/b/c/d", "#,a/#,a/+/#,");
+    CHECK_DISPATCH("b", "#,");
+    lwgsmi_mqtt_router_free(&router);
+}
+
+static void
+test_dollar(void) {
+    TEST_CHECK(prv_add("#") == lwgsmOK);
+    TEST_CHECK(prv_add("+/x") == lwgsmOK);
+    TEST_CHECK(prv_add("$SYS/#") == lwgsmOK);
+    TEST_CHECK(prv_add("$SYS/+") == lwgsmOK);
+
+    /* Wildcards on first level do not match topics starting with `$` */
+    CHECK_DISPATCH("$SYS/x", "$SYS/#,$SYS/+,");
+    CHECK_DISPATCH("$SYS", "$SYS/#,");
+    CHECK_DISPATCH("$other/x", "");
+    CHECK_DISPATCH("SYS/x", "#,+/x,");
+    lwgsmi_mqtt_router_free(&router);
+}
+
+static void
+test_empty_levels(void) {
+    TEST_CHECK(prv_add("a//c") == lwgsmOK);
+    TEST_CHECK(prv_add("a/+/c") == lwgsmOK);
+    TEST_CHECK(prv_add("/") == lwgsmOK);
+    TEST_CHECK(prv_add("+/+") == lwgsmOK);
+    TEST_CHECK(prv_add("a/+") == lwgsmOK);
+
+    /* Empty level is valid level and is matched by `+` */
+    CHECK_DISPATCH("a//c", "a//c,a/+/c,");
+    CHECK_DISPATCH("/", "/,+/+,");
+    CHECK_DISPATCH("a/", "a/+,+/+,");
+    CHECK_DISPATCH("/a", "+/+,");
+    CHECK_DISPATCH("a/c", "a/+,+/+,");
+    lwgsmi_mqtt_router_free(&router);
+}
+
+static void
+test_invalid_filter(void) {
+    TEST_CHECK(prv_add("") != lwgsmOK);
+    TEST_CHECK(prv_add("a/b#") != lwgsmOK);
+    TEST_CHECK(prv_add("a/#/b") != lwgsmOK);
+    TEST_CHECK(prv_add("a+/b") != lwgsmOK);
+    TEST_CHECK(router.root == NULL);
+}
+
+static void
+test_remove(void) {
+    TEST_CHECK(prv_add("a/b") == lwgsmOK);
+    TEST_CHECK(prv_add("a/+") == lwgsmOK);
+    TEST_CHECK(prv_add("a/#") == lwgsmOK);
+    TEST_CHECK(lwgsmi_mqtt_router_remove(&router, "a/+", prv_route_fn, (void*)"a/+") == lwgsmOK);
+    CHECK_DISPATCH("a/b", "a/#,a/b,");
+    TEST_CHECK(lwgsmi_mqtt_router_remove(&router, "a/+", prv_route_fn, (void*)"a/+") != lwgsmOK);
+    TEST_CHECK(lwgsmi_mqtt_router_remove(&router, "a/b", prv_route_fn, (void*)"a/b") == lwgsmOK);
+    TEST_CHECK(lwgsmi_mqtt_router_remove(&router, "a/#", prv_route_fn, (void*)"a/#") == lwgsmOK);
+    CHECK_DISPATCH("a/b", "");
+
+    /* Tree is released once last handler is removed */
+    TEST_CHECK(router.root == NULL);
+}
+
+int
+main(void) {
+    lwgsm_mem_region_t region = {mem, sizeof(mem)};
+
+    lwgsm_mem_assignmemory(&region, 1);
+    TEST_RUN(test_literal);
+    TEST_RUN(test_plus);
+    TEST_RUN(test_hash);
+    TEST_RUN(test_dollar);
+    TEST_RUN(test_empty_levels);
+    TEST_RUN(test_invalid_filter);
+    TEST_RUN(test_remove);
+    return TEST_RESULT();
+}
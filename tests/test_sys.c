@@ -0,0 +1,81 @@
+/**
+ * \file            test_sys.c
+ * \brief           System functions for host unit tests, tests run in single thread
+ */
+
+/*
+ * Copyright (c) 2022 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGSM - Lightweight GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.1.1
+ */
+#include "system/lwgsm_sys.h"
+#include "lwgsm/lwgsm_private.h"
+#include "test.h"
+
+int test_failed;
+static uint32_t sys_now;
+
+/**
+ * \brief           Set value returned by \ref lwgsm_sys_now
+ * \param[in]       now: Time in units of milliseconds
+ */
+void
+test_sys_set_now(uint32_t now) {
+    sys_now = now;
+}
+
+lwgsmr_t
+lwgsm_core_lock(void) {
+    return lwgsmOK;
+}
+
+lwgsmr_t
+lwgsm_core_unlock(void) {
+    return lwgsmOK;
+}
+
+uint32_t
+lwgsm_sys_now(void) {
+    return sys_now;
+}
+
+uint8_t
+lwgsm_sys_mutex_create(lwgsm_sys_mutex_t* p) {
+    *p = (void*)p;
+    return 1;
+}
+
+uint8_t
+lwgsm_sys_mutex_lock(lwgsm_sys_mutex_t* p) {
+    (void)p;
+    return 1;
+}
+
+uint8_t
+lwgsm_sys_mutex_unlock(lwgsm_sys_mutex_t* p) {
+    (void)p;
+    return 1;
+}